@@ -5,6 +5,7 @@ UsfLockComponent::UsfLockComponent()
 {
     bIsEditorOnly = true;// Prevents the component from saving and showing in the details panel
     bCopied = false;
+    m_outlineStencil = 0;
     ClearFlags(EObjectFlags::RF_Transactional);// Prevent component from being recorded in transactions
 }
 
@@ -63,6 +64,55 @@ void UsfLockComponent::SetMaterial(UMaterialInterface* materialPtr)
     }
 }
 
+void UsfLockComponent::Outline(int32 stencil)
+{
+    AActor* actorPtr = GetOwner();
+    if (actorPtr == nullptr)
+    {
+        return;
+    }
+    m_outlineStencil = stencil;
+    TArray<UPrimitiveComponent*> primitives;
+    actorPtr->GetComponents(primitives);
+    for (UPrimitiveComponent* primitivePtr : primitives)
+    {
+        if (!m_outlinedComponents.Contains(primitivePtr->GetFName()))
+        {
+            m_outlinedComponents.Add(primitivePtr->GetFName());
+            m_previousRenderCustomDepth.Add(primitivePtr->bRenderCustomDepth);
+            m_previousStencils.Add(primitivePtr->CustomDepthStencilValue);
+        }
+        primitivePtr->SetRenderCustomDepth(true);
+        primitivePtr->SetCustomDepthStencilValue(stencil);
+    }
+}
+
+void UsfLockComponent::RestoreOutlines()
+{
+    AActor* actorPtr = GetOwner();
+    if (actorPtr == nullptr || m_outlinedComponents.Num() == 0)
+    {
+        return;
+    }
+    TArray<UPrimitiveComponent*> primitives;
+    actorPtr->GetComponents(primitives);
+    for (UPrimitiveComponent* primitivePtr : primitives)
+    {
+        int32 index = m_outlinedComponents.Find(primitivePtr->GetFName());
+        if (index == INDEX_NONE || primitivePtr->CustomDepthStencilValue != m_outlineStencil)
+        {
+            continue;
+        }
+        primitivePtr->SetRenderCustomDepth(m_previousRenderCustomDepth[index]);
+        primitivePtr->SetCustomDepthStencilValue(m_previousStencils[index]);
+    }
+}
+
+int32 UsfLockComponent::GetOutlineStencil() const
+{
+    return m_outlineStencil;
+}
+
 void UsfLockComponent::OnComponentDestroyed(bool bDestroyingHierarchy)
 {
     AActor* actorPtr = GetOwner();
@@ -70,6 +120,10 @@ void UsfLockComponent::OnComponentDestroyed(bool bDestroyingHierarchy)
     {
         actorPtr->bLockLocation = false;
     }
+    RestoreOutlines();
+    m_outlinedComponents.Empty();
+    m_previousRenderCustomDepth.Empty();
+    m_previousStencils.Empty();
     if (GetNumChildrenComponents() > 0 && !bDestroyingHierarchy)
     {
         for (int i = GetNumChildrenComponents() - 1; i >= 0; i--)
@@ -8,7 +8,9 @@
 
 /**
  * Lock component for indicating an actor cannot be edited. This is added to each mesh component of the actor, and
- * adds a copy of the mesh as a child with a lock shader. It also deletes itself and unlocks the actor when copied.
+ * adds a copy of the mesh as a child with a lock shader. When locks are drawn as outlines, one lock component is added
+ * to the actor and it marks the actor's primitive components with a custom depth stencil value instead. It also
+ * deletes itself and unlocks the actor when copied.
  */
 UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
 class UsfLockComponent : public USceneComponent
@@ -59,6 +61,37 @@ public:
      */
     void SetMaterial(UMaterialInterface* materialPtr);
 
+    /**
+     * Renders the owner's primitive components to custom depth with a stencil value so they are outlined by the
+     * post-process outline material for that value. The previous custom depth settings are restored when this
+     * component is destroyed.
+     *
+     * @param   int32 stencil value.
+     */
+    void Outline(int32 stencil);
+
+    /**
+     * Restores the custom depth settings of primitive components outlined by this component. Components whose
+     * stencil value was changed since they were outlined are not restored.
+     */
+    void RestoreOutlines();
+
+    /**
+     * @return  int32 stencil value outlined components are rendered with.
+     */
+    int32 GetOutlineStencil() const;
+
 private:
+    // Names of outlined primitive components and their custom depth settings before they were outlined. These are
+    // properties so they are copied with the actor and the copy can restore its components.
+    UPROPERTY()
+    TArray<FName> m_outlinedComponents;
+    UPROPERTY()
+    TArray<bool> m_previousRenderCustomDepth;
+    UPROPERTY()
+    TArray<int32> m_previousStencils;
+    UPROPERTY()
+    int32 m_outlineStencil;
+
     FDelegateHandle m_tickerHandle;
 };
@@ -8,6 +8,7 @@ const sfName sfProp::Folder = "#folder";
 const sfName sfProp::Location = "#location";
 const sfName sfProp::Rotation = "#rotation";
 const sfName sfProp::Scale = "#scale";
+const sfName sfProp::Transform = "#transform";
 const sfName sfProp::Mesh = "#mesh";
 const sfName sfProp::Materials = "#materials";
 const sfName sfProp::Template = "#template";
@@ -15,8 +16,12 @@ const sfName sfProp::Id = "#id";
 const sfName sfProp::Flashlight = "#flashlight";
 const sfName sfProp::Level = "#level";
 const sfName sfProp::IsPersistentLevel = "#isPersistent";
+const sfName sfProp::MergedIds = "#mergedIds";
 
 const sfName sfType::Actor = "Actor";
 const sfName sfType::Avatar = "Avatar";
 const sfName sfType::Level = "Level";
-const sfName sfType::LevelLock = "LevelLock";
\ No newline at end of file
+const sfName sfType::LevelLock = "LevelLock";
+const sfName sfType::AssetDictionary = "AssetDictionary";
+const sfName sfType::Folder = "Folder";
+const sfName sfType::PropertyMerge = "PropertyMerge";
\ No newline at end of file
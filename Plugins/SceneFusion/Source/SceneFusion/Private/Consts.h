@@ -17,6 +17,7 @@ public:
     static const sfName Location;
     static const sfName Rotation;
     static const sfName Scale;
+    static const sfName Transform;
     static const sfName Mesh;
     static const sfName Materials;
     static const sfName Template;
@@ -24,6 +25,7 @@ public:
     static const sfName Flashlight;
     static const sfName Level;
     static const sfName IsPersistentLevel;
+    static const sfName MergedIds;
 };
 
 /**
@@ -36,4 +38,7 @@ public:
     static const sfName Avatar;
     static const sfName Level;
     static const sfName LevelLock;
+    static const sfName AssetDictionary;
+    static const sfName Folder;
+    static const sfName PropertyMerge;
 };
\ No newline at end of file
@@ -5,6 +5,9 @@
 #include "../SceneFusion.h"
 #include "../Consts.h"
 #include "../sfUtils.h"
+#include "../sfConfig.h"
+#include "../sfAssetCache.h"
+#include "../sfPackedTransform.h"
 
 #include <Editor.h>
 #include <EngineUtils.h>
@@ -26,14 +29,26 @@
 
 // In seconds
 #define BSP_REBUILD_DELAY 2.0f;
+// Resort the spawn queue when the camera moves this far, in cm
+#define SPAWN_RESORT_DISTANCE 1000.0f
+// Seconds between full selection scans that catch selection changes without events
+#define SELECTION_SCAN_INTERVAL 1.0f
 #define LOG_CHANNEL "sfObjectManager"
 
-sfActorManager::sfActorManager(TSharedPtr<sfLevelManager> levelManagerPtr) :
-    m_levelManagerPtr { levelManagerPtr }
+sfActorManager::sfActorManager(
+    TSharedPtr<sfLevelManager> levelManagerPtr,
+    TSharedPtr<sfAssetDictionaryManager> assetDictionaryPtr,
+    TSharedPtr<sfFolderManager> folderManagerPtr,
+    TSharedPtr<sfPropertyMergeManager> propertyMergeManagerPtr) :
+    m_levelManagerPtr { levelManagerPtr },
+    m_assetDictionaryPtr { assetDictionaryPtr },
+    m_folderManagerPtr { folderManagerPtr },
+    m_propertyMergeManagerPtr { propertyMergeManagerPtr }
 {
     RegisterPropertyChangeHandlers();
     RegisterUndoTypes();
-    m_lockMaterialPtr = LoadObject<UMaterialInterface>(nullptr, TEXT("/SceneFusion/LockMaterial"));
+    m_propertyMergeManagerPtr->OnMergedValueChange.BindRaw(this, &sfActorManager::OnMergedValueChange);
+    m_assetDictionaryPtr->OnResolve.BindRaw(this, &sfActorManager::OnAssetIdResolved);
 }
 
 sfActorManager::~sfActorManager()
@@ -51,8 +66,15 @@ void sfActorManager::Initialize()
     m_onFolderChangeHandle = GEngine->OnLevelActorFolderChanged().AddRaw(this, &sfActorManager::OnFolderChange);
     m_onMoveStartHandle = GEditor->OnBeginObjectMovement().AddRaw(this, &sfActorManager::OnMoveStart);
     m_onMoveEndHandle = GEditor->OnEndObjectMovement().AddRaw(this, &sfActorManager::OnMoveEnd);
+    m_onSelectObjectHandle = USelection::SelectObjectEvent.AddRaw(this, &sfActorManager::OnSelectObject);
+    m_onSelectionChangedHandle = USelection::SelectionChangedEvent.AddRaw(this, &sfActorManager::OnSelectionChanged);
     m_onPropertyChangeHandle = FCoreUObjectDelegates::OnObjectPropertyChanged.AddRaw(this,
         &sfActorManager::OnUPropertyChange);
+    m_folderIndex.Rebuild(GEditor->GetEditorWorldContext().World());
+    m_lockRenderer.Initialize(sfConfig::Get().LockOutlines ? sfLockRenderer::Outlines :
+        sfLockRenderer::DuplicateMeshes);
+    m_lockBatch.Initialize(sfConfig::Get().SubtreeLocks);
+    m_numLockEvents = 0;
     m_onUserColorChangeEventPtr = m_sessionPtr->RegisterOnUserColorChangeHandler([this](sfUser::SPtr userPtr)
     {
         OnUserColorChange(userPtr);
@@ -70,7 +92,13 @@ void sfActorManager::Initialize()
     }
 
     m_movingActors = false;
+    m_selectionScanNeeded = true;
+    m_selectionChangedEvent = false;
+    m_selectionScanTimer = 0.0f;
+    m_selectionCount = 0;
     m_bspRebuildDelay = -1.0f;
+    m_pruneMergedValues = false;
+    m_spawnQueueSorted = false;
 }
 
 void sfActorManager::CleanUp()
@@ -82,6 +110,8 @@ void sfActorManager::CleanUp()
     GEngine->OnLevelActorFolderChanged().Remove(m_onFolderChangeHandle);
     GEditor->OnBeginObjectMovement().Remove(m_onMoveStartHandle);
     GEditor->OnEndObjectMovement().Remove(m_onMoveEndHandle);
+    USelection::SelectObjectEvent.Remove(m_onSelectObjectHandle);
+    USelection::SelectionChangedEvent.Remove(m_onSelectionChangedHandle);
     FCoreUObjectDelegates::OnObjectPropertyChanged.Remove(m_onPropertyChangeHandle);
     m_onUserColorChangeEventPtr.reset();
     m_onUserLeaveEventPtr.reset();
@@ -92,51 +122,87 @@ void sfActorManager::CleanUp()
         m_undoBufferPtr->OnBeforeRedoUndo().Remove(m_beforeUndoRedoHandle);
     }
 
-    UWorld* world = GEditor->GetEditorWorldContext().World();
-    for (TActorIterator<AActor> iter(world); iter; ++iter)
-    {
-        sfObject::SPtr objPtr = m_actorToObjectMap.FindRef(*iter);
-        if (objPtr != nullptr && objPtr->IsLocked())
-        {
-            Unlock(*iter);
-        }
-    }
+    TArray<AActor*> lockedActors;
+    m_lockIndex.GetAllActors(lockedActors);
+    Unlock(lockedActors);
+    m_lockIndex.Clear();
+    m_lockChanges.clear();
+    m_lockBatch.CleanUp();
 
-    for (auto iter : m_lockMaterials)
-    {
-        iter.Value->ClearFlags(EObjectFlags::RF_Standalone);// Allow unreal to destroy the material instances
-    }
+    m_lockRenderer.CleanUp();
 
     RehashProperties();
 
-    m_actorToObjectMap.Empty();
-    m_objectToActorMap.clear();
-    m_lockMaterials.Empty();
+    m_assetLoader.Clear();
+    m_sendRateController.Reset();
+    m_dragSentTransforms.Empty();
+    for (auto& pair : m_transformHandles)
+    {
+        if (pair.Value.Key.IsValid())
+        {
+            pair.Value.Key->TransformUpdated.Remove(pair.Value.Value);
+        }
+    }
+    m_transformHandles.Empty();
+    m_dirtyTransforms.Empty();
+    m_pendingLockEdits.Empty();
+    m_serverTransformChanges.Empty();
+    m_actorRegistry.Clear();
     m_uploadList.Empty();
+    m_spawnQueue.Empty();
+    m_levelSpawnCounts.Empty();
+    m_levelBlueprintLoads.Empty();
+    m_deferredLevelCleanups.Empty();
     m_propertyChangeMap.Empty();
     m_recreateQueue.Empty();
     m_syncLabelQueue.Empty();
     m_revertFolderQueue.Empty();
     m_syncParentList.Empty();
+    m_syncFolderList.Empty();
     m_foldersToCheck.Empty();
+    m_folderIndex.Clear();
+    sfActorUtil::ClearNameSuffixes();
     m_selectedActors.clear();
+    m_selectionChanges.Empty();
 }
 
 void sfActorManager::Tick(float deltaTime)
 {
+    // Apply assets that finished loading
+    m_assetLoader.Tick();
+
+    // Apply transform changes received from the server
+    ApplyServerTransformChanges();
+
     // Create server objects for actors in the upload list
     if (m_uploadList.Num() > 0)
     {
-        UploadActors(m_uploadList);
-        m_uploadList.Empty();
+        UploadActors();
     }
 
+    // Spawn actors for objects we received when joining
+    SpawnQueuedActors();
+
+    // Add, remove or recolor lock visuals for lock events received this tick
+    ApplyLockChanges();
+
     // Check for selection changes and request locks/unlocks
-    UpdateSelection();
+    m_sendRateController.Tick();
+    m_lockBatch.Tick();
+    UpdateSelection(deltaTime);
 
     // Rehash maps and sets that were changed by other users
     RehashProperties();
 
+    // Send or roll back transform changes made while waiting for locks
+    if (m_pendingLockEdits.Num() > 0)
+    {
+        ResolvePendingLockEdits();
+    }
+
+    // Send transform changes for actors that moved
+    SendDirtyTransforms();
+
     // Send property changes to the server
     SendPropertyChanges();
 
@@ -145,7 +211,7 @@ void sfActorManager::Tick(float deltaTime)
     {
         AActor* actorPtr;
         m_syncLabelQueue.Dequeue(actorPtr);
-        sfObject::SPtr objPtr = m_actorToObjectMap.FindRef(actorPtr);
+        sfObject::SPtr objPtr = m_actorRegistry.FindObject(actorPtr);
         if (objPtr == nullptr)
         {
             continue;
@@ -154,6 +220,17 @@ void sfActorManager::Tick(float deltaTime)
         SyncLabelAndName(actorPtr, objPtr, propertiesPtr);
     }
 
+    // Send folder changes or queue them to be reverted if the actors are locked
+    for (AActor* actorPtr : m_syncFolderList)
+    {
+        sfObject::SPtr objPtr = m_actorRegistry.FindObject(actorPtr);
+        if (objPtr != nullptr)
+        {
+            SyncFolder(actorPtr, objPtr, objPtr->Property()->AsDict());
+        }
+    }
+    m_syncFolderList.Empty();
+
     // Revert folders to server values for actors whose folder changed while locked
     if (!m_revertFolderQueue.IsEmpty())
     {
@@ -166,10 +243,18 @@ void sfActorManager::Tick(float deltaTime)
     // Recreate actors that were deleted while locked.
     RecreateLockedActors();
 
+    // Remove merged values for actor objects that were deleted. This is done after deleting level objects, which
+    // deletes their actor objects after the actor manager is told the level was removed.
+    if (m_pruneMergedValues)
+    {
+        m_pruneMergedValues = false;
+        m_propertyMergeManagerPtr->PruneValues();
+    }
+
     // Send parent changes for attached/detached actors or reset them to server values if they are locked
     for (AActor* actorPtr : m_syncParentList)
     {
-        sfObject::SPtr objPtr = m_actorToObjectMap.FindRef(actorPtr);
+        sfObject::SPtr objPtr = m_actorRegistry.FindObject(actorPtr);
         if (objPtr != nullptr)
         {
             SyncParent(actorPtr, objPtr);
@@ -190,20 +275,50 @@ void sfActorManager::Tick(float deltaTime)
     RebuildBSPIfNeeded(deltaTime);
 }
 
-void sfActorManager::UpdateSelection()
+void sfActorManager::UpdateSelection(float deltaTime)
 {
-    // Unreal doesn't have deselect events and doesn't fire select events when selecting through the World Outliner so
-    // we have to iterate the selection to check for changes
-    for (auto iter = m_selectedActors.cbegin(); iter != m_selectedActors.cend();)
+    // Batch selection changes such as deselecting everything fire a selection changed event without events for the
+    // individual actors, even if they are followed by actor selection events in the same tick, so we scan the whole
+    // selection after a selection changed event or if the number of selected actors changed. Some changes made
+    // through the World Outliner fire no events, so we also scan periodically.
+    USelection* selectionPtr = GEditor->GetSelectedActors();
+    m_selectionScanTimer -= deltaTime;
+    if (m_selectionChangedEvent || selectionPtr->Num() != m_selectionCount || m_selectionScanTimer <= 0.0f)
     {
-        if (m_movingActors)
+        m_selectionScanNeeded = true;
+    }
+    if (m_selectionScanNeeded)
+    {
+        ScanSelection();
+        m_selectionScanNeeded = false;
+        m_selectionScanTimer = SELECTION_SCAN_INTERVAL;
+    }
+    else
+    {
+        for (AActor* actorPtr : m_selectionChanges)
         {
-            SendTransformUpdate(iter->first, iter->second);
+            UpdateSelectionState(actorPtr);
         }
+    }
+    m_selectionChanges.Empty();
+    m_selectionChangedEvent = false;
+    m_selectionCount = selectionPtr->Num();
+
+    // Send the lock requests and releases for all selection changes together
+    for (const sfObject::SPtr& objPtr : m_lockBatch.Send())
+    {
+        m_sendRateController.OnLockRequested(objPtr);
+    }
+}
+
+void sfActorManager::ScanSelection()
+{
+    for (auto iter = m_selectedActors.cbegin(); iter != m_selectedActors.cend();)
+    {
         if (!iter->first->IsSelected())
         {
-            iter->second->ReleaseLock();
-            m_selectedActors.erase(iter++);
+            m_lockBatch.Release(iter->second);
+            iter = m_selectedActors.erase(iter);
         }
         else
         {
@@ -213,25 +328,159 @@ void sfActorManager::UpdateSelection()
     for (auto iter = GEditor->GetSelectedActorIterator(); iter; ++iter)
     {
         AActor* actorPtr = Cast<AActor>(*iter);
-        if (actorPtr == nullptr || m_selectedActors.find(actorPtr) != m_selectedActors.end())
+        if (actorPtr != nullptr)
         {
-            continue;
+            UpdateSelectionState(actorPtr);
         }
-        sfObject::SPtr objPtr = m_actorToObjectMap.FindRef(actorPtr);
+    }
+}
+
+void sfActorManager::UpdateSelectionState(AActor* actorPtr)
+{
+    auto iter = m_selectedActors.find(actorPtr);
+    if (actorPtr->IsSelected())
+    {
+        if (iter != m_selectedActors.end())
+        {
+            return;
+        }
+        sfObject::SPtr objPtr = m_actorRegistry.FindObject(actorPtr);
         if (objPtr != nullptr)
         {
-            objPtr->RequestLock();
+            m_lockBatch.Request(objPtr);
             m_selectedActors[actorPtr] = objPtr;
         }
     }
+    else if (iter != m_selectedActors.end())
+    {
+        m_lockBatch.Release(iter->second);
+        m_selectedActors.erase(iter);
+    }
+}
+
+void sfActorManager::OnSelectObject(UObject* uobjPtr)
+{
+    AActor* actorPtr = Cast<AActor>(uobjPtr);
+    if (actorPtr != nullptr)
+    {
+        m_selectionChanges.Add(actorPtr);
+    }
+}
+
+void sfActorManager::OnSelectionChanged(UObject* selectionPtr)
+{
+    if (selectionPtr == GEditor->GetSelectedActors())
+    {
+        m_selectionChangedEvent = true;
+    }
+}
+
+void sfActorManager::SpawnQueuedActors()
+{
+    if (m_spawnQueue.Num() == 0)
+    {
+        return;
+    }
+    FVector cameraLocation = GCurrentLevelEditingViewportClient == nullptr ?
+        FVector::ZeroVector : GCurrentLevelEditingViewportClient->GetViewLocation();
+    if (!m_spawnQueueSorted ||
+        FVector::DistSquared(cameraLocation, m_spawnSortLocation) > SPAWN_RESORT_DISTANCE * SPAWN_RESORT_DISTANCE)
+    {
+        SortSpawnQueue(cameraLocation);
+    }
+
+    double endTime = FPlatformTime::Seconds() + sfConfig::Get().SpawnTimeBudget / 1000.0;
+    bool spawned = false;
+    // Always spawn at least one actor so we make progress even if the budget is too small. Actors whose assets are
+    // still loading are skipped so we don't spawn them with missing assets, and nearer actors whose assets have
+    // loaded are spawned instead.
+    for (int i = m_spawnQueue.Num() - 1; i >= 0 && i < m_spawnQueue.Num(); i--)
+    {
+        if (spawned && FPlatformTime::Seconds() >= endTime)
+        {
+            break;
+        }
+        if (!AreAssetsLoaded(m_spawnQueue[i]))
+        {
+            // Don't use more than the budget looking for actors whose assets have loaded
+            if (FPlatformTime::Seconds() >= endTime)
+            {
+                break;
+            }
+            continue;
+        }
+        SpawnRequest request = m_spawnQueue[i];
+        m_spawnQueue.RemoveAt(i, 1, false);
+        spawned = true;
+        // The object may have been deleted, or spawned with its parent if it was attached to another actor.
+        if (request.ObjPtr->IsSyncing() && !m_actorRegistry.Contains(request.ObjPtr))
+        {
+            OnCreate(request.ObjPtr, 0); // Child index does not matter
+        }
+        m_assetLoader.ReleasePrefetch(request.PrefetchId);
+
+        int* countPtr = m_levelSpawnCounts.Find(request.LevelPtr);
+        if (countPtr != nullptr && --(*countPtr) <= 0)
+        {
+            m_levelSpawnCounts.Remove(request.LevelPtr);
+            DestroyUnsyncedActorsInLevel(request.LevelPtr);
+        }
+    }
+}
+
+bool sfActorManager::AreAssetsLoaded(SpawnRequest& request)
+{
+    if (!m_assetLoader.IsPrefetching())
+    {
+        request.AssetPaths.Empty();
+        return true;
+    }
+    while (request.AssetPaths.Num() > 0)
+    {
+        if (m_assetLoader.IsLoading(request.AssetPaths.Last()))
+        {
+            return false;
+        }
+        request.AssetPaths.Pop(false);
+    }
+    return true;
+}
+
+void sfActorManager::SortSpawnQueue(const FVector& location)
+{
+    FVector objLocation;
+    FRotator objRotation;
+    FVector objScale;
+    for (SpawnRequest& request : m_spawnQueue)
+    {
+        if (GetServerTransform(request.ObjPtr->Property()->AsDict(), objLocation, objRotation, objScale))
+        {
+            request.DistanceSquared = FVector::DistSquared(location, objLocation);
+        }
+        else
+        {
+            request.DistanceSquared = 0.0f;
+        }
+    }
+    m_spawnQueue.Sort([](const SpawnRequest& a, const SpawnRequest& b)
+    {
+        return a.DistanceSquared > b.DistanceSquared;
+    });
+    m_spawnSortLocation = location;
+    m_spawnQueueSorted = true;
 }
 
 void sfActorManager::DestroyUnsyncedActorsInLevel(ULevel* levelPtr)
 {
+    if (m_levelBlueprintLoads.Contains(levelPtr))
+    {
+        m_deferredLevelCleanups.Add(levelPtr);
+        return;
+    }
     UWorld* worldPtr = levelPtr->GetWorld();
     for (AActor* actorPtr : levelPtr->Actors)
     {
-        if (IsSyncable(actorPtr) && !m_actorToObjectMap.Contains(actorPtr))
+        if (IsSyncable(actorPtr) && !m_actorRegistry.Contains(actorPtr))
         {
             if (actorPtr->IsA<ABrush>())
             {
@@ -249,14 +498,13 @@ void sfActorManager::RevertLockedFolders()
     {
         AActor* actorPtr;
         m_revertFolderQueue.Dequeue(actorPtr);
-        sfObject::SPtr objPtr = m_actorToObjectMap.FindRef(actorPtr);
+        sfObject::SPtr objPtr = m_actorRegistry.FindObject(actorPtr);
         if (objPtr != nullptr)
         {
             sfDictionaryProperty::SPtr propertiesPtr = objPtr->Property()->AsDict();
-            GEngine->OnLevelActorFolderChanged().Remove(m_onFolderChangeHandle);
-            actorPtr->SetFolderPath(FName(*sfPropertyUtil::ToString(propertiesPtr->Get(sfProp::Folder))));
-            m_onFolderChangeHandle = GEngine->OnLevelActorFolderChanged().AddRaw(
-                this, &sfActorManager::OnFolderChange);
+            sfEventGuard::Scope guard(m_folderChangeGuard);
+            actorPtr->SetFolderPath(m_folderManagerPtr->ToPath(
+                m_propertyMergeManagerPtr->GetValue(objPtr, sfProp::Folder)));
         }
     }
 }
@@ -267,7 +515,7 @@ void sfActorManager::RecreateLockedActors()
     {
         sfObject::SPtr objPtr;
         m_recreateQueue.Dequeue(objPtr);
-        if (m_objectToActorMap.find(objPtr) == m_objectToActorMap.end())
+        if (!m_actorRegistry.Contains(objPtr))
         {
             OnCreate(objPtr, 0);
         }
@@ -276,26 +524,17 @@ void sfActorManager::RecreateLockedActors()
 
 void sfActorManager::DeleteEmptyFolders()
 {
-    // The only way to tell if a folder is empty is to iterate all the actors
     if (m_foldersToCheck.Num() > 0 && FActorFolders::IsAvailable())
     {
         UWorld* world = GEditor->GetEditorWorldContext().World();
-        for (TActorIterator<AActor> iter(world); iter && m_foldersToCheck.Num() > 0; ++iter)
+        for (const FString& folder : m_foldersToCheck)
         {
-            FString folder = iter->GetFolderPath().ToString();
-            for (int i = m_foldersToCheck.Num() - 1; i >= 0; i--)
+            FName folderName(*folder);
+            if (m_folderIndex.IsEmpty(folderName))
             {
-                if (folder == m_foldersToCheck[i] || FActorFolders::Get().PathIsChildOf(folder, m_foldersToCheck[i]))
-                {
-                    m_foldersToCheck.RemoveAt(i);
-                    break;
-                }
+                FActorFolders::Get().DeleteFolder(*world, folderName);
             }
         }
-        for (int i = 0; i < m_foldersToCheck.Num(); i++)
-        {
-            FActorFolders::Get().DeleteFolder(*world, FName(*m_foldersToCheck[i]));
-        }
         m_foldersToCheck.Empty();
     }
 }
@@ -329,79 +568,114 @@ void sfActorManager::OnActorAdded(AActor* actorPtr)
     {
         return;
     }
+    // The folder index counts actors we spawn too, so it is updated before checking the guard
+    m_folderIndex.Update(actorPtr);
+    if (m_actorAddedGuard.IsActive())
+    {
+        return;
+    }
 
     // We add this to a list for processing later because the actor's properties may not be initialized yet.
     m_uploadList.Add(actorPtr);
 }
 
-void sfActorManager::UploadActors(const TArray<AActor*>& actors)
+void sfActorManager::UploadActors()
 {
-    std::list<sfObject::SPtr> objects;
-    sfObject::SPtr parentPtr = nullptr;
-    sfObject::SPtr currentParentPtr = nullptr;
-    for (AActor* actorPtr : actors)
+    sfConfig& config = sfConfig::Get();
+    double endTime = FPlatformTime::Seconds() + config.UploadTimeBudget / 1000.0;
+    int bytes = 0;
+    int numProcessed = 0;
+    // All objects in one request must have the same parent, so we group objects by parent and send one request per
+    // parent, or more if a group exceeds the batch size. Groups are sent in the order their parents were first seen.
+    std::vector<sfObject::SPtr> parents;
+    std::unordered_map<sfObject::SPtr, UploadBatch> batches;
+    std::list<sfObject::SPtr> createdObjects;
+    while (numProcessed < m_uploadList.Num())
     {
+        // Always process at least one actor so we make progress even if the budget is too small.
+        if (numProcessed > 0 && (bytes >= config.UploadByteBudget || FPlatformTime::Seconds() >= endTime))
+        {
+            break;
+        }
+        AActor* actorPtr = m_uploadList[numProcessed];
+        numProcessed++;
         if (!IsSyncable(actorPtr))
         {
             continue;
         }
 
+        sfObject::SPtr parentPtr = nullptr;
         AActor* parentActorPtr = actorPtr->GetAttachParentActor();
         if (parentActorPtr == nullptr)
         {
-            currentParentPtr = m_levelManagerPtr->GetOrCreateLevelObject(actorPtr->GetLevel());
+            parentPtr = m_levelManagerPtr->GetOrCreateLevelObject(actorPtr->GetLevel());
         }
         else
         {
-            currentParentPtr = m_actorToObjectMap.FindRef(parentActorPtr);
+            parentPtr = m_actorRegistry.FindObject(parentActorPtr);
         }
 
-        if (currentParentPtr == nullptr)
+        if (parentPtr == nullptr)
         {
             continue;
         }
-        else if (currentParentPtr->IsFullyLocked())
+        else if (parentPtr->IsFullyLocked())
         {
             KS::Log::Warning("Failed to attach " + std::string(TCHAR_TO_UTF8(*actorPtr->GetName())) +
                 " to " + std::string(TCHAR_TO_UTF8(*parentActorPtr->GetName())) +
                 " because it is fully locked by another user.",
                 LOG_CHANNEL);
-            GEngine->OnLevelActorDetached().Remove(m_onActorDetachedHandle);
+            sfEventGuard::Scope guard(m_attachDetachGuard);
             actorPtr->DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
-            m_onActorDetachedHandle = GEngine->OnLevelActorDetached().AddRaw(this, &sfActorManager::OnAttachDetach);
-            currentParentPtr = m_levelManagerPtr->GetOrCreateLevelObject(actorPtr->GetLevel());
+            parentPtr = m_levelManagerPtr->GetOrCreateLevelObject(actorPtr->GetLevel());
         }
 
-        if (parentPtr == nullptr)
+        sfObject::SPtr objPtr = CreateObject(actorPtr);
+        if (objPtr == nullptr)
         {
-            parentPtr = currentParentPtr;
+            continue;
         }
-
-        // All objects in one request must have the same parent, so if we encounter a different parent, send a request
-        // for all objects we already processed and clear the objects list to start a new request.
-        if (currentParentPtr != parentPtr)
+        auto batchIter = batches.find(parentPtr);
+        if (batchIter == batches.end())
         {
-            if (objects.size() > 0)
-            {
-                m_sessionPtr->Create(objects, parentPtr, 0);
-                // Pre-existing child objects can only be attached after calling Create.
-                FindAndAttachChildren(objects);
-                objects.clear();
-            }
-            parentPtr = currentParentPtr;
+            parents.push_back(parentPtr);
+            batchIter = batches.emplace(parentPtr, UploadBatch()).first;
         }
-        sfObject::SPtr objPtr = CreateObject(actorPtr);
-        if (objPtr != nullptr)
+        UploadBatch& batch = batchIter->second;
+        batch.Objects.push_back(objPtr);
+        auto iter = objPtr->SelfAndDescendants();
+        while (iter.Value() != nullptr)
+        {
+            batch.Size++;
+            bytes += sfPropertyUtil::EstimateSize(iter.Value()->Property());
+            iter.Next();
+        }
+        if (batch.Size >= config.UploadBatchSize)
         {
-            objects.push_back(objPtr);
+            SendCreateBatch(batch, parentPtr, createdObjects);
         }
     }
-    if (objects.size() > 0)
+    for (sfObject::SPtr parentPtr : parents)
     {
-        m_sessionPtr->Create(objects, parentPtr, 0);
-        // Pre-existing child objects can only be attached after calling Create.
-        FindAndAttachChildren(objects);
+        SendCreateBatch(batches[parentPtr], parentPtr, createdObjects);
     }
+    // Pre-existing child objects can only be attached after calling Create.
+    FindAndAttachChildren(createdObjects);
+    m_uploadList.RemoveAt(0, numProcessed, false);
+}
+
+void sfActorManager::SendCreateBatch(
+    UploadBatch& batch,
+    sfObject::SPtr parentPtr,
+    std::list<sfObject::SPtr>& createdObjects)
+{
+    if (batch.Objects.size() == 0)
+    {
+        return;
+    }
+    m_sessionPtr->Create(batch.Objects, parentPtr, 0);
+    createdObjects.splice(createdObjects.end(), batch.Objects);
+    batch.Size = 0;
 }
 
 void sfActorManager::FindAndAttachChildren(const std::list<sfObject::SPtr>& objects)
@@ -413,14 +687,14 @@ void sfActorManager::FindAndAttachChildren(const std::list<sfObject::SPtr>& obje
         {
             sfObject::SPtr currentPtr = iter.Value();
             iter.Next();
-            auto actorIter = m_objectToActorMap.find(currentPtr);
-            if (actorIter != m_objectToActorMap.end())
+            AActor* actorPtr = m_actorRegistry.FindActor(currentPtr);
+            if (actorPtr != nullptr)
             {
                 TArray<AActor*> children;
-                actorIter->second->GetAttachedActors(children);
+                actorPtr->GetAttachedActors(children);
                 for (AActor* childPtr : children)
                 {
-                    sfObject::SPtr childObjPtr = m_actorToObjectMap.FindRef(childPtr);
+                    sfObject::SPtr childObjPtr = m_actorRegistry.FindObject(childPtr);
                     if (childObjPtr != nullptr && childObjPtr->Parent() != currentPtr)
                     {
                         currentPtr->AddChild(childObjPtr);
@@ -434,7 +708,7 @@ void sfActorManager::FindAndAttachChildren(const std::list<sfObject::SPtr>& obje
 
 sfObject::SPtr sfActorManager::CreateObject(AActor* actorPtr)
 {
-    sfObject::SPtr objPtr = m_actorToObjectMap.FindRef(actorPtr);
+    sfObject::SPtr objPtr = m_actorRegistry.FindObject(actorPtr);
     if (objPtr != nullptr)
     {
         return nullptr;
@@ -442,9 +716,11 @@ sfObject::SPtr sfActorManager::CreateObject(AActor* actorPtr)
     sfDictionaryProperty::SPtr propertiesPtr = sfDictionaryProperty::Create();
     objPtr = sfObject::Create(sfType::Actor, propertiesPtr);
 
+    // The lock is requested through the lock batch with the other selection locks when the selection is updated,
+    // after the object is created.
     if (actorPtr->IsSelected())
     {
-        objPtr->RequestLock();
+        m_lockBatch.Request(objPtr);
         m_selectedActors[actorPtr] = objPtr;
     }
 
@@ -452,24 +728,15 @@ sfObject::SPtr sfActorManager::CreateObject(AActor* actorPtr)
     if (actorPtr->GetClass()->IsInBlueprint())
     {
         // Set path to blueprint
-        propertiesPtr->Set(sfProp::Class,
-            sfPropertyUtil::FromString(actorPtr->GetClass()->GetOuter()->GetName(), m_sessionPtr));
+        propertiesPtr->Set(sfProp::Class, m_assetDictionaryPtr->FromPath(actorPtr->GetClass()->GetOuter()->GetName()));
     }
     else
     {
-        propertiesPtr->Set(sfProp::Class,
-            sfPropertyUtil::FromString(actorPtr->GetClass()->GetName(), m_sessionPtr));
+        propertiesPtr->Set(sfProp::Class, m_assetDictionaryPtr->FromPath(actorPtr->GetClass()->GetName()));
     }
     propertiesPtr->Set(sfProp::Label, sfPropertyUtil::FromString(actorPtr->GetActorLabel(), m_sessionPtr));
-    propertiesPtr->Set(sfProp::Folder,
-    sfPropertyUtil::FromString(actorPtr->GetFolderPath().ToString(), m_sessionPtr));
-    USceneComponent* rootComponentPtr = actorPtr->GetRootComponent();
-    if (rootComponentPtr != nullptr)
-    {
-        propertiesPtr->Set(sfProp::Location, sfPropertyUtil::FromVector(rootComponentPtr->RelativeLocation));
-        propertiesPtr->Set(sfProp::Rotation, sfPropertyUtil::FromRotator(rootComponentPtr->RelativeRotation));
-        propertiesPtr->Set(sfProp::Scale, sfPropertyUtil::FromVector(actorPtr->GetActorRelativeScale3D()));
-    }
+    propertiesPtr->Set(sfProp::Folder, m_folderManagerPtr->FromPath(actorPtr->GetFolderPath()));
+    CreateTransformProperties(actorPtr, propertiesPtr);
 
     CreateStaticMeshProperties(actorPtr, propertiesPtr) ||
     CreateSkeletalMeshProperties(actorPtr, propertiesPtr) ||
@@ -490,8 +757,8 @@ sfObject::SPtr sfActorManager::CreateObject(AActor* actorPtr)
         }
     }
 
-    m_actorToObjectMap.Add(actorPtr, objPtr);
-    m_objectToActorMap[objPtr] = actorPtr;
+    m_actorRegistry.Add(actorPtr, objPtr);
+    WatchTransform(actorPtr);
 
     InvokeOnLockStateChange(objPtr, actorPtr);
 
@@ -530,12 +797,11 @@ void sfActorManager::OnCreate(sfObject::SPtr objPtr, int childIndex)
         return;
     }
 
-    auto iter = m_objectToActorMap.find(objPtr->Parent());
-    if (iter != m_objectToActorMap.end())
+    AActor* parentActorPtr = m_actorRegistry.FindActor(objPtr->Parent());
+    if (parentActorPtr != nullptr)
     {
-        GEngine->OnLevelActorAdded().Remove(m_onActorAttachedHandle);
-        actorPtr->AttachToActor(iter->second, FAttachmentTransformRules::KeepRelativeTransform);
-        m_onActorAttachedHandle = GEngine->OnLevelActorAttached().AddRaw(this, &sfActorManager::OnAttachDetach);
+        sfEventGuard::Scope guard(m_attachDetachGuard);
+        actorPtr->AttachToActor(parentActorPtr, FAttachmentTransformRules::KeepRelativeTransform);
     }
 }
 
@@ -552,7 +818,7 @@ AActor* sfActorManager::InitializeActor(sfObject::SPtr objPtr, ULevel* levelPtr)
             sfActorUtil::Rename(actorPtr, name + " (deleted)");
             actorPtr = nullptr;
         }
-        else if (m_actorToObjectMap.Contains(actorPtr))
+        else if (m_actorRegistry.Contains(actorPtr))
         {
             actorPtr = nullptr;
         }
@@ -561,35 +827,50 @@ AActor* sfActorManager::InitializeActor(sfObject::SPtr objPtr, ULevel* levelPtr)
     FVector location{ 0, 0, 0 };
     FRotator rotation{ 0, 0, 0 };
     FVector scale{ 1, 1, 1 };
-    sfProperty::SPtr propPtr;
-    if (propertiesPtr->TryGet(sfProp::Location, propPtr))
-    {
-        location = sfPropertyUtil::ToVector(propPtr);
-        rotation = sfPropertyUtil::ToRotator(propertiesPtr->Get(sfProp::Rotation));
-        scale = sfPropertyUtil::ToVector(propertiesPtr->Get(sfProp::Scale));
-    }
+    GetServerTransform(propertiesPtr, location, rotation, scale);
 
     if (actorPtr == nullptr)
     {
-        FString className = sfPropertyUtil::ToString(propertiesPtr->Get(sfProp::Class));
+        FString className = m_assetDictionaryPtr->ToPath(propertiesPtr->Get(sfProp::Class));
         UClass* classPtr = nullptr;
         if (className.Contains("/"))
         {
             // If it contains a '/' it's a blueprint path
-            // Disable loading dialog that causes a crash if we are dragging objects
-            GIsSlowTask = true;
-            UBlueprint* blueprintPtr = LoadObject<UBlueprint>(nullptr, *className);
-            GIsSlowTask = false;
+            UBlueprint* blueprintPtr = sfAssetCache::Find<UBlueprint>(className);
             if (blueprintPtr == nullptr)
             {
-                KS::Log::Warning("Unable to load blueprint " + std::string(TCHAR_TO_UTF8(*className)), LOG_CHANNEL);
+                // Load the blueprint asynchronously and create the actor once it loads. The actor will be attached
+                // to its parent and its children will be attached to it when it is created.
+                m_levelBlueprintLoads.FindOrAdd(levelPtr)++;
+                m_assetLoader.Load(nullptr, 0, className, [this, objPtr, className, levelPtr](UObject* assetPtr)
+                {
+                    if (assetPtr == nullptr)
+                    {
+                        KS::Log::Warning("Unable to load blueprint " + std::string(TCHAR_TO_UTF8(*className)),
+                            LOG_CHANNEL);
+                    }
+                    else if (objPtr->IsSyncing() && !m_actorRegistry.Contains(objPtr))
+                    {
+                        OnCreate(objPtr, 0);
+                    }
+                    // Destroy unsynced actors in the level if it was waiting for its blueprints to load
+                    int* countPtr = m_levelBlueprintLoads.Find(levelPtr);
+                    if (countPtr != nullptr && --(*countPtr) <= 0)
+                    {
+                        m_levelBlueprintLoads.Remove(levelPtr);
+                        if (m_deferredLevelCleanups.Remove(levelPtr) > 0)
+                        {
+                            DestroyUnsyncedActorsInLevel(levelPtr);
+                        }
+                    }
+                });
                 return nullptr;
             }
             classPtr = blueprintPtr->GeneratedClass;
         }
         else
         {
-            classPtr = FindObject<UClass>(ANY_PACKAGE, *className);
+            classPtr = sfAssetCache::FindClass(className);
         }
         if (classPtr == nullptr)
         {
@@ -597,22 +878,22 @@ AActor* sfActorManager::InitializeActor(sfObject::SPtr objPtr, ULevel* levelPtr)
             return nullptr;
         }
 
-        GEngine->OnLevelActorAdded().Remove(m_onActorAddedHandle);
+        sfEventGuard::Scope guard(m_actorAddedGuard);
         UWorld* worldPtr = GEditor->GetEditorWorldContext().World();
         FActorSpawnParameters spawnParameters;
         spawnParameters.OverrideLevel = levelPtr;
         actorPtr = worldPtr->SpawnActor<AActor>(classPtr, location, rotation, spawnParameters);
-        m_onActorAddedHandle = GEngine->OnLevelActorAdded().AddRaw(this, &sfActorManager::OnActorAdded);
     }
     else
     {
         // Detach from parent to avoid possible loops when we try to attach its children
-        GEngine->OnLevelActorDetached().Remove(m_onActorDetachedHandle);
-        actorPtr->DetachFromActor(FDetachmentTransformRules::KeepRelativeTransform);
-        m_onActorDetachedHandle = GEngine->OnLevelActorDetached().AddRaw(this, &sfActorManager::OnAttachDetach);
+        {
+            sfEventGuard::Scope guard(m_attachDetachGuard);
+            actorPtr->DetachFromActor(FDetachmentTransformRules::KeepRelativeTransform);
+        }
         if (actorPtr->IsSelected())
         {
-            objPtr->RequestLock();
+            m_lockBatch.Request(objPtr);
             m_selectedActors[actorPtr] = objPtr;
         }
         if (actorPtr->IsA<ABrush>())
@@ -625,17 +906,16 @@ AActor* sfActorManager::InitializeActor(sfObject::SPtr objPtr, ULevel* levelPtr)
     actorPtr->SetActorRelativeLocation(location);
     actorPtr->SetActorRelativeRotation(rotation);
     actorPtr->SetActorRelativeScale3D(scale);
-    actorPtr->SetFolderPath(FName(*sfPropertyUtil::ToString(propertiesPtr->Get(sfProp::Folder))));
+    actorPtr->SetFolderPath(
+        m_folderManagerPtr->ToPath(m_propertyMergeManagerPtr->GetValue(objPtr, sfProp::Folder)));
 
-    FString label = sfPropertyUtil::ToString(propertiesPtr->Get(sfProp::Label));
+    FString label = sfPropertyUtil::ToString(m_propertyMergeManagerPtr->GetValue(objPtr, sfProp::Label));
     // Calling SetActorLabel will change the actor's name (id), even if the label doesn't change. So we check first if
     // the label is different
     if (label != actorPtr->GetActorLabel())
     {
-        FCoreUObjectDelegates::OnObjectPropertyChanged.Remove(m_onPropertyChangeHandle);
-        actorPtr->SetActorLabel(sfPropertyUtil::ToString(propertiesPtr->Get(sfProp::Label)));
-        m_onPropertyChangeHandle =
-            FCoreUObjectDelegates::OnObjectPropertyChanged.AddRaw(this, &sfActorManager::OnUPropertyChange);
+        sfEventGuard::Scope guard(m_propertyChangeGuard);
+        actorPtr->SetActorLabel(label);
     }
     // Set name after setting label because setting label changes the name
     sfActorUtil::TryRename(actorPtr, name);
@@ -648,8 +928,8 @@ AActor* sfActorManager::InitializeActor(sfObject::SPtr objPtr, ULevel* levelPtr)
     sfPropertyUtil::ApplyProperties(actorPtr, propertiesPtr);
 #endif
 
-    m_actorToObjectMap.Add(actorPtr, objPtr);
-    m_objectToActorMap[objPtr] = actorPtr;
+    m_actorRegistry.Add(actorPtr, objPtr);
+    WatchTransform(actorPtr);
     SceneFusion::RedrawActiveViewport();
 
     if (objPtr->IsLocked())
@@ -661,17 +941,10 @@ AActor* sfActorManager::InitializeActor(sfObject::SPtr objPtr, ULevel* levelPtr)
     // Initialize children
     for (sfObject::SPtr childPtr : objPtr->Children())
     {
-        AActor* childActorPtr;
-        auto iter = m_objectToActorMap.find(childPtr);
-        if (iter != m_objectToActorMap.end())
+        AActor* childActorPtr = m_actorRegistry.FindActor(childPtr);
+        if (childActorPtr != nullptr)
         {
-            childActorPtr = iter->second;
-            propertiesPtr = childPtr->Property()->AsDict();
-            childActorPtr->SetActorRelativeLocation(
-                sfPropertyUtil::ToVector(propertiesPtr->Get(sfProp::Location)));
-            childActorPtr->SetActorRelativeRotation(
-                sfPropertyUtil::ToRotator(propertiesPtr->Get(sfProp::Rotation)));
-            childActorPtr->SetActorRelativeScale3D(sfPropertyUtil::ToVector(propertiesPtr->Get(sfProp::Scale)));
+            ApplyServerTransform(childActorPtr, childPtr);
         }
         else
         {
@@ -679,9 +952,8 @@ AActor* sfActorManager::InitializeActor(sfObject::SPtr objPtr, ULevel* levelPtr)
         }
         if (childActorPtr != nullptr)
         {
-            GEngine->OnLevelActorAdded().Remove(m_onActorAttachedHandle);
+            sfEventGuard::Scope guard(m_attachDetachGuard);
             childActorPtr->AttachToActor(actorPtr, FAttachmentTransformRules::KeepRelativeTransform);
-            m_onActorAttachedHandle = GEngine->OnLevelActorAttached().AddRaw(this, &sfActorManager::OnAttachDetach);
         }
     }
 
@@ -699,16 +971,8 @@ bool sfActorManager::CreateStaticMeshProperties(AActor* actorPtr, sfDictionaryPr
     if (componentPtr != nullptr)
     {
         FString path = componentPtr->GetStaticMesh() == nullptr ? "" : componentPtr->GetStaticMesh()->GetPathName();
-        propertiesPtr->Set(sfProp::Mesh, sfPropertyUtil::FromString(path, m_sessionPtr));
-
-        sfListProperty::SPtr materialsPropPtr = sfListProperty::Create();
-        TArray<UMaterialInterface*> materials = componentPtr->GetMaterials();
-        for (UMaterialInterface* materialPtr : materials)
-        {
-            path = materialPtr == nullptr ? "" : materialPtr->GetPathName();
-            materialsPropPtr->Add(sfPropertyUtil::FromString(path, m_sessionPtr));
-        }
-        propertiesPtr->Set(sfProp::Materials, materialsPropPtr);
+        propertiesPtr->Set(sfProp::Mesh, m_assetDictionaryPtr->FromPath(path));
+        propertiesPtr->Set(sfProp::Materials, CreateMaterialsProperty(componentPtr));
     }
     return true;
 }
@@ -724,41 +988,16 @@ bool sfActorManager::ApplyStaticMeshProperties(AActor* actorPtr, sfDictionaryPro
     UStaticMeshComponent* componentPtr = staticMeshActorPtr->GetStaticMeshComponent();
     if (componentPtr != nullptr && propertiesPtr->TryGet(sfProp::Mesh, propPtr))
     {
-        FString path = sfPropertyUtil::ToString(propPtr);
-        if (path.IsEmpty())
-        {
-            componentPtr->SetStaticMesh(nullptr);
-        }
-        else
-        {
-            // Disable loading dialog that causes a crash if we are dragging objects
-            GIsSlowTask = true;
-            componentPtr->SetStaticMesh(LoadObject<UStaticMesh>(nullptr, *path));
-            GIsSlowTask = false;
-        }
+        FString path = m_assetDictionaryPtr->ToPath(propPtr);
         sfListProperty::SPtr materialsPtr = propertiesPtr->Get(sfProp::Materials)->AsList();
-        int numMaterials = FMath::Min(componentPtr->GetNumMaterials(), materialsPtr->Size());
-        if (componentPtr->GetNumMaterials() != materialsPtr->Size())
+        // The actor keeps its current mesh until the new one loads. Materials are applied after the mesh because the
+        // number of material slots depends on the mesh.
+        m_assetLoader.Load(componentPtr, -1, path, [this, componentPtr, materialsPtr, path](UObject* assetPtr)
         {
-            KS::Log::Warning("Material count mismatch on static mesh '" + std::string(TCHAR_TO_UTF8(*path)) +
-                "'. Server has " + std::to_string(materialsPtr->Size()) + " but we have " +
-                std::to_string(componentPtr->GetNumMaterials()), LOG_CHANNEL);
-        }
-        for (int i = 0; i < numMaterials; i++)
-        {
-            path = sfPropertyUtil::ToString(materialsPtr->Get(i));
-            if (path.IsEmpty())
-            {
-                componentPtr->SetMaterial(i, nullptr);
-            }
-            else
-            {
-                // Disable loading dialog that causes a crash if we are dragging objects
-                GIsSlowTask = true;
-                componentPtr->SetMaterial(i, LoadObject<UMaterialInterface>(nullptr, *path));
-                GIsSlowTask = false;
-            }
-        }
+            componentPtr->SetStaticMesh(Cast<UStaticMesh>(assetPtr));
+            ApplyMaterials(componentPtr, materialsPtr, path);
+            SceneFusion::RedrawActiveViewport();
+        });
     }
     return true;
 }
@@ -774,16 +1013,8 @@ bool sfActorManager::CreateSkeletalMeshProperties(AActor* actorPtr, sfDictionary
     if (componentPtr != nullptr)
     {
         FString path = componentPtr->SkeletalMesh == nullptr ? "" : componentPtr->SkeletalMesh->GetPathName();
-        propertiesPtr->Set(sfProp::Mesh, sfPropertyUtil::FromString(path, m_sessionPtr));
-
-        sfListProperty::SPtr materialsPropPtr = sfListProperty::Create();
-        TArray<UMaterialInterface*> materials = componentPtr->GetMaterials();
-        for (UMaterialInterface* materialPtr : materials)
-        {
-            path = materialPtr == nullptr ? "" : materialPtr->GetPathName();
-            materialsPropPtr->Add(sfPropertyUtil::FromString(path, m_sessionPtr));
-        }
-        propertiesPtr->Set(sfProp::Materials, materialsPropPtr);
+        propertiesPtr->Set(sfProp::Mesh, m_assetDictionaryPtr->FromPath(path));
+        propertiesPtr->Set(sfProp::Materials, CreateMaterialsProperty(componentPtr));
     }
     return true;
 }
@@ -799,45 +1030,55 @@ bool sfActorManager::ApplySkeletalMeshProperties(AActor* actorPtr, sfDictionaryP
     USkeletalMeshComponent* componentPtr = skeletalMeshPtr->GetSkeletalMeshComponent();
     if (componentPtr != nullptr && propertiesPtr->TryGet(sfProp::Mesh, propPtr))
     {
-        FString path = sfPropertyUtil::ToString(propPtr);
-        if (path.IsEmpty())
-        {
-            componentPtr->SetSkeletalMesh(nullptr);
-        }
-        else
-        {
-            // Disable loading dialog that causes a crash if we are dragging objects
-            GIsSlowTask = true;
-            componentPtr->SetSkeletalMesh(LoadObject<USkeletalMesh>(nullptr, *path));
-            GIsSlowTask = false;
-        }
+        FString path = m_assetDictionaryPtr->ToPath(propPtr);
         sfListProperty::SPtr materialsPtr = propertiesPtr->Get(sfProp::Materials)->AsList();
-        int numMaterials = FMath::Min(componentPtr->GetNumMaterials(), materialsPtr->Size());
-        if (componentPtr->GetNumMaterials() != materialsPtr->Size())
+        // The actor keeps its current mesh until the new one loads. Materials are applied after the mesh because the
+        // number of material slots depends on the mesh.
+        m_assetLoader.Load(componentPtr, -1, path, [this, componentPtr, materialsPtr, path](UObject* assetPtr)
         {
-            KS::Log::Warning("Material count mismatch on skeletal mesh '" + std::string(TCHAR_TO_UTF8(*path)) +
-                "'. Server has " + std::to_string(materialsPtr->Size()) + " but we have " +
-                std::to_string(componentPtr->GetNumMaterials()), LOG_CHANNEL);
-        }
-        for (int i = 0; i < numMaterials; i++)
-        {
-            path = sfPropertyUtil::ToString(materialsPtr->Get(i));
-            if (path.IsEmpty())
-            {
-                componentPtr->SetMaterial(i, nullptr);
-            }
-            else
-            {
-                // Disable loading dialog that causes a crash if we are dragging objects
-                GIsSlowTask = true;
-                componentPtr->SetMaterial(i, LoadObject<UMaterialInterface>(nullptr, *path));
-                GIsSlowTask = false;
-            }
-        }
+            componentPtr->SetSkeletalMesh(Cast<USkeletalMesh>(assetPtr));
+            ApplyMaterials(componentPtr, materialsPtr, path);
+            SceneFusion::RedrawActiveViewport();
+        });
     }
     return true;
 }
 
+sfListProperty::SPtr sfActorManager::CreateMaterialsProperty(UMeshComponent* componentPtr)
+{
+    sfListProperty::SPtr materialsPropPtr = sfListProperty::Create();
+    for (int i = 0; i < componentPtr->GetNumMaterials(); i++)
+    {
+        UMaterialInterface* materialPtr = componentPtr->OverrideMaterials.IsValidIndex(i) ?
+            componentPtr->OverrideMaterials[i] : nullptr;
+        materialsPropPtr->Add(m_assetDictionaryPtr->FromPath(materialPtr == nullptr ? "" : materialPtr->GetPathName()));
+    }
+    return materialsPropPtr;
+}
+
+void sfActorManager::ApplyMaterials(
+    UMeshComponent* componentPtr,
+    sfListProperty::SPtr materialsPtr,
+    const FString& meshPath)
+{
+    int numMaterials = FMath::Min(componentPtr->GetNumMaterials(), materialsPtr->Size());
+    if (componentPtr->GetNumMaterials() != materialsPtr->Size())
+    {
+        KS::Log::Warning("Material count mismatch on mesh '" + std::string(TCHAR_TO_UTF8(*meshPath)) +
+            "'. Server has " + std::to_string(materialsPtr->Size()) + " but we have " +
+            std::to_string(componentPtr->GetNumMaterials()), LOG_CHANNEL);
+    }
+    for (int i = 0; i < numMaterials; i++)
+    {
+        FString path = m_assetDictionaryPtr->ToPath(materialsPtr->Get(i));
+        m_assetLoader.Load(componentPtr, i, path, [componentPtr, i](UObject* assetPtr)
+        {
+            componentPtr->SetMaterial(i, Cast<UMaterialInterface>(assetPtr));
+            SceneFusion::RedrawActiveViewport();
+        });
+    }
+}
+
 bool sfActorManager::CreateEmitterProperties(AActor* actorPtr, sfDictionaryProperty::SPtr propertiesPtr)
 {
     AEmitter* emitterPtr = Cast<AEmitter>(actorPtr);
@@ -848,8 +1089,7 @@ bool sfActorManager::CreateEmitterProperties(AActor* actorPtr, sfDictionaryPrope
     UParticleSystemComponent* componentPtr = emitterPtr->GetParticleSystemComponent();
     if (componentPtr != nullptr && componentPtr->Template != nullptr)
     {
-        propertiesPtr->Set(sfProp::Template,
-            sfPropertyUtil::FromString(componentPtr->Template->GetPathName(), m_sessionPtr));
+        propertiesPtr->Set(sfProp::Template, m_assetDictionaryPtr->FromPath(componentPtr->Template->GetPathName()));
     }
     return true;
 }
@@ -865,16 +1105,23 @@ bool sfActorManager::ApplyEmitterProperties(AActor* actorPtr, sfDictionaryProper
     UParticleSystemComponent* componentPtr = emitterPtr->GetParticleSystemComponent();
     if (componentPtr != nullptr && propertiesPtr->TryGet(sfProp::Template, propPtr))
     {
-        // Disable loading dialog that causes a crash if we are dragging objects
-        GIsSlowTask = true;
-        componentPtr->SetTemplate(LoadObject<UParticleSystem>(nullptr, *sfPropertyUtil::ToString(propPtr)));
-        GIsSlowTask = false;
+        m_assetLoader.Load(componentPtr, -1, m_assetDictionaryPtr->ToPath(propPtr), [componentPtr](UObject* assetPtr)
+        {
+            componentPtr->SetTemplate(Cast<UParticleSystem>(assetPtr));
+            SceneFusion::RedrawActiveViewport();
+        });
     }
     return true;
 }
 
 void sfActorManager::OnActorDeleted(AActor* actorPtr)
 {
+    m_folderIndex.Remove(actorPtr);
+    m_lockIndex.Remove(actorPtr);
+    if (m_actorDeletedGuard.IsActive())
+    {
+        return;
+    }
     // Ignore actors in the buffer level.
     // The buffer level is a temporary level used when moving actors to a different level.
     if (actorPtr->GetOutermost() == GetTransientPackage())
@@ -882,11 +1129,11 @@ void sfActorManager::OnActorDeleted(AActor* actorPtr)
         return;
     }
 
-    sfObject::SPtr objPtr;
-    if (m_actorToObjectMap.RemoveAndCopyValue(actorPtr, objPtr))
+    sfObject::SPtr objPtr = m_actorRegistry.RemoveActor(actorPtr);
+    if (objPtr != nullptr)
     {
         objPtr->ReleaseLock();
-        m_objectToActorMap.erase(objPtr);
+        UnwatchTransform(actorPtr);
         if (objPtr->IsLocked())
         {
             m_recreateQueue.Enqueue(objPtr);
@@ -899,135 +1146,75 @@ void sfActorManager::OnActorDeleted(AActor* actorPtr)
             {
                 sfObject::SPtr childPtr = objPtr->Child(0);
                 levelObjPtr->AddChild(childPtr);
-                auto iter = m_objectToActorMap.find(childPtr);
-                if (iter != m_objectToActorMap.end())
+                AActor* childActorPtr = m_actorRegistry.FindActor(childPtr);
+                if (childActorPtr != nullptr)
                 {
-                    SendTransformUpdate(iter->second, childPtr);
+                    SendTransformUpdate(childActorPtr, childPtr);
                 }
             }
             m_sessionPtr->Delete(objPtr);
+            m_pruneMergedValues = true;
         }
     }
     m_selectedActors.erase(actorPtr);
+    m_selectionChanges.Remove(actorPtr);
     m_propertyChangeMap.Remove(actorPtr);
     m_uploadList.Remove(actorPtr);
+    m_syncFolderList.Remove(actorPtr);
 }
 
 void sfActorManager::OnDelete(sfObject::SPtr objPtr)
 {
-    auto iter = m_objectToActorMap.find(objPtr);
-    if (iter == m_objectToActorMap.end())
+    // Merged values may have been set after the user who deleted the object removed them
+    m_pruneMergedValues = true;
+    AActor* actorPtr = m_actorRegistry.RemoveObject(objPtr);
+    if (actorPtr == nullptr)
     {
         return;
     }
-    AActor* actorPtr = iter->second;
-    m_objectToActorMap.erase(iter);
+    UnwatchTransform(actorPtr);
     if (actorPtr->IsA<ABrush>())
     {
         m_bspRebuildDelay = BSP_REBUILD_DELAY;
     }
     UWorld* worldPtr = GEditor->GetEditorWorldContext().World();
-    GEngine->OnLevelActorDeleted().Remove(m_onActorDeletedHandle);
+    sfEventGuard::Scope guard(m_actorDeletedGuard);
     worldPtr->EditorDestroyActor(actorPtr, true);
-    m_onActorDeletedHandle = GEngine->OnLevelActorDeleted().AddRaw(this, &sfActorManager::OnActorDeleted);
-    m_actorToObjectMap.Remove(actorPtr);
     SceneFusion::RedrawActiveViewport();
 }
 
 void sfActorManager::OnLock(sfObject::SPtr objPtr)
 {
-    auto iter = m_objectToActorMap.find(objPtr);
-    if (iter == m_objectToActorMap.end())
+    AActor* actorPtr = m_actorRegistry.FindActor(objPtr);
+    if (actorPtr == nullptr)
     {
         OnCreate(objPtr, 0);
         return;
     }
-    AActor* actorPtr = iter->second;
-    InvokeOnLockStateChange(objPtr, actorPtr);
-    if (actorPtr->GetRootComponent() == nullptr)
-    {
-        return;
-    }
-    Lock(actorPtr, objPtr->LockOwner());
+    m_lockChanges.insert(objPtr);
+    m_numLockEvents++;
 }
 
 void sfActorManager::Lock(AActor* actorPtr, sfUser::SPtr lockOwnerPtr)
 {
-    if (m_lockMaterialPtr != nullptr)
-    {
-        UMaterialInterface* lockMaterialPtr = GetLockMaterial(lockOwnerPtr);
-        TArray<UMeshComponent*> meshes;
-        actorPtr->GetComponents(meshes);
-        if (meshes.Num() > 0)
-        {
-            for (int i = 0; i < meshes.Num(); i++)
-            {
-                UsfLockComponent* lockPtr = NewObject<UsfLockComponent>(actorPtr, *FString("SFLock" + FString::FromInt(i)));
-                lockPtr->CreationMethod = EComponentCreationMethod::Instance;
-                lockPtr->SetMobility(meshes[i]->Mobility);
-                lockPtr->AttachToComponent(meshes[i], FAttachmentTransformRules::KeepRelativeTransform);
-                lockPtr->RegisterComponent();
-                lockPtr->InitializeComponent();
-                lockPtr->DuplicateParentMesh(lockMaterialPtr);
-                SceneFusion::RedrawActiveViewport();
-            }
-            return;
-        }
-    }
-    UsfLockComponent* lockPtr = NewObject<UsfLockComponent>(actorPtr, *FString("SFLock"));
-    lockPtr->CreationMethod = EComponentCreationMethod::Instance;
-    lockPtr->AttachToComponent(actorPtr->GetRootComponent(), FAttachmentTransformRules::KeepRelativeTransform);
-    lockPtr->RegisterComponent();
-    lockPtr->InitializeComponent();
+    m_lockRenderer.Lock(actorPtr, lockOwnerPtr);
 }
 
 sfObject::SPtr sfActorManager::GetSFObjectByActor(AActor* actorPtr)
 {
-    return m_actorToObjectMap.FindRef(actorPtr);
-}
-
-UMaterialInterface* sfActorManager::GetLockMaterial(sfUser::SPtr userPtr)
-{
-    if (userPtr == nullptr)
-    {
-        return m_lockMaterialPtr;
-    }
-    UMaterialInstanceDynamic** materialPtrPtr = m_lockMaterials.Find(userPtr->Id());
-    if (materialPtrPtr != nullptr)
-    {
-        return Cast<UMaterialInterface>(*materialPtrPtr);
-    }
-    UMaterialInstanceDynamic* materialPtr = UMaterialInstanceDynamic::Create(m_lockMaterialPtr, nullptr);
-    materialPtr->SetFlags(EObjectFlags::RF_Standalone);//prevent material from being destroyed
-    ksColor color = userPtr->Color();
-    FLinearColor ucolor(color.R(), color.G(), color.B());
-    materialPtr->SetVectorParameterValue("Color", ucolor);
-    m_lockMaterials.Add(userPtr->Id(), materialPtr);
-    return Cast<UMaterialInterface>(materialPtr);
+    return m_actorRegistry.FindObject(actorPtr);
 }
 
 void sfActorManager::OnUnlock(sfObject::SPtr objPtr)
 {
-    auto iter = m_objectToActorMap.find(objPtr);
-    if (iter != m_objectToActorMap.end())
-    {
-        Unlock(iter->second);
-        InvokeOnLockStateChange(objPtr, iter->second);
-    }
+    m_lockChanges.insert(objPtr);
+    m_numLockEvents++;
 }
 
 void sfActorManager::Unlock(AActor* actorPtr)
 {
-    // If you undo the deletion of an actor with lock components, the lock components will not be part of the
-    // OwnedComponents set so we have to use our own function to find them instead of AActor->GetComponents.
-    // Not sure why this happens. It seems like an Unreal bug.
-    TArray<UsfLockComponent*> locks;
-    sfActorUtil::GetSceneComponents<UsfLockComponent>(actorPtr, locks);
-    for (UsfLockComponent* lockPtr : locks)
-    {
-        lockPtr->DestroyComponent();
-        SceneFusion::RedrawActiveViewport();
-    }
+    m_lockIndex.Remove(actorPtr);
+    m_lockRenderer.Unlock(actorPtr);
     // When a selected actor becomes unlocked you have to unselect and reselect it to unlock the handles
     if (actorPtr->IsSelected())
     {
@@ -1036,31 +1223,86 @@ void sfActorManager::Unlock(AActor* actorPtr)
     }
 }
 
-void sfActorManager::OnLockOwnerChange(sfObject::SPtr objPtr)
+void sfActorManager::Unlock(const TArray<AActor*>& actors)
 {
-    auto iter = m_objectToActorMap.find(objPtr);
-    if (iter == m_objectToActorMap.end())
+    bool reselected = false;
+    for (AActor* actorPtr : actors)
     {
-        return;
+        m_lockIndex.Remove(actorPtr);
+        m_lockRenderer.Unlock(actorPtr);
+        if (actorPtr->IsSelected())
+        {
+            GEditor->SelectActor(actorPtr, false, false);
+            GEditor->SelectActor(actorPtr, true, false);
+            reselected = true;
+        }
+    }
+    if (reselected)
+    {
+        GEditor->NoteSelectionChange();
     }
+}
 
-    InvokeOnLockStateChange(objPtr, iter->second);
+void sfActorManager::OnLockOwnerChange(sfObject::SPtr objPtr)
+{
+    m_lockChanges.insert(objPtr);
+    m_numLockEvents++;
+}
 
-    UMaterialInterface* lockMaterialPtr = GetLockMaterial(objPtr->LockOwner());
-    if (lockMaterialPtr == nullptr)
+void sfActorManager::ApplyLockChanges()
+{
+    if (m_lockChanges.size() == 0)
     {
         return;
     }
-    TArray<UsfLockComponent*> locks;
-    sfActorUtil::GetSceneComponents<UsfLockComponent>(iter->second, locks);
-    for (UsfLockComponent* lockPtr : locks)
+    TArray<AActor*> unlockedActors;
+    int numChanges = 0;
+    for (const sfObject::SPtr& objPtr : m_lockChanges)
     {
-        lockPtr->SetMaterial(lockMaterialPtr);
+        AActor* actorPtr = m_actorRegistry.FindActor(objPtr);
+        if (actorPtr == nullptr)
+        {
+            continue;
+        }
+        InvokeOnLockStateChange(objPtr, actorPtr);
+        // Actors that aren't in the index have no lock visuals. This includes actors unlocked when their lock owner
+        // left.
+        bool wasLocked = m_lockIndex.Contains(actorPtr);
+        if (!objPtr->IsLocked())
+        {
+            if (wasLocked)
+            {
+                unlockedActors.Add(actorPtr);
+                numChanges++;
+            }
+            continue;
+        }
+        if (!m_lockIndex.Add(actorPtr, objPtr->LockOwner()))
+        {
+            continue;
+        }
+        numChanges++;
+        if (wasLocked)
+        {
+            m_lockRenderer.SetLockOwner(actorPtr, objPtr->LockOwner());
+        }
+        else if (actorPtr->GetRootComponent() != nullptr)
+        {
+            Lock(actorPtr, objPtr->LockOwner());
+        }
     }
+    Unlock(unlockedActors);
+    m_lockBatch.OnGroupApplied(m_numLockEvents, numChanges);
+    m_lockChanges.clear();
+    m_numLockEvents = 0;
 }
 
 void sfActorManager::OnAttachDetach(AActor* actorPtr, const AActor* parentPtr)
 {
+    if (m_attachDetachGuard.IsActive())
+    {
+        return;
+    }
     // Unreal fires the detach event before updating the relative transform, and if we need to change the parent back
     // because of locks Unreal won't let us here, so we queue the actor to be processed later.
     m_syncParentList.AddUnique(actorPtr);
@@ -1068,12 +1310,11 @@ void sfActorManager::OnAttachDetach(AActor* actorPtr, const AActor* parentPtr)
 
 void sfActorManager::OnParentChange(sfObject::SPtr objPtr, int childIndex)
 {
-    auto iter = m_objectToActorMap.find(objPtr);
-    if (iter == m_objectToActorMap.end())
+    AActor* actorPtr = m_actorRegistry.FindActor(objPtr);
+    if (actorPtr == nullptr)
     {
         return;
     }
-    AActor* actorPtr = iter->second;
     if (objPtr->Parent() == nullptr)
     {
         LogNoParentErrorAndDisconnect(objPtr);
@@ -1086,107 +1327,375 @@ void sfActorManager::OnParentChange(sfObject::SPtr objPtr, int childIndex)
             return;
         }
 
-        iter = m_objectToActorMap.find(objPtr->Parent());
-        if (iter != m_objectToActorMap.end())
+        AActor* parentActorPtr = m_actorRegistry.FindActor(objPtr->Parent());
+        if (parentActorPtr != nullptr)
         {
-            GEngine->OnLevelActorAdded().Remove(m_onActorAttachedHandle);
-            actorPtr->AttachToActor(iter->second, FAttachmentTransformRules::KeepRelativeTransform);
-            m_onActorAttachedHandle = GEngine->OnLevelActorAttached().AddRaw(this, &sfActorManager::OnAttachDetach);
+            sfEventGuard::Scope guard(m_attachDetachGuard);
+            actorPtr->AttachToActor(parentActorPtr, FAttachmentTransformRules::KeepRelativeTransform);
         }
     }
 }
 
 void sfActorManager::OnFolderChange(const AActor* actorPtr, FName oldFolder)
 {
-    sfObject::SPtr objPtr = m_actorToObjectMap.FindRef(actorPtr);
+    // Folder changes we make still need to update the folder index
+    m_folderIndex.Update(actorPtr);
+    if (m_folderChangeGuard.IsActive())
+    {
+        return;
+    }
+    // Renaming a folder fires a folder moved event after moving the actors, so we sync the folder on the next tick
+    // after the folder manager has sent the rename. Actors in a renamed folder then have nothing to send.
+    if (m_actorRegistry.Contains(actorPtr))
+    {
+        m_syncFolderList.AddUnique(const_cast<AActor*>(actorPtr));
+    }
+}
+
+void sfActorManager::OnMoveStart(UObject& obj)
+{
+    m_movingActors = GCurrentLevelEditingViewportClient &&
+        GCurrentLevelEditingViewportClient->bWidgetAxisControlledByDrag;
+}
+
+void sfActorManager::OnMoveEnd(UObject& obj)
+{
+    m_movingActors = false;
+    for (auto iter : m_selectedActors)
+    {
+        if (!BufferIfLockPending(iter.first, iter.second))
+        {
+            SendTransformUpdate(iter.first, iter.second);
+        }
+    }
+    m_dragSentTransforms.Empty();
+}
+
+void sfActorManager::SyncTransform(AActor* actorPtr)
+{
+    sfObject::SPtr objPtr = m_actorRegistry.FindObject(actorPtr);
     if (objPtr == nullptr)
     {
         return;
     }
-    sfDictionaryProperty::SPtr propertiesPtr = objPtr->Property()->AsDict();
-    if (objPtr->IsLocked())
+    if (!objPtr->IsLocked())
     {
-        // Reverting the folder now can break the world outliner, so we queue it to be done on the next tick
-        m_revertFolderQueue.Enqueue(const_cast<AActor*>(actorPtr));
+        SendTransformUpdate(actorPtr, objPtr);
     }
     else
     {
-        propertiesPtr->Set(sfProp::Folder,
-            sfPropertyUtil::FromString(actorPtr->GetFolderPath().ToString(), m_sessionPtr));
+        ApplyServerTransform(actorPtr, objPtr);
+    }
+}
+
+void sfActorManager::SendTransformUpdate(AActor* actorPtr, sfObject::SPtr objPtr)
+{
+    sfDictionaryProperty::SPtr propertiesPtr = objPtr->Property()->AsDict();
+
+    USceneComponent* rootComponentPtr = actorPtr->GetRootComponent();
+    if (rootComponentPtr == nullptr)
+    {
+        return;
+    }
+    FVector scale = actorPtr->GetActorRelativeScale3D();
+    sfProperty::SPtr oldPropPtr;
+    if (propertiesPtr->TryGet(sfProp::Transform, oldPropPtr))
+    {
+        // Compare encoded bytes so changes smaller than the quantization precision are not sent
+        sfProperty::SPtr transformPtr = sfPackedTransform::Encode(rootComponentPtr->RelativeLocation,
+            rootComponentPtr->RelativeRotation, scale);
+        if (!sfPackedTransform::Equals(transformPtr, oldPropPtr))
+        {
+            propertiesPtr->Set(sfProp::Transform, transformPtr);
+            sfPackedTransform::RecordUpdate(true, 1, sfPropertyUtil::EstimateSize(transformPtr));
+        }
+        // Snapping while dragging would fight the drag, so we snap when the drag ends
+        if (!m_movingActors)
+        {
+            ApplyPackedTransform(rootComponentPtr, transformPtr);
+        }
+        return;
+    }
+
+    int numProperties = 0;
+    int bytes = 0;
+    if (!propertiesPtr->TryGet(sfProp::Location, oldPropPtr) ||
+        rootComponentPtr->RelativeLocation != sfPropertyUtil::ToVector(oldPropPtr))
+    {
+        sfProperty::SPtr locationPtr = sfPropertyUtil::FromVector(rootComponentPtr->RelativeLocation);
+        propertiesPtr->Set(sfProp::Location, locationPtr);
+        numProperties++;
+        bytes += sfPropertyUtil::EstimateSize(locationPtr);
+    }
+
+    if (!propertiesPtr->TryGet(sfProp::Rotation, oldPropPtr) ||
+        rootComponentPtr->RelativeRotation != sfPropertyUtil::ToRotator(oldPropPtr))
+    {
+        sfProperty::SPtr rotationPtr = sfPropertyUtil::FromRotator(rootComponentPtr->RelativeRotation);
+        propertiesPtr->Set(sfProp::Rotation, rotationPtr);
+        numProperties++;
+        bytes += sfPropertyUtil::EstimateSize(rotationPtr);
+    }
+
+    if (!propertiesPtr->TryGet(sfProp::Scale, oldPropPtr) || scale != sfPropertyUtil::ToVector(oldPropPtr))
+    {
+        sfProperty::SPtr scalePtr = sfPropertyUtil::FromVector(scale);
+        propertiesPtr->Set(sfProp::Scale, scalePtr);
+        numProperties++;
+        bytes += sfPropertyUtil::EstimateSize(scalePtr);
+    }
+    if (numProperties > 0)
+    {
+        sfPackedTransform::RecordUpdate(false, numProperties, bytes);
+    }
+}
+
+void sfActorManager::WatchTransform(AActor* actorPtr)
+{
+    USceneComponent* rootComponentPtr = actorPtr->GetRootComponent();
+    if (rootComponentPtr == nullptr || m_transformHandles.Contains(actorPtr))
+    {
+        return;
+    }
+    FDelegateHandle handle = rootComponentPtr->TransformUpdated.AddRaw(this, &sfActorManager::OnTransformUpdated);
+    m_transformHandles.Add(actorPtr, TPair<TWeakObjectPtr<USceneComponent>, FDelegateHandle>(rootComponentPtr, handle));
+}
+
+void sfActorManager::UnwatchTransform(AActor* actorPtr)
+{
+    TPair<TWeakObjectPtr<USceneComponent>, FDelegateHandle> pair;
+    if (m_transformHandles.RemoveAndCopyValue(actorPtr, pair) && pair.Key.IsValid())
+    {
+        pair.Key->TransformUpdated.Remove(pair.Value);
+    }
+    m_dirtyTransforms.Remove(actorPtr);
+    m_serverTransformChanges.Remove(actorPtr);
+    m_pendingLockEdits.Remove(actorPtr);
+}
+
+bool sfActorManager::BufferIfLockPending(AActor* actorPtr, sfObject::SPtr objPtr)
+{
+    if (!sfConfig::Get().OptimisticLocks || (!objPtr->IsLockPending() && !m_lockBatch.IsPending(objPtr)))
+    {
+        return false;
+    }
+    bool alreadyBuffered = false;
+    m_pendingLockEdits.Add(actorPtr, &alreadyBuffered);
+    if (!alreadyBuffered)
+    {
+        m_lockBatch.OnOptimisticEdit();
+    }
+    return true;
+}
+
+void sfActorManager::ResolvePendingLockEdits()
+{
+    for (auto iter = m_pendingLockEdits.CreateIterator(); iter; ++iter)
+    {
+        AActor* actorPtr = *iter;
+        sfObject::SPtr objPtr = m_actorRegistry.FindObject(actorPtr);
+        if (objPtr == nullptr)
+        {
+            iter.RemoveCurrent();
+        }
+        else if (objPtr->IsLocked())
+        {
+            // Another user got the lock first, so we revert to the server transform. Our buffered changes were never
+            // sent, so every user ends up with the server transform.
+            ApplyServerTransform(actorPtr, objPtr);
+            m_dragSentTransforms.Remove(actorPtr);
+            m_lockBatch.OnRollback();
+            iter.RemoveCurrent();
+        }
+        else if (!objPtr->IsLockPending() && !m_lockBatch.IsPending(objPtr))
+        {
+            // The lock was granted, or released before it was granted without anyone else locking the object
+            m_dirtyTransforms.Add(actorPtr);
+            iter.RemoveCurrent();
+        }
+    }
+}
+
+void sfActorManager::OnTransformUpdated(
+    USceneComponent* componentPtr,
+    EUpdateTransformFlags flags,
+    ETeleportType teleport)
+{
+    if (!m_transformGuard.IsActive() && componentPtr->GetOwner() != nullptr)
+    {
+        m_dirtyTransforms.Add(componentPtr->GetOwner());
+    }
+}
+
+void sfActorManager::SendDirtyTransforms()
+{
+    // While dragging, transforms are sent at a limited rate and the exact transforms are sent when the drag ends
+    if (m_dirtyTransforms.Num() == 0 ||
+        (m_movingActors && !m_sendRateController.ShouldSend(m_dirtyTransforms.Num())))
+    {
+        return;
+    }
+    for (AActor* actorPtr : m_dirtyTransforms)
+    {
+        sfObject::SPtr objPtr = m_actorRegistry.FindObject(actorPtr);
+        if (objPtr == nullptr)
+        {
+            continue;
+        }
+        if (objPtr->IsLocked())
+        {
+            ApplyServerTransform(actorPtr, objPtr);
+        }
+        else if (BufferIfLockPending(actorPtr, objPtr))
+        {
+            continue;
+        }
+        else if (m_movingActors)
+        {
+            SendDragTransformUpdate(actorPtr, objPtr);
+        }
+        else
+        {
+            SendTransformUpdate(actorPtr, objPtr);
+        }
+    }
+    m_dirtyTransforms.Empty();
+}
+
+void sfActorManager::SendDragTransformUpdate(AActor* actorPtr, sfObject::SPtr objPtr)
+{
+    USceneComponent* rootComponentPtr = actorPtr->GetRootComponent();
+    if (rootComponentPtr == nullptr)
+    {
+        return;
+    }
+    FTransform transform(rootComponentPtr->RelativeRotation, rootComponentPtr->RelativeLocation,
+        actorPtr->GetActorRelativeScale3D());
+    FTransform* lastSentPtr = m_dragSentTransforms.Find(actorPtr);
+    if (lastSentPtr != nullptr)
+    {
+        sfConfig& config = sfConfig::Get();
+        float angle = FMath::RadiansToDegrees(transform.GetRotation().AngularDistance(lastSentPtr->GetRotation()));
+        if (FVector::Dist(transform.GetLocation(), lastSentPtr->GetLocation()) < config.DragMinDistance &&
+            angle < config.DragMinAngle && transform.GetScale3D().Equals(lastSentPtr->GetScale3D()))
+        {
+            return;
+        }
     }
+    m_dragSentTransforms.Add(actorPtr, transform);
+    SendTransformUpdate(actorPtr, objPtr);
 }
 
-void sfActorManager::OnMoveStart(UObject& obj)
+void sfActorManager::ApplyServerTransform(AActor* actorPtr, sfObject::SPtr objPtr)
 {
-    m_movingActors = GCurrentLevelEditingViewportClient &&
-        GCurrentLevelEditingViewportClient->bWidgetAxisControlledByDrag;
+    FVector location;
+    FRotator rotation;
+    FVector scale;
+    if (GetServerTransform(objPtr->Property()->AsDict(), location, rotation, scale))
+    {
+        USceneComponent* rootComponentPtr = actorPtr->GetRootComponent();
+        if (rootComponentPtr == nullptr)
+        {
+            return;
+        }
+        sfEventGuard::Scope guard(m_transformGuard);
+        // Location and rotation are set together so the component transform is updated once for both
+        rootComponentPtr->SetRelativeLocationAndRotation(location, rotation);
+        rootComponentPtr->SetRelativeScale3D(scale);
+    }
 }
 
-void sfActorManager::OnMoveEnd(UObject& obj)
+void sfActorManager::ApplyPackedTransform(USceneComponent* rootComponentPtr, sfProperty::SPtr transformPtr)
 {
-    m_movingActors = false;
-    for (auto iter : m_selectedActors)
+    // Other users apply the decoded transform, so we apply it too so everyone has the same transform
+    FVector location;
+    FRotator rotation;
+    FVector scale;
+    if (!sfPackedTransform::Decode(transformPtr, location, rotation, scale) ||
+        (location == rootComponentPtr->RelativeLocation && rotation == rootComponentPtr->RelativeRotation &&
+        scale == rootComponentPtr->RelativeScale3D))
     {
-        SendTransformUpdate(iter.first, iter.second);
+        return;
     }
+    sfEventGuard::Scope guard(m_transformGuard);
+    rootComponentPtr->SetRelativeLocationAndRotation(location, rotation);
+    rootComponentPtr->SetRelativeScale3D(scale);
 }
 
-void sfActorManager::SyncTransform(AActor* actorPtr)
+void sfActorManager::ApplyServerTransformChanges()
 {
-    sfObject::SPtr objPtr = m_actorToObjectMap.FindRef(actorPtr);
-    if (objPtr == nullptr)
+    if (m_serverTransformChanges.Num() == 0)
     {
         return;
     }
-    if (!objPtr->IsLocked())
-    {
-        SendTransformUpdate(actorPtr, objPtr);
-    }
-    else
+    sfUtils::PreserveUndoStack([this]()
     {
-        ApplyServerTransform(actorPtr, objPtr);
-    }
+        for (AActor* actorPtr : m_serverTransformChanges)
+        {
+            sfObject::SPtr objPtr = m_actorRegistry.FindObject(actorPtr);
+            if (objPtr == nullptr)
+            {
+                continue;
+            }
+            ApplyServerTransform(actorPtr, objPtr);
+            actorPtr->InvalidateLightingCache();
+            if (actorPtr->IsA<ABrush>())
+            {
+                ABrush::SetNeedRebuild(actorPtr->GetLevel());
+                m_bspRebuildDelay = BSP_REBUILD_DELAY;
+            }
+        }
+    });
+    m_serverTransformChanges.Empty();
+    SceneFusion::RedrawActiveViewport();
 }
 
-void sfActorManager::SendTransformUpdate(AActor* actorPtr, sfObject::SPtr objPtr)
+void sfActorManager::CreateTransformProperties(AActor* actorPtr, sfDictionaryProperty::SPtr propertiesPtr)
 {
-    sfDictionaryProperty::SPtr propertiesPtr = objPtr->Property()->AsDict();
-
     USceneComponent* rootComponentPtr = actorPtr->GetRootComponent();
     if (rootComponentPtr == nullptr)
     {
         return;
     }
-    sfProperty::SPtr oldPropPtr;
-    if (!propertiesPtr->TryGet(sfProp::Location, oldPropPtr) ||
-        rootComponentPtr->RelativeLocation != sfPropertyUtil::ToVector(oldPropPtr))
+    if (sfConfig::Get().PackTransforms)
     {
-        propertiesPtr->Set(sfProp::Location, sfPropertyUtil::FromVector(rootComponentPtr->RelativeLocation));
+        sfProperty::SPtr transformPtr = sfPackedTransform::Encode(rootComponentPtr->RelativeLocation,
+            rootComponentPtr->RelativeRotation, actorPtr->GetActorRelativeScale3D());
+        propertiesPtr->Set(sfProp::Transform, transformPtr);
+        ApplyPackedTransform(rootComponentPtr, transformPtr);
     }
-
-    if (!propertiesPtr->TryGet(sfProp::Rotation, oldPropPtr) ||
-        rootComponentPtr->RelativeRotation != sfPropertyUtil::ToRotator(oldPropPtr))
+    else
     {
+        propertiesPtr->Set(sfProp::Location, sfPropertyUtil::FromVector(rootComponentPtr->RelativeLocation));
         propertiesPtr->Set(sfProp::Rotation, sfPropertyUtil::FromRotator(rootComponentPtr->RelativeRotation));
-    }
-
-    FVector scale = actorPtr->GetActorRelativeScale3D();
-    if (!propertiesPtr->TryGet(sfProp::Scale, oldPropPtr) || scale != sfPropertyUtil::ToVector(oldPropPtr))
-    {
-        propertiesPtr->Set(sfProp::Scale, sfPropertyUtil::FromVector(scale));
+        propertiesPtr->Set(sfProp::Scale, sfPropertyUtil::FromVector(actorPtr->GetActorRelativeScale3D()));
     }
 }
 
-void sfActorManager::ApplyServerTransform(AActor* actorPtr, sfObject::SPtr objPtr)
+bool sfActorManager::GetServerTransform(
+    sfDictionaryProperty::SPtr propertiesPtr,
+    FVector& location,
+    FRotator& rotation,
+    FVector& scale)
 {
-    sfDictionaryProperty::SPtr propertiesPtr = objPtr->Property()->AsDict();
-    sfProperty::SPtr locationPtr;
-    if (propertiesPtr->TryGet(sfProp::Location, locationPtr))
+    sfProperty::SPtr propPtr;
+    if (propertiesPtr->TryGet(sfProp::Transform, propPtr))
+    {
+        if (!sfPackedTransform::Decode(propPtr, location, rotation, scale))
+        {
+            KS::Log::Warning("Invalid packed transform.", LOG_CHANNEL);
+            return false;
+        }
+        return true;
+    }
+    if (propertiesPtr->TryGet(sfProp::Location, propPtr))
     {
-        actorPtr->SetActorRelativeLocation(sfPropertyUtil::ToVector(locationPtr));
-        actorPtr->SetActorRelativeRotation(sfPropertyUtil::ToRotator(propertiesPtr->Get(sfProp::Rotation)));
-        actorPtr->SetActorRelativeScale3D(sfPropertyUtil::ToVector(propertiesPtr->Get(sfProp::Scale)));
+        location = sfPropertyUtil::ToVector(propPtr);
+        rotation = sfPropertyUtil::ToRotator(propertiesPtr->Get(sfProp::Rotation));
+        scale = sfPropertyUtil::ToVector(propertiesPtr->Get(sfProp::Scale));
+        return true;
     }
+    return false;
 }
 
 void sfActorManager::RegisterUndoTypes()
@@ -1345,10 +1854,8 @@ void sfActorManager::DestroyUnwantedActors()
     {
         if (!actorPtr->IsPendingKill() && !m_uploadList.Contains(actorPtr))
         {
-            GEngine->OnLevelActorDeleted().Remove(m_onActorDeletedHandle);
+            sfEventGuard::Scope guard(m_actorDeletedGuard);
             worldPtr->EditorDestroyActor(actorPtr, true);
-            m_onActorDeletedHandle = GEngine->OnLevelActorDeleted().AddRaw(this,
-                &sfActorManager::OnActorDeleted);
         }
     }
     m_destroyedActorsToCheck.Empty();
@@ -1395,7 +1902,16 @@ void sfActorManager::OnUndoRedo(FString action, bool isUndo)
         {
             continue;
         }
-        sfObject::SPtr objPtr = m_actorToObjectMap.FindRef(actorPtr);
+        // Undo and redo restore folders and actors without firing events, so we update the folder index here
+        if (actorPtr->IsPendingKill())
+        {
+            m_folderIndex.Remove(actorPtr);
+        }
+        else
+        {
+            m_folderIndex.Update(actorPtr);
+        }
+        sfObject::SPtr objPtr = m_actorRegistry.FindObject(actorPtr);
         sfDictionaryProperty::SPtr propertiesPtr = objPtr == nullptr ?
             nullptr : objPtr->Property()->AsDict();
         if (objPtr != nullptr)
@@ -1485,6 +2001,7 @@ void sfActorManager::OnUndoRedo(FString action, bool isUndo)
 #endif
         }
     }
+    m_undoNameIndices.Empty();
 }
 
 void sfActorManager::OnUndoRedoMove(
@@ -1503,38 +2020,29 @@ void sfActorManager::OnUndoRedoMove(
         else
         {
             // Rotating multiple actors may also change their location, so we check location in both cases
-            FVector oldLocation = sfPropertyUtil::ToVector(propertiesPtr->Get(sfProp::Location));
+            FVector oldLocation;
+            FRotator oldRotation;
+            FVector oldScale;
             USceneComponent* rootComponentPtr = actorPtr->GetRootComponent();
-            if (rootComponentPtr == nullptr)
+            if (rootComponentPtr == nullptr || !GetServerTransform(propertiesPtr, oldLocation, oldRotation, oldScale))
             {
                 return;
             }
-            if (rootComponentPtr->RelativeLocation != oldLocation)
+            if (objPtr->IsLocked())
             {
-                if (objPtr->IsLocked())
+                if (rootComponentPtr->RelativeLocation != oldLocation)
                 {
                     actorPtr->SetActorRelativeLocation(oldLocation);
                 }
-                else
+                // If we're undoing an alt-drag, the rotation of the original actor won't have changed
+                if (isRotation && rootComponentPtr->RelativeRotation != oldRotation)
                 {
-                    propertiesPtr->Set(sfProp::Location, sfPropertyUtil::FromVector(rootComponentPtr->RelativeLocation));
+                    actorPtr->SetActorRelativeRotation(oldRotation);
                 }
             }
-            if (isRotation)
+            else
             {
-                FRotator oldRotation = sfPropertyUtil::ToRotator(propertiesPtr->Get(sfProp::Rotation));
-                // If we're undoing an alt-drag, the rotation of the original actor won't have changed
-                if (rootComponentPtr->RelativeRotation != oldRotation)
-                {
-                    if (objPtr->IsLocked())
-                    {
-                        actorPtr->SetActorRelativeRotation(oldRotation);
-                    }
-                    else
-                    {
-                        propertiesPtr->Set(sfProp::Rotation, sfPropertyUtil::FromRotator(rootComponentPtr->RelativeRotation));
-                    }
-                }
+                SendTransformUpdate(actorPtr, objPtr);
             }
         }
     }
@@ -1551,39 +2059,30 @@ void sfActorManager::OnUndoDelete(AActor* actorPtr)
     {
         return;
     }
-    bool inLevel = false;
     UWorld* worldPtr = GEditor->GetEditorWorldContext().World();
-    for (AActor* existActorPtr : actorPtr->GetLevel()->Actors)
+    // Undoing a bulk delete calls this for every actor, so the level is indexed once per transaction instead of
+    // searched once per actor.
+    TSharedPtr<sfLevelNameIndex>& nameIndexPtr = m_undoNameIndices.FindOrAdd(actorPtr->GetLevel());
+    if (!nameIndexPtr.IsValid())
     {
-        if (existActorPtr == nullptr)
-        {
-            continue;
-        }
-
-        if (existActorPtr == actorPtr)
-        {
-            inLevel = true;
-        }
-        else if (existActorPtr->GetFName() == actorPtr->GetFName())
-        {
-            // An actor with the same name already exists. Rename and delete the one that was just created. Although we
-            // will delete it, we still need to rename it because names of deleted actors are still in use.
-            sfActorUtil::Rename(actorPtr, actorPtr->GetName() + " (deleted)");
-            GEngine->OnLevelActorDeleted().Remove(m_onActorDeletedHandle);
-            worldPtr->EditorDestroyActor(actorPtr, true);
-            m_onActorDeletedHandle = GEngine->OnLevelActorDeleted().AddRaw(this,
-                &sfActorManager::OnActorDeleted);
-            return;
-        }
+        nameIndexPtr = MakeShareable(new sfLevelNameIndex(actorPtr->GetLevel()));
+    }
+    if (nameIndexPtr->FindOther(actorPtr) != nullptr)
+    {
+        // An actor with the same name already exists. Rename and delete the one that was just created. Although we
+        // will delete it, we still need to rename it because names of deleted actors are still in use.
+        nameIndexPtr->Remove(actorPtr);
+        sfActorUtil::Rename(actorPtr, actorPtr->GetName() + " (deleted)");
+        sfEventGuard::Scope guard(m_actorDeletedGuard);
+        worldPtr->EditorDestroyActor(actorPtr, true);
+        return;
     }
-    if (!inLevel)
+    if (!nameIndexPtr->Contains(actorPtr))
     {
         // The actor is not in the world. This means the actor was deleted by another user and should not be recreated,
         // so we delete it.
-        GEngine->OnLevelActorDeleted().Remove(m_onActorDeletedHandle);
+        sfEventGuard::Scope guard(m_actorDeletedGuard);
         worldPtr->EditorDestroyActor(actorPtr, true);
-        m_onActorDeletedHandle = GEngine->OnLevelActorDeleted().AddRaw(this,
-            &sfActorManager::OnActorDeleted);
         return;
     }
     // If the actor was locked when it was deleted, it will still have a lock component, so we need to unlock it.
@@ -1599,7 +2098,7 @@ void sfActorManager::OnUndoDetach(AActor* actorPtr)
     actorPtr->GetAttachedActors(children);
     for (AActor* childPtr : children)
     {
-        sfObject::SPtr childObjPtr = m_actorToObjectMap.FindRef(childPtr);
+        sfObject::SPtr childObjPtr = m_actorRegistry.FindObject(childPtr);
         if (childObjPtr != nullptr)
         {
             SyncParent(childPtr, childObjPtr);
@@ -1621,22 +2120,21 @@ void sfActorManager::OnRedoDetach(AActor* actorPtr, sfObject::SPtr objPtr)
     std::vector<TPair<sfObject::SPtr, AActor*>> toDetach;
     for (sfObject::SPtr childObjPtr : objPtr->Children())
     {
-        auto iter = m_objectToActorMap.find(childObjPtr);
-        if (iter != m_objectToActorMap.end() && iter->second->GetAttachParentActor() == nullptr)
+        AActor* childActorPtr = m_actorRegistry.FindActor(childObjPtr);
+        if (childActorPtr != nullptr && childActorPtr->GetAttachParentActor() == nullptr)
         {
             if (childObjPtr->IsLocked())
             {
-                GEngine->OnLevelActorAdded().Remove(m_onActorAttachedHandle);
-                iter->second->AttachToActor(actorPtr, FAttachmentTransformRules::KeepWorldTransform);
-                m_onActorAttachedHandle = GEngine->OnLevelActorAttached().AddRaw(this, &sfActorManager::OnAttachDetach);
+                sfEventGuard::Scope guard(m_attachDetachGuard);
+                childActorPtr->AttachToActor(actorPtr, FAttachmentTransformRules::KeepWorldTransform);
             }
             else
             {
-                toDetach.emplace_back(childObjPtr, iter->second);
+                toDetach.emplace_back(childObjPtr, childActorPtr);
             }
             // Detaching may change the folder, so we sync it.
             sfDictionaryProperty::SPtr propertiesPtr = childObjPtr->Property()->AsDict();
-            SyncFolder(iter->second, childObjPtr, propertiesPtr);
+            SyncFolder(childActorPtr, childObjPtr, propertiesPtr);
         }
     }
     for (TPair<sfObject::SPtr, AActor*> pair : toDetach)
@@ -1652,11 +2150,11 @@ void sfActorManager::SyncScale(AActor* actorPtr, sfObject::SPtr objPtr, sfDictio
     {
         if (objPtr->IsLocked())
         {
-            actorPtr->SetActorScale3D(sfPropertyUtil::ToVector(propertiesPtr->Get(sfProp::Scale)));
+            ApplyServerTransform(actorPtr, objPtr);
         }
         else
         {
-            propertiesPtr->Set(sfProp::Scale, sfPropertyUtil::FromVector(actorPtr->GetActorScale()));
+            SendTransformUpdate(actorPtr, objPtr);
         }
     }
 }
@@ -1670,16 +2168,30 @@ void sfActorManager::SyncLabelAndName(
     {
         if (objPtr->IsLocked())
         {
-            FCoreUObjectDelegates::OnObjectPropertyChanged.Remove(m_onPropertyChangeHandle);
-            actorPtr->SetActorLabel(sfPropertyUtil::ToString(propertiesPtr->Get(sfProp::Label)));
-            m_onPropertyChangeHandle =
-                FCoreUObjectDelegates::OnObjectPropertyChanged.AddRaw(this, &sfActorManager::OnUPropertyChange);
+            FString label = actorPtr->GetActorLabel();
+            if (label != sfPropertyUtil::ToString(m_propertyMergeManagerPtr->GetValue(objPtr, sfProp::Label)))
+            {
+                if (m_propertyMergeManagerPtr->IsMerged(sfProp::Label))
+                {
+                    m_propertyMergeManagerPtr->SetValue(objPtr, sfProp::Label,
+                        sfPropertyUtil::FromString(label, m_sessionPtr));
+                    m_lockBatch.OnMergedEdit();
+                }
+                else
+                {
+                    sfEventGuard::Scope guard(m_propertyChangeGuard);
+                    actorPtr->SetActorLabel(
+                        sfPropertyUtil::ToString(m_propertyMergeManagerPtr->GetValue(objPtr, sfProp::Label)));
+                }
+            }
+            // The name is not merged, so revert it even if the label was merged
             sfActorUtil::TryRename(actorPtr, sfPropertyUtil::ToString(propertiesPtr->Get(sfProp::Name)));
         }
         else
         {
             propertiesPtr->Set(sfProp::Label, sfPropertyUtil::FromString(actorPtr->GetActorLabel(),
                 m_sessionPtr));
+            m_propertyMergeManagerPtr->ClearValue(objPtr, sfProp::Label);
             FString name = actorPtr->GetName();
             if (sfPropertyUtil::ToString(propertiesPtr->Get(sfProp::Name)) != name)
             {
@@ -1693,17 +2205,23 @@ void sfActorManager::SyncFolder(AActor* actorPtr, sfObject::SPtr objPtr, sfDicti
 {
     if (propertiesPtr != nullptr)
     {
-        FString newFolder = actorPtr->GetFolderPath().ToString();
-        if (newFolder != sfPropertyUtil::ToString(propertiesPtr->Get(sfProp::Folder)))
+        FName newFolder = actorPtr->GetFolderPath();
+        if (newFolder != m_folderManagerPtr->ToPath(m_propertyMergeManagerPtr->GetValue(objPtr, sfProp::Folder)))
         {
-            if (objPtr->IsLocked())
+            if (!objPtr->IsLocked())
             {
-                // Setting folder during a transaction causes a crash, so we queue it to be done on the next tick
-                m_revertFolderQueue.Enqueue(actorPtr);
+                propertiesPtr->Set(sfProp::Folder, m_folderManagerPtr->FromPath(newFolder));
+                m_propertyMergeManagerPtr->ClearValue(objPtr, sfProp::Folder);
+            }
+            else if (m_propertyMergeManagerPtr->IsMerged(sfProp::Folder))
+            {
+                m_propertyMergeManagerPtr->SetValue(objPtr, sfProp::Folder, m_folderManagerPtr->FromPath(newFolder));
+                m_lockBatch.OnMergedEdit();
             }
             else
             {
-                propertiesPtr->Set(sfProp::Folder, sfPropertyUtil::FromString(newFolder, m_sessionPtr));
+                // Setting folder during a transaction causes a crash, so we queue it to be done on the next tick
+                m_revertFolderQueue.Enqueue(actorPtr);
             }
         }
     }
@@ -1719,7 +2237,7 @@ void sfActorManager::SyncParent(AActor* actorPtr, sfObject::SPtr objPtr)
     sfObject::SPtr parentPtr = nullptr;
     if (actorPtr->GetAttachParentActor() != nullptr)
     {
-        parentPtr = m_actorToObjectMap.FindRef(actorPtr->GetAttachParentActor());
+        parentPtr = m_actorRegistry.FindObject(actorPtr->GetAttachParentActor());
     }
     else
     {
@@ -1746,14 +2264,13 @@ void sfActorManager::SyncParent(AActor* actorPtr, sfObject::SPtr objPtr)
             return;
         }
 
-        auto iter = m_objectToActorMap.find(objPtr->Parent());
-        if (iter == m_objectToActorMap.end())
+        AActor* parentActorPtr = m_actorRegistry.FindActor(objPtr->Parent());
+        if (parentActorPtr == nullptr)
         {
             return;
         }
-        GEngine->OnLevelActorAdded().Remove(m_onActorAttachedHandle);
-        actorPtr->AttachToActor(iter->second, FAttachmentTransformRules::KeepRelativeTransform);
-        m_onActorAttachedHandle = GEngine->OnLevelActorAttached().AddRaw(this, &sfActorManager::OnAttachDetach);
+        sfEventGuard::Scope guard(m_attachDetachGuard);
+        actorPtr->AttachToActor(parentActorPtr, FAttachmentTransformRules::KeepRelativeTransform);
         ApplyServerTransform(actorPtr, objPtr);
     }
     else if (parentPtr == nullptr)
@@ -1770,6 +2287,10 @@ void sfActorManager::SyncParent(AActor* actorPtr, sfObject::SPtr objPtr)
 
 void sfActorManager::OnUPropertyChange(UObject* uobjPtr, FPropertyChangedEvent& ev)
 {
+    if (m_propertyChangeGuard.IsActive())
+    {
+        return;
+    }
     if (ev.MemberProperty == nullptr)
     {
         return;
@@ -1811,7 +2332,7 @@ void sfActorManager::SendPropertyChanges()
 
         for (UProperty* upropPtr : pair.Value)
         {
-            sfObject::SPtr objPtr = m_actorToObjectMap.FindRef(actorPtr);
+            sfObject::SPtr objPtr = m_actorRegistry.FindObject(actorPtr);
             if (objPtr == nullptr)
             {
                 continue;
@@ -1819,24 +2340,10 @@ void sfActorManager::SendPropertyChanges()
             FString path = upropPtr->GetName();
             sfDictionaryProperty::SPtr propertiesPtr = objPtr->Property()->AsDict();
 
-            USceneComponent* rootComponentPtr = actorPtr->GetRootComponent();
-            if (rootComponentPtr != nullptr)
+            if (path == "RelativeLocation" || path == "RelativeRotation" || path == "RelativeScale3D")
             {
-                if (path == "RelativeLocation")
-                {
-                    propertiesPtr->Set(sfProp::Location, sfPropertyUtil::FromVector(rootComponentPtr->RelativeLocation));
-                    continue;
-                }
-                if (path == "RelativeRotation")
-                {
-                    propertiesPtr->Set(sfProp::Rotation, sfPropertyUtil::FromRotator(rootComponentPtr->RelativeRotation));
-                    continue;
-                }
-                if (path == "RelativeScale3D")
-                {
-                    propertiesPtr->Set(sfProp::Scale, sfPropertyUtil::FromVector(actorPtr->GetActorRelativeScale3D()));
-                    continue;
-                }
+                SendTransformUpdate(actorPtr, objPtr);
+                continue;
             }
             if (path == "ActorLabel")
             {
@@ -1874,18 +2381,19 @@ void sfActorManager::SendPropertyChanges()
 
 void sfActorManager::OnPropertyChange(sfProperty::SPtr propertyPtr)
 {
-    auto actorIter = m_objectToActorMap.find(propertyPtr->GetContainerObject());
-    if (actorIter == m_objectToActorMap.end())
+    AActor* actorPtr = m_actorRegistry.FindActor(propertyPtr->GetContainerObject());
+    if (actorPtr == nullptr)
     {
         return;
     }
-    AActor* actorPtr = actorIter->second;
 
     if (propertyPtr->GetDepth() == 1)
     {
         auto handlerIter = m_propertyChangeHandlers.find(propertyPtr->Key());
         if (handlerIter != m_propertyChangeHandlers.end())
         {
+            // Transform changes from the server should not be sent back
+            sfEventGuard::Scope guard(m_transformGuard);
             sfUtils::PreserveUndoStack([handlerIter, actorPtr, propertyPtr]()
             {
                 handlerIter->second(actorPtr, propertyPtr);
@@ -1918,12 +2426,11 @@ void sfActorManager::OnPropertyChange(sfProperty::SPtr propertyPtr)
 
 void sfActorManager::OnRemoveField(sfDictionaryProperty::SPtr dictPtr, const sfName& name)
 {
-    auto iter = m_objectToActorMap.find(dictPtr->GetContainerObject());
-    if (iter == m_objectToActorMap.end())
+    AActor* actorPtr = m_actorRegistry.FindActor(dictPtr->GetContainerObject());
+    if (actorPtr == nullptr)
     {
         return;
     }
-    AActor* actorPtr = iter->second;
 
     UProperty* upropPtr = actorPtr->GetClass()->FindPropertyByName(FName(UTF8_TO_TCHAR(name->c_str())));
     if (upropPtr != nullptr)
@@ -1932,14 +2439,64 @@ void sfActorManager::OnRemoveField(sfDictionaryProperty::SPtr dictPtr, const sfN
     }
 }
 
+void sfActorManager::OnMergedValueChange(sfObject::SPtr objPtr, const sfName& name)
+{
+    AActor* actorPtr = m_actorRegistry.FindActor(objPtr);
+    auto handlerIter = m_propertyChangeHandlers.find(name);
+    if (actorPtr == nullptr || handlerIter == m_propertyChangeHandlers.end())
+    {
+        return;
+    }
+    // If we hold the lock, apply the merged value to the actor's object and clear it. Otherwise edits we made before
+    // receiving it would stay overridden by it, since we only clear merged values when we edit the property.
+    sfUser::SPtr lockOwnerPtr = objPtr->LockOwner();
+    sfProperty::SPtr mergedPtr = m_propertyMergeManagerPtr->GetMergedValue(objPtr, name);
+    if (mergedPtr != nullptr && lockOwnerPtr != nullptr && lockOwnerPtr->Id() == m_sessionPtr->LocalUserId())
+    {
+        objPtr->Property()->AsDict()->Set(name, mergedPtr->Clone());
+        m_propertyMergeManagerPtr->ClearValue(objPtr, name);
+    }
+    sfProperty::SPtr propertyPtr = objPtr->Property()->AsDict()->Get(name);
+    if (propertyPtr == nullptr)
+    {
+        return;
+    }
+    sfUtils::PreserveUndoStack([handlerIter, actorPtr, propertyPtr]()
+    {
+        handlerIter->second(actorPtr, propertyPtr);
+    });
+}
+
+void sfActorManager::OnAssetIdResolved(sfObject::SPtr objPtr)
+{
+    AActor* actorPtr = m_actorRegistry.FindActor(objPtr);
+    if (actorPtr == nullptr)
+    {
+        // Actors whose parent actor hasn't spawned yet are spawned with their parent. Others are queued so a burst of
+        // resolved ids is spawned within the spawn budget.
+        sfObject::SPtr parentPtr = objPtr->Parent();
+        if (parentPtr != nullptr && (parentPtr->Parent() == nullptr || m_actorRegistry.Contains(parentPtr)))
+        {
+            QueueSpawn(objPtr);
+        }
+        return;
+    }
+    sfDictionaryProperty::SPtr propertiesPtr = objPtr->Property()->AsDict();
+    sfUtils::PreserveUndoStack([this, actorPtr, propertiesPtr]()
+    {
+        ApplyStaticMeshProperties(actorPtr, propertiesPtr) ||
+            ApplySkeletalMeshProperties(actorPtr, propertiesPtr) ||
+            ApplyEmitterProperties(actorPtr, propertiesPtr);
+    });
+}
+
 void sfActorManager::OnListAdd(sfListProperty::SPtr listPtr, int index, int count)
 {
-    auto iter = m_objectToActorMap.find(listPtr->GetContainerObject());
-    if (iter == m_objectToActorMap.end())
+    AActor* actorPtr = m_actorRegistry.FindActor(listPtr->GetContainerObject());
+    if (actorPtr == nullptr)
     {
         return;
     }
-    AActor* actorPtr = iter->second;
     sfUPropertyInstance uprop = sfPropertyUtil::FindUProperty(actorPtr, listPtr);
     if (!uprop.IsValid())
     {
@@ -2047,12 +2604,11 @@ bool sfActorManager::MapInsert(const sfUPropertyInstance& uprop, sfListProperty:
 
 void sfActorManager::OnListRemove(sfListProperty::SPtr listPtr, int index, int count)
 {
-    auto iter = m_objectToActorMap.find(listPtr->GetContainerObject());
-    if (iter == m_objectToActorMap.end())
+    AActor* actorPtr = m_actorRegistry.FindActor(listPtr->GetContainerObject());
+    if (actorPtr == nullptr)
     {
         return;
     }
-    AActor* actorPtr = iter->second;
     sfUPropertyInstance uprop = sfPropertyUtil::FindUProperty(actorPtr, listPtr);
     if (!uprop.IsValid())
     {
@@ -2123,85 +2679,58 @@ bool sfActorManager::MapRemove(const sfUPropertyInstance& uprop, int index, int
 
 void sfActorManager::RegisterPropertyChangeHandlers()
 {
-    m_propertyChangeHandlers[sfProp::Location] =
-        [this](AActor* actorPtr, sfProperty::SPtr propertyPtr)
+    // Transform properties often change together, so changes are applied once per actor in the next tick.
+    PropertyChangeHandler transformHandler = [this](AActor* actorPtr, sfProperty::SPtr propertyPtr)
     {
-        actorPtr->SetActorRelativeLocation(sfPropertyUtil::ToVector(propertyPtr));
-        actorPtr->InvalidateLightingCache();
-        SceneFusion::RedrawActiveViewport();
-        if (actorPtr->IsA<ABrush>())
-        {
-            ABrush::SetNeedRebuild(actorPtr->GetLevel());
-            m_bspRebuildDelay = BSP_REBUILD_DELAY;
-        }
-    };
-    m_propertyChangeHandlers[sfProp::Rotation] =
-        [this](AActor* actorPtr, sfProperty::SPtr propertyPtr)
-    {
-        actorPtr->SetActorRelativeRotation(sfPropertyUtil::ToRotator(propertyPtr));
-        actorPtr->InvalidateLightingCache();
-        SceneFusion::RedrawActiveViewport();
-        if (actorPtr->IsA<ABrush>())
-        {
-            ABrush::SetNeedRebuild(actorPtr->GetLevel());
-            m_bspRebuildDelay = BSP_REBUILD_DELAY;
-        }
-    };
-    m_propertyChangeHandlers[sfProp::Scale] =
-        [this](AActor* actorPtr, sfProperty::SPtr propertyPtr)
-    {
-        actorPtr->SetActorRelativeScale3D(sfPropertyUtil::ToVector(propertyPtr));
-        actorPtr->InvalidateLightingCache();
-        SceneFusion::RedrawActiveViewport();
-        if (actorPtr->IsA<ABrush>())
-        {
-            ABrush::SetNeedRebuild(actorPtr->GetLevel());
-            m_bspRebuildDelay = BSP_REBUILD_DELAY;
-        }
+        m_serverTransformChanges.Add(actorPtr);
     };
+    m_propertyChangeHandlers[sfProp::Location] = transformHandler;
+    m_propertyChangeHandlers[sfProp::Rotation] = transformHandler;
+    m_propertyChangeHandlers[sfProp::Scale] = transformHandler;
+    m_propertyChangeHandlers[sfProp::Transform] = transformHandler;
     m_propertyChangeHandlers[sfProp::Name] = 
         [this](AActor* actorPtr, sfProperty::SPtr propertyPtr)
     {
         sfActorUtil::TryRename(actorPtr, sfPropertyUtil::ToString(propertyPtr));
     };
+    // Merged values override the values on actor objects, so label and folder handlers apply the merged value if
+    // there is one. They are also called when merged values change.
     m_propertyChangeHandlers[sfProp::Label] =
         [this](AActor* actorPtr, sfProperty::SPtr propertyPtr)
     {
-        FCoreUObjectDelegates::OnObjectPropertyChanged.Remove(m_onPropertyChangeHandle);
-        actorPtr->SetActorLabel(sfPropertyUtil::ToString(propertyPtr));
-        m_onPropertyChangeHandle =
-            FCoreUObjectDelegates::OnObjectPropertyChanged.AddRaw(this, &sfActorManager::OnUPropertyChange);
+        sfEventGuard::Scope guard(m_propertyChangeGuard);
+        actorPtr->SetActorLabel(sfPropertyUtil::ToString(
+            m_propertyMergeManagerPtr->GetValue(propertyPtr->GetContainerObject(), sfProp::Label)));
     };
     m_propertyChangeHandlers[sfProp::Folder] = 
         [this](AActor* actorPtr, sfProperty::SPtr propertyPtr)
     {
-        m_foldersToCheck.AddUnique(actorPtr->GetFolderPath().ToString());
-        GEngine->OnLevelActorFolderChanged().Remove(m_onFolderChangeHandle);
-        actorPtr->SetFolderPath(FName(*sfPropertyUtil::ToString(propertyPtr)));
-        m_onFolderChangeHandle = GEngine->OnLevelActorFolderChanged().AddRaw(this, &sfActorManager::OnFolderChange);
+        // Sessions with folder objects delete folders when their objects are deleted
+        if (!m_folderManagerPtr->IsSyncingFolders())
+        {
+            m_foldersToCheck.AddUnique(actorPtr->GetFolderPath().ToString());
+        }
+        sfEventGuard::Scope guard(m_folderChangeGuard);
+        actorPtr->SetFolderPath(m_folderManagerPtr->ToPath(
+            m_propertyMergeManagerPtr->GetValue(propertyPtr->GetContainerObject(), sfProp::Folder)));
     };
 }
 
 void sfActorManager::OnUserColorChange(sfUser::SPtr userPtr)
 {
-    UMaterialInstanceDynamic** materialPtrPtr = m_lockMaterials.Find(userPtr->Id());
-    if (materialPtrPtr == nullptr)
-    {
-        return;
-    }
-    UMaterialInstanceDynamic* materialPtr = *materialPtrPtr;
-    ksColor color = userPtr->Color();
-    FLinearColor ucolor(color.R(), color.G(), color.B());
-    materialPtr->SetVectorParameterValue("Color", ucolor);
+    m_lockRenderer.OnUserColorChange(userPtr);
 }
 
 void sfActorManager::OnUserLeave(sfUser::SPtr userPtr)
 {
-    UMaterialInstanceDynamic* materialPtr;
-    if (m_lockMaterials.RemoveAndCopyValue(userPtr->Id(), materialPtr))
+    TArray<AActor*> actors;
+    m_lockIndex.GetActors(userPtr, actors);
+    Unlock(actors);
+    for (AActor* actorPtr : actors)
     {
-        materialPtr->ClearFlags(EObjectFlags::RF_Standalone);// Allow unreal to destroy the material instance
+        OnLockStateChange.ExecuteIfBound(actorPtr, Unlocked, nullptr);
     }
+    m_lockRenderer.OnUserLeave(userPtr);
 }
 
 bool sfActorManager::CanEdit(const TArray<TWeakObjectPtr<UObject>>& objects)
@@ -2253,40 +2782,184 @@ void sfActorManager::InvokeOnLockStateChange(sfObject::SPtr objPtr, AActor* acto
 
 void sfActorManager::OnRemoveLevel(ULevel* levelPtr)
 {
+    m_pruneMergedValues = true;
     for (auto actorIter = levelPtr->Actors.CreateConstIterator(); actorIter; actorIter++)
     {
-        sfObject::SPtr objPtr;
-        if (m_actorToObjectMap.RemoveAndCopyValue(*actorIter, objPtr))
+        m_folderIndex.Remove(*actorIter);
+        m_lockIndex.Remove(*actorIter);
+        sfObject::SPtr objPtr = m_actorRegistry.RemoveActor(*actorIter);
+        if (objPtr != nullptr)
         {
             objPtr->ReleaseLock();
-            m_objectToActorMap.erase(objPtr);
+            UnwatchTransform(*actorIter);
             m_selectedActors.erase(*actorIter);
+            m_selectionChanges.Remove(*actorIter);
             m_uploadList.Remove(*actorIter);
         }
     }
+    m_levelBlueprintLoads.Remove(levelPtr);
+    m_deferredLevelCleanups.Remove(levelPtr);
+    // Requests for resolved asset ids can be queued for levels without a spawn count, so we always check the queue
+    m_levelSpawnCounts.Remove(levelPtr);
+    m_spawnQueue.RemoveAll([this, levelPtr](const SpawnRequest& request)
+    {
+        if (request.LevelPtr != levelPtr)
+        {
+            return false;
+        }
+        m_assetLoader.ReleasePrefetch(request.PrefetchId);
+        return true;
+    });
 }
 
 void sfActorManager::OnSFLevelObjectCreate(sfObject::SPtr sfLevelObjPtr, ULevel* levelPtr)
 {
+    // Loading a level doesn't fire actor added events, so we add its actors to the folder index here
+    for (AActor* actorPtr : levelPtr->Actors)
+    {
+        if (actorPtr != nullptr)
+        {
+            m_folderIndex.Update(actorPtr);
+        }
+    }
+    if (sfLevelObjPtr->Children().size() == 0)
+    {
+        DestroyUnsyncedActorsInLevel(levelPtr);
+        return;
+    }
+    // Spawning every actor at once can freeze the editor for a long time in large levels, so we queue them to be
+    // spawned over several ticks.
+    int firstIndex = m_spawnQueue.Num();
+    TSet<FString> assetPaths;
+    TSet<FString> childAssetPaths;
     for (sfObject::SPtr childPtr : sfLevelObjPtr->Children())
     {
-        OnCreate(childPtr, 0); // Child index does not matter
+        childAssetPaths.Reset();
+        auto iter = childPtr->SelfAndDescendants();
+        while (iter.Value() != nullptr)
+        {
+            GetAssetPaths(iter.Value(), childAssetPaths);
+            iter.Next();
+        }
+        SpawnRequest request;
+        request.ObjPtr = childPtr;
+        request.LevelPtr = levelPtr;
+        request.DistanceSquared = 0.0f;
+        for (const FString& path : childAssetPaths)
+        {
+            if (!path.IsEmpty())
+            {
+                request.AssetPaths.Add(FSoftObjectPath(path));
+            }
+        }
+        assetPaths.Append(childAssetPaths);
+        m_spawnQueue.Add(request);
+    }
+    // Start loading all the assets the level uses so they are loaded by the time we spawn the actors. The assets are
+    // kept loaded until the actors using them are spawned.
+    uint32_t prefetchId = m_assetLoader.Prefetch(assetPaths, m_spawnQueue.Num() - firstIndex);
+    for (int i = firstIndex; i < m_spawnQueue.Num(); i++)
+    {
+        m_spawnQueue[i].PrefetchId = prefetchId;
+    }
+    m_levelSpawnCounts.FindOrAdd(levelPtr) += sfLevelObjPtr->Children().size();
+    m_spawnQueueSorted = false;
+}
+
+void sfActorManager::QueueSpawn(sfObject::SPtr objPtr)
+{
+    sfObject::SPtr levelObjPtr = objPtr->Parent();
+    while (levelObjPtr->Parent() != nullptr)
+    {
+        levelObjPtr = levelObjPtr->Parent();
+    }
+    ULevel* levelPtr = m_levelManagerPtr->FindLevelByObject(levelObjPtr);
+    if (levelPtr == nullptr)
+    {
+        levelPtr = GEditor->GetEditorWorldContext().World()->PersistentLevel;
+    }
+    SpawnRequest request;
+    request.ObjPtr = objPtr;
+    request.LevelPtr = levelPtr;
+    request.DistanceSquared = 0.0f;
+    // Not part of a level prefetch, but we still wait for assets that are loading
+    request.PrefetchId = 0;
+    TSet<FString> assetPaths;
+    auto iter = objPtr->SelfAndDescendants();
+    while (iter.Value() != nullptr)
+    {
+        GetAssetPaths(iter.Value(), assetPaths);
+        iter.Next();
+    }
+    for (const FString& path : assetPaths)
+    {
+        if (!path.IsEmpty())
+        {
+            request.AssetPaths.Add(FSoftObjectPath(path));
+        }
+    }
+    m_spawnQueue.Add(request);
+    m_spawnQueueSorted = false;
+    // If the level's actors are still being spawned, count the request so spawning it doesn't end the level's spawns
+    // early
+    int* countPtr = m_levelSpawnCounts.Find(levelPtr);
+    if (countPtr != nullptr)
+    {
+        (*countPtr)++;
+    }
+}
+
+void sfActorManager::GetAssetPaths(sfObject::SPtr objPtr, TSet<FString>& paths)
+{
+    sfDictionaryProperty::SPtr propertiesPtr = objPtr->Property()->AsDict();
+    sfProperty::SPtr propPtr;
+    if (propertiesPtr->TryGet(sfProp::Class, propPtr))
+    {
+        FString className = m_assetDictionaryPtr->ToPath(propPtr);
+        // If it contains a '/' it's a blueprint path. Otherwise it's a native class that is always loaded.
+        if (className.Contains("/"))
+        {
+            paths.Add(className);
+        }
+    }
+    if (propertiesPtr->TryGet(sfProp::Mesh, propPtr))
+    {
+        paths.Add(m_assetDictionaryPtr->ToPath(propPtr));
+    }
+    if (propertiesPtr->TryGet(sfProp::Materials, propPtr))
+    {
+        for (sfProperty::SPtr materialPtr : *propPtr->AsList())
+        {
+            paths.Add(m_assetDictionaryPtr->ToPath(materialPtr));
+        }
+    }
+    if (propertiesPtr->TryGet(sfProp::Template, propPtr))
+    {
+        paths.Add(m_assetDictionaryPtr->ToPath(propPtr));
     }
-    DestroyUnsyncedActorsInLevel(levelPtr);
 }
 
 int sfActorManager::NumSyncedActors()
 {
-    return m_actorToObjectMap.Num();
+    return m_actorRegistry.Num();
+}
+
+int sfActorManager::NumPendingUploads()
+{
+    return m_uploadList.Num();
+}
+
+int sfActorManager::NumPendingSpawns()
+{
+    return m_spawnQueue.Num();
 }
 
 bool sfActorManager::DetachIfParentIsLevel(sfObject::SPtr objPtr, AActor* actorPtr)
 {
     if (objPtr->Parent()->Type() == sfType::Level)
     {
-        GEngine->OnLevelActorDetached().Remove(m_onActorDetachedHandle);
+        sfEventGuard::Scope guard(m_attachDetachGuard);
         actorPtr->DetachFromActor(FDetachmentTransformRules::KeepRelativeTransform);
-        m_onActorDetachedHandle = GEngine->OnLevelActorDetached().AddRaw(this, &sfActorManager::OnAttachDetach);
         return true;
     }
     return false;
@@ -12,7 +12,19 @@
 
 #include "IObjectManager.h"
 #include "../sfUPropertyInstance.h"
+#include "../sfAssetLoader.h"
+#include "../sfSendRateController.h"
+#include "../sfActorRegistry.h"
+#include "../sfEventGuard.h"
+#include "../sfFolderIndex.h"
+#include "../sfLevelNameIndex.h"
+#include "../sfLockBatch.h"
+#include "../sfLockIndex.h"
+#include "../sfLockRenderer.h"
 #include "sfLevelManager.h"
+#include "sfAssetDictionaryManager.h"
+#include "sfFolderManager.h"
+#include "sfPropertyMergeManager.h"
 
 using namespace KS::SceneFusion2;
 using namespace KS;
@@ -54,8 +66,15 @@ public:
      * Constructor
      *
      * @param   TSharedPtr<sfLevelManager> levelManagerPtr
+     * @param   TSharedPtr<sfAssetDictionaryManager> assetDictionaryPtr
+     * @param   TSharedPtr<sfFolderManager> folderManagerPtr
+     * @param   TSharedPtr<sfPropertyMergeManager> propertyMergeManagerPtr
      */
-    sfActorManager(TSharedPtr<sfLevelManager> levelManagerPtr);
+    sfActorManager(
+        TSharedPtr<sfLevelManager> levelManagerPtr,
+        TSharedPtr<sfAssetDictionaryManager> assetDictionaryPtr,
+        TSharedPtr<sfFolderManager> folderManagerPtr,
+        TSharedPtr<sfPropertyMergeManager> propertyMergeManagerPtr);
 
     /**
      * Destructor
@@ -107,6 +126,16 @@ public:
      * @return   int - number of synced actors.
      */
     int NumSyncedActors();
+
+    /**
+     * @return  int - number of actors waiting to be uploaded.
+     */
+    int NumPendingUploads();
+
+    /**
+     * @return  int - number of objects received from the server whose actors have not been spawned yet.
+     */
+    int NumPendingSpawns();
     
     /**
      * Get the sfObject for the given actor. If the actor is not synced, return nullptr.
@@ -139,6 +168,33 @@ private:
         MoveToLevel // Move actor to another level
     };
 
+    /**
+     * Objects waiting to be created under the same parent.
+     */
+    struct UploadBatch
+    {
+    public:
+        std::list<sfObject::SPtr> Objects;
+        // Number of objects in the batch including descendants
+        int Size = 0;
+    };
+
+    /**
+     * An object received when joining a session whose actor is waiting to be spawned.
+     */
+    struct SpawnRequest
+    {
+    public:
+        sfObject::SPtr ObjPtr;
+        ULevel* LevelPtr;
+        // Squared distance to the camera when the queue was last sorted
+        float DistanceSquared;
+        // Id of the prefetch loading the assets of the level the object is in
+        uint32_t PrefetchId;
+        // Assets used by the object and its descendants that may still be loading
+        TArray<FSoftObjectPath> AssetPaths;
+    };
+
     FDelegateHandle m_onActorAddedHandle;
     FDelegateHandle m_onActorDeletedHandle;
     FDelegateHandle m_onActorAttachedHandle;
@@ -146,47 +202,152 @@ private:
     FDelegateHandle m_onFolderChangeHandle;
     FDelegateHandle m_onMoveStartHandle;
     FDelegateHandle m_onMoveEndHandle;
+    FDelegateHandle m_onSelectObjectHandle;
+    FDelegateHandle m_onSelectionChangedHandle;
     FDelegateHandle m_onUndoHandle;
     FDelegateHandle m_onRedoHandle;
     FDelegateHandle m_beforeUndoRedoHandle;
     FDelegateHandle m_onPropertyChangeHandle;
     ksEvent<sfUser::SPtr&>::SPtr m_onUserColorChangeEventPtr;
     ksEvent<sfUser::SPtr&>::SPtr m_onUserLeaveEventPtr;
-
-    TMap<AActor*, sfObject::SPtr> m_actorToObjectMap;
-    std::map<sfObject::SPtr, AActor*> m_objectToActorMap;
-    TMap<uint32_t, UMaterialInstanceDynamic*> m_lockMaterials;
+    // Guards that suppress editor event handlers while we apply server changes
+    sfEventGuard m_actorAddedGuard;
+    sfEventGuard m_actorDeletedGuard;
+    sfEventGuard m_attachDetachGuard;
+    sfEventGuard m_folderChangeGuard;
+    sfEventGuard m_propertyChangeGuard;
+    sfEventGuard m_transformGuard;
+
+    sfActorRegistry m_actorRegistry;
+    sfLockRenderer m_lockRenderer;
+    // Locked actors grouped by lock owner
+    sfLockIndex m_lockIndex;
+    // Lock requests and releases for selection changes
+    sfLockBatch m_lockBatch;
+    // Objects with lock events received since lock changes were last applied
+    std::unordered_set<sfObject::SPtr> m_lockChanges;
+    int m_numLockEvents;
     TMap<FScriptMap*, TSharedPtr<FScriptMapHelper>> m_staleMaps;
     TMap<FScriptSet*, TSharedPtr<FScriptSetHelper>> m_staleSets;
     TArray<AActor*> m_uploadList;
+    // Sorted farthest from the camera first so the closest request is at the end
+    TArray<SpawnRequest> m_spawnQueue;
+    // Number of spawn requests left for each level
+    TMap<ULevel*, int> m_levelSpawnCounts;
+    // Number of blueprints loading for each level to create actors with
+    TMap<ULevel*, int> m_levelBlueprintLoads;
+    // Levels whose unsynced actors are destroyed once their blueprints finish loading
+    TSet<ULevel*> m_deferredLevelCleanups;
+    FVector m_spawnSortLocation;
+    bool m_spawnQueueSorted;
     TMap<AActor*, std::unordered_set<UProperty*>> m_propertyChangeMap;
     TQueue<sfObject::SPtr> m_recreateQueue;
     TQueue<AActor*> m_syncLabelQueue;
     TQueue<AActor*> m_revertFolderQueue;
     TArray<AActor*> m_syncParentList;
+    TArray<AActor*> m_syncFolderList;
     TArray<FString> m_foldersToCheck;
+    sfFolderIndex m_folderIndex;
     TArray<USceneComponent*> m_childrenToCheck;
     TArray<USceneComponent*> m_parentsToCheck;
     TArray<AActor*> m_destroyedActorsToCheck;
+    // Name indices for levels with actors in the undo or redo transaction being processed
+    TMap<ULevel*, TSharedPtr<sfLevelNameIndex>> m_undoNameIndices;
     TMap<FString, UndoType> m_undoTypes;
-    // Use std map because TSortedMap causes compile errors in Unreal's code
-    std::map<AActor*, sfObject::SPtr> m_selectedActors;
+    std::unordered_map<AActor*, sfObject::SPtr> m_selectedActors;
+    // Actors whose selection state changed since the last selection update
+    TSet<AActor*> m_selectionChanges;
+    bool m_selectionScanNeeded;
+    // True if a selection changed event was fired since the last selection update
+    bool m_selectionChangedEvent;
+    float m_selectionScanTimer;
+    int m_selectionCount;
     std::unordered_map<sfName, PropertyChangeHandler> m_propertyChangeHandlers;
     sfSession::SPtr m_sessionPtr;
-    UMaterialInterface* m_lockMaterialPtr;
     UTransBuffer* m_undoBufferPtr;
     bool m_movingActors;
     float m_bspRebuildDelay;
+    // True if actor objects were deleted since merged values for deleted actors were last removed
+    bool m_pruneMergedValues;
 
     TSharedPtr<sfLevelManager> m_levelManagerPtr;
+    TSharedPtr<sfAssetDictionaryManager> m_assetDictionaryPtr;
+    TSharedPtr<sfFolderManager> m_folderManagerPtr;
+    TSharedPtr<sfPropertyMergeManager> m_propertyMergeManagerPtr;
+    sfAssetLoader m_assetLoader;
+    sfSendRateController m_sendRateController;
+    // Last transforms sent for actors in the current drag
+    TMap<AActor*, FTransform> m_dragSentTransforms;
+    // Root component transform-updated event handles for synced actors
+    TMap<AActor*, TPair<TWeakObjectPtr<USceneComponent>, FDelegateHandle>> m_transformHandles;
+    // Actors whose transforms changed since transforms were last sent
+    TSet<AActor*> m_dirtyTransforms;
+    // Actors whose transforms changed while we were waiting for their locks. Sent when the lock is granted.
+    TSet<AActor*> m_pendingLockEdits;
+    // Actors whose server transform changed since server transforms were last applied
+    TSet<AActor*> m_serverTransformChanges;
+
+    /**
+     * Applies selection changes by requesting locks on newly selected objects and unlocking unselected objects.
+     *
+     * @param   float deltaTime in seconds since the last update.
+     */
+    void UpdateSelection(float deltaTime);
 
     /**
-     * Checks for selection changes and requests locks on newly selected objects and unlocks unselected objects.
+     * Checks every selected and previously selected actor for selection changes. Used when we don't know which
+     * actors changed.
      */
-    void UpdateSelection();
+    void ScanSelection();
 
     /**
-     * Destroys actors that don't exist on the server in the given level.
+     * Requests or releases the lock for an actor if its selection state changed.
+     *
+     * @param   AActor* actorPtr
+     */
+    void UpdateSelectionState(AActor* actorPtr);
+
+    /**
+     * Called when an object is selected or deselected. Records the change to apply in the next selection update.
+     *
+     * @param   UObject* uobjPtr that was selected or deselected.
+     */
+    void OnSelectObject(UObject* uobjPtr);
+
+    /**
+     * Called after a selection set changes. Batch changes such as deselecting everything don't fire events for
+     * individual objects, so the next selection update scans the whole selection.
+     *
+     * @param   UObject* selectionPtr that changed.
+     */
+    void OnSelectionChanged(UObject* selectionPtr);
+
+    /**
+     * Spawns actors for queued objects until the spawn time budget from the config is used up, starting with the
+     * objects closest to the camera. Objects whose assets are still being prefetched stay in the queue. Destroys
+     * unsynced actors in a level once all of its queued objects are spawned.
+     */
+    void SpawnQueuedActors();
+
+    /**
+     * Checks if the assets for a spawn request have loaded. Removes loaded assets from the request so they are not
+     * checked again.
+     *
+     * @param   SpawnRequest& request to check.
+     * @return  bool true if none of the request's assets are loading.
+     */
+    bool AreAssetsLoaded(SpawnRequest& request);
+
+    /**
+     * Sorts the spawn queue by distance to a location, farthest first.
+     *
+     * @param   const FVector& location to sort by.
+     */
+    void SortSpawnQueue(const FVector& location);
+
+    /**
+     * Destroys actors that don't exist on the server in the given level. If blueprints are loading to create actors
+     * in the level, waits until they finish, since the actors created from them may match actors in the level.
      *
      * @param   ULevel* levelPtr - level to check
      */
@@ -459,7 +620,8 @@ private:
     void SyncScale(AActor* actorPtr, sfObject::SPtr objPtr, sfDictionaryProperty::SPtr propertiesPtr);
 
     /**
-     * Sends new label and name values to the server, or reverts to the server values if the actor is locked.
+     * Sends new label and name values to the server, or reverts to the server values if the actor is locked. If label
+     * edits are merged, a new label on a locked actor is sent as a merged value.
      *
      * @param   AActor* actorPtr to sync label and name for.
      * @param   sfObject::SPtr objPtr for the actor.
@@ -468,7 +630,8 @@ private:
     void SyncLabelAndName(AActor* actorPtr, sfObject::SPtr objPtr, sfDictionaryProperty::SPtr propertiesPtr);
 
     /**
-     * Sends a new folder value to the server, or reverts to the server value if the actor is locked.
+     * Sends a new folder value to the server, or reverts to the server value if the actor is locked. If folder edits
+     * are merged, a new folder on a locked actor is sent as a merged value.
      *
      * @param   AActor* actorPtr to sync folder for.
      * @param   sfObject::SPtr objPtr for the actor.
@@ -485,11 +648,24 @@ private:
     void SyncParent(AActor* actorPtr, sfObject::SPtr objPtr);
 
     /**
-     * Creates actor objects on the server.
+     * Creates actor objects on the server for actors in the upload list. Stops when the per-tick time or byte budget
+     * from the config is used up and leaves the remaining actors in the list for the next tick. Create requests are
+     * capped at the configured batch size.
+     */
+    void UploadActors();
+
+    /**
+     * Sends a create request for a batch of objects and moves the objects from the batch into the created objects
+     * list.
      *
-     * @param   const TArray<AActor*>& actors to upload.
+     * @param   UploadBatch& batch to send. Empty after the request is sent.
+     * @param   sfObject::SPtr parentPtr to create the objects under.
+     * @param   std::list<sfObject::SPtr>& createdObjects to add the sent objects to.
      */
-    void UploadActors(const TArray<AActor*>& actors);
+    void SendCreateBatch(
+        UploadBatch& batch,
+        sfObject::SPtr parentPtr,
+        std::list<sfObject::SPtr>& createdObjects);
 
     /**
      * Recursively creates actor objects for an actor and its children.
@@ -553,6 +729,25 @@ private:
      */
     bool ApplySkeletalMeshProperties(AActor* actorPtr, sfDictionaryProperty::SPtr propertiesPtr);
 
+    /**
+     * Creates a property for a mesh component's materials. Slots without an override material are stored as empty
+     * paths so only materials that differ from the mesh defaults are referenced.
+     *
+     * @param   UMeshComponent* componentPtr to create materials property for.
+     * @return  sfListProperty::SPtr
+     */
+    sfListProperty::SPtr CreateMaterialsProperty(UMeshComponent* componentPtr);
+
+    /**
+     * Applies materials to a mesh component. Materials that are not loaded are loaded asynchronously and applied
+     * when they finish loading.
+     *
+     * @param   UMeshComponent* componentPtr to apply materials to.
+     * @param   sfListProperty::SPtr materialsPtr with material paths.
+     * @param   const FString& meshPath for logging.
+     */
+    void ApplyMaterials(UMeshComponent* componentPtr, sfListProperty::SPtr materialsPtr, const FString& meshPath);
+
     /**
      * Creates a property for syncing an emitter's template.
      *
@@ -572,13 +767,69 @@ private:
     bool ApplyEmitterProperties(AActor* actorPtr, sfDictionaryProperty::SPtr propertiesPtr);
 
     /**
-     * Checks for and sends transform changes for an actor to the server.
+     * Checks for and sends transform changes for an actor to the server. If transforms are packed and we are not
+     * dragging, applies the quantized transform to the actor.
      *
      * @param   AActor* actorPtr to send transform update for.
      * @param   sfObject::SPtr objPtr for the actor.
      */
     void SendTransformUpdate(AActor* actorPtr, sfObject::SPtr objPtr);
 
+    /**
+     * Listens for transform changes on an actor's root component.
+     *
+     * @param   AActor* actorPtr to listen to.
+     */
+    void WatchTransform(AActor* actorPtr);
+
+    /**
+     * Stops listening for transform changes on an actor and discards its unsent and unapplied transform changes.
+     *
+     * @param   AActor* actorPtr to stop listening to.
+     */
+    void UnwatchTransform(AActor* actorPtr);
+
+    /**
+     * Called when a watched root component's transform changes. Records the actor as moved unless we are applying a
+     * server transform.
+     *
+     * @param   USceneComponent* componentPtr whose transform changed.
+     * @param   EUpdateTransformFlags flags
+     * @param   ETeleportType teleport
+     */
+    void OnTransformUpdated(USceneComponent* componentPtr, EUpdateTransformFlags flags, ETeleportType teleport);
+
+    /**
+     * Sends transform updates for actors that moved, or reverts them to their server transforms if they are locked.
+     * While dragging, updates are sent at a limited rate.
+     */
+    void SendDirtyTransforms();
+
+    /**
+     * If optimistic locks are enabled and we are waiting for an object's lock, buffers the actor's transform change
+     * until the lock is granted.
+     *
+     * @param   AActor* actorPtr whose transform changed.
+     * @param   sfObject::SPtr objPtr for the actor.
+     * @return  bool true if the change was buffered.
+     */
+    bool BufferIfLockPending(AActor* actorPtr, sfObject::SPtr objPtr);
+
+    /**
+     * Queues buffered transform changes to send for actors whose locks were granted, and reverts actors that another
+     * user locked first to their server transforms.
+     */
+    void ResolvePendingLockEdits();
+
+    /**
+     * Sends a transform update for an actor during a drag if it moved, rotated or scaled more than the minimum
+     * amounts from the config since the last update sent during the drag.
+     *
+     * @param   AActor* actorPtr to send transform update for.
+     * @param   sfObject::SPtr objPtr for the actor.
+     */
+    void SendDragTransformUpdate(AActor* actorPtr, sfObject::SPtr objPtr);
+
     /**
      * Applies server transform values to an actor.
      *
@@ -587,6 +838,45 @@ private:
      */
     void ApplyServerTransform(AActor* actorPtr, sfObject::SPtr objPtr);
 
+    /**
+     * Applies a packed transform to an actor's root component, so the actor has the same quantized transform other
+     * users decode.
+     *
+     * @param   USceneComponent* rootComponentPtr
+     * @param   sfProperty::SPtr transformPtr to decode.
+     */
+    void ApplyPackedTransform(USceneComponent* rootComponentPtr, sfProperty::SPtr transformPtr);
+
+    /**
+     * Applies server transforms to actors whose transform properties changed, invalidating lighting and redrawing the
+     * viewport once for all of them.
+     */
+    void ApplyServerTransformChanges();
+
+    /**
+     * Creates transform properties for an actor. The transform is packed into a single property if packed transforms
+     * are enabled.
+     *
+     * @param   AActor* actorPtr to create transform properties for.
+     * @param   sfDictionaryProperty::SPtr propertiesPtr to add transform properties to.
+     */
+    void CreateTransformProperties(AActor* actorPtr, sfDictionaryProperty::SPtr propertiesPtr);
+
+    /**
+     * Gets the transform from an actor object's properties. Supports packed and unpacked transforms.
+     *
+     * @param   sfDictionaryProperty::SPtr propertiesPtr to get transform from.
+     * @param   FVector& location
+     * @param   FRotator& rotation
+     * @param   FVector& scale
+     * @return  bool false if the properties have no transform.
+     */
+    bool GetServerTransform(
+        sfDictionaryProperty::SPtr propertiesPtr,
+        FVector& location,
+        FRotator& rotation,
+        FVector& scale);
+
     /**
      * Registers property change handlers for server events.
      */
@@ -608,12 +898,12 @@ private:
     void Unlock(AActor* actorPtr);
 
     /**
-     * Gets the lock material for a user. Creates the material if it does not already exist.
+     * Unlocks actors and removes them from the lock index. Selected actors are reselected to unlock their handles
+     * with one selection change notification.
      *
-     * @param   sfUser::SPtr userPtr to get lock material for. May be nullptr.
-     * @return  UMaterialInterface* lock material for the user.
+     * @param   const TArray<AActor*>& actors to unlock.
      */
-    UMaterialInterface* GetLockMaterial(sfUser::SPtr userPtr);
+    void Unlock(const TArray<AActor*>& actors);
 
     /**
      * Called when a user's color changes.
@@ -623,7 +913,8 @@ private:
     void OnUserColorChange(sfUser::SPtr userPtr);
 
     /**
-     * Called when a user disconnects.
+     * Called when a user disconnects. The server releases the user's locks, so the actors they locked are unlocked
+     * in one pass.
      *
      * @param   sfUser::SPtr userPtr
      */
@@ -645,26 +936,32 @@ private:
     virtual void OnDelete(sfObject::SPtr objPtr) override;
 
     /**
-     * Called when an actor is locked by another user.
+     * Called when an actor is locked by another user. Queues the lock change to apply on the next tick.
      *
      * @param   sfObject::SPtr objPtr that was locked.
      */
     virtual void OnLock(sfObject::SPtr objPtr) override;
 
     /**
-     * Called when an actor is unlocked by another user.
+     * Called when an actor is unlocked by another user. Queues the lock change to apply on the next tick.
      *
      * @param   sfObject::SPtr objPtr that was unlocked.
      */
     virtual void OnUnlock(sfObject::SPtr objPtr) override;
 
     /**
-     * Called when an actor's lock owner changes.
+     * Called when an actor's lock owner changes. Queues the lock change to apply on the next tick.
      *
      * @param   sfObject::SPtr objPtr whose lock owner changed.
      */
     virtual void OnLockOwnerChange(sfObject::SPtr objPtr) override;
 
+    /**
+     * Applies queued lock changes as one group. Compares each object's lock state with the lock index, so several
+     * lock events for the same object in one tick are applied once, and unlocks actors in one pass.
+     */
+    void ApplyLockChanges();
+
     /**
      * Called when an actor's parent is changed by another user.
      *
@@ -688,6 +985,23 @@ private:
      */
     virtual void OnRemoveField(sfDictionaryProperty::SPtr dictPtr, const sfName& name) override;
 
+    /**
+     * Called when another user sets or clears a merged property value on a locked actor. If we hold the lock, moves
+     * the merged value to the actor's object. Applies the property's current value.
+     *
+     * @param   sfObject::SPtr objPtr for the actor.
+     * @param   const sfName& name of the property that changed.
+     */
+    void OnMergedValueChange(sfObject::SPtr objPtr, const sfName& name);
+
+    /**
+     * Called when an asset id referenced by an object is added to the asset dictionary after the object tried to use
+     * it. Reapplies the actor's asset references, or spawns the actor if it could not be spawned without its class.
+     *
+     * @param   sfObject::SPtr objPtr that referenced the id.
+     */
+    void OnAssetIdResolved(sfObject::SPtr objPtr);
+
     /**
      * Called when one or more elements are added to a list property.
      *
@@ -722,13 +1036,31 @@ private:
     void OnRemoveLevel(ULevel* levelPtr);
 
     /**
-     * Calls OnCreate on every child of the given level sfObject. Destroys all unsynced actors after.
+     * Prefetches the assets used by the given level sfObject's descendants, then queues every child to be spawned
+     * over the next ticks once the assets are loaded. Destroys all unsynced actors after the queued actors for the
+     * level are spawned.
      *
      * @param   sfObject::SPtr sfLevelObjPtr
      * @param   ULevel* levelPtr
      */
     void OnSFLevelObjectCreate(sfObject::SPtr sfLevelObjPtr, ULevel* levelPtr);
 
+    /**
+     * Queues an object's actor to be spawned over the next ticks within the spawn budget.
+     *
+     * @param   sfObject::SPtr objPtr to spawn an actor for. Its parent must be a level object or a spawned actor.
+     */
+    void QueueSpawn(sfObject::SPtr objPtr);
+
+    /**
+     * Adds the paths of the class, mesh, material and template assets an actor object references to a set. Native
+     * class names are not added.
+     *
+     * @param   sfObject::SPtr objPtr to get asset paths for.
+     * @param   TSet<FString>& paths to add to.
+     */
+    void GetAssetPaths(sfObject::SPtr objPtr, TSet<FString>& paths);
+
     /**
      * Detaches the given actor from its parent if the given sfObject's parent is a level object and returns true.
      * Otherwise, returns false.
@@ -0,0 +1,180 @@
+#include "sfAssetDictionaryManager.h"
+#include "../SceneFusion.h"
+#include "../sfPropertyUtil.h"
+#include "../Consts.h"
+#include "../sfUtils.h"
+
+// Ids are the local user id in the upper bits and a counter in the lower bits.
+#define ASSET_ID_COUNTER_BITS 16
+#define LOG_CHANNEL "sfAssetDictionaryManager"
+
+sfAssetDictionaryManager::sfAssetDictionaryManager() :
+    m_nextId{ 1 },
+    m_idsUsedUp{ false }
+{
+
+}
+
+sfAssetDictionaryManager::~sfAssetDictionaryManager()
+{
+
+}
+
+void sfAssetDictionaryManager::Initialize()
+{
+    m_sessionPtr = SceneFusion::Service->Session();
+    m_nextId = 1;
+    m_idsUsedUp = false;
+    if (SceneFusion::IsSessionCreator)
+    {
+        m_dictionaryObjPtr = sfObject::Create(sfType::AssetDictionary, sfDictionaryProperty::Create());
+        m_sessionPtr->Create(m_dictionaryObjPtr);
+    }
+}
+
+void sfAssetDictionaryManager::CleanUp()
+{
+    m_sessionPtr = nullptr;
+    m_dictionaryObjPtr = nullptr;
+    m_idToPath.clear();
+    m_pathToId.Empty();
+    m_unresolved.clear();
+}
+
+void sfAssetDictionaryManager::OnCreate(sfObject::SPtr objPtr, int childIndex)
+{
+    m_dictionaryObjPtr = objPtr;
+    for (auto iter : *objPtr->Property()->AsDict())
+    {
+        AddEntry(iter.first, iter.second);
+    }
+}
+
+void sfAssetDictionaryManager::OnPropertyChange(sfProperty::SPtr propertyPtr)
+{
+    if (propertyPtr->GetDepth() == 1)
+    {
+        AddEntry(propertyPtr->Key(), propertyPtr);
+    }
+}
+
+void sfAssetDictionaryManager::AddEntry(const sfName& key, sfProperty::SPtr propPtr)
+{
+    uint32_t id;
+    if (!sfUtils::TryParseId(*key, id))
+    {
+        KS::Log::Warning("Invalid asset id '" + *key + "'.", LOG_CHANNEL);
+        return;
+    }
+    FString path = sfPropertyUtil::ToString(propPtr);
+    m_idToPath[id] = path;
+    if (!m_pathToId.Contains(path))
+    {
+        m_pathToId.Add(path, id);
+    }
+
+    auto iter = m_unresolved.find(id);
+    if (iter == m_unresolved.end())
+    {
+        return;
+    }
+    std::vector<std::weak_ptr<sfObject>> objects = std::move(iter->second);
+    m_unresolved.erase(iter);
+    for (const std::weak_ptr<sfObject>& weakObjPtr : objects)
+    {
+        sfObject::SPtr objPtr = weakObjPtr.lock();
+        if (objPtr != nullptr && objPtr->IsSyncing())
+        {
+            OnResolve.ExecuteIfBound(objPtr);
+        }
+    }
+}
+
+sfProperty::SPtr sfAssetDictionaryManager::FromPath(const FString& path)
+{
+    if (m_dictionaryObjPtr == nullptr)
+    {
+        // The session was created without an asset dictionary
+        return sfPropertyUtil::FromString(path, m_sessionPtr);
+    }
+    if (path.IsEmpty())
+    {
+        return sfValueProperty::Create(ksMultiType((uint32_t)0));
+    }
+    uint32_t* idPtr = m_pathToId.Find(path);
+    if (idPtr != nullptr)
+    {
+        return sfValueProperty::Create(ksMultiType(*idPtr));
+    }
+    uint32_t id = AllocateId();
+    if (id == 0)
+    {
+        return sfPropertyUtil::FromString(path, m_sessionPtr);
+    }
+    m_idToPath[id] = path;
+    m_pathToId.Add(path, id);
+    m_dictionaryObjPtr->Property()->AsDict()->Set(sfName(std::to_string(id)),
+        sfPropertyUtil::FromString(path, m_sessionPtr));
+    return sfValueProperty::Create(ksMultiType(id));
+}
+
+FString sfAssetDictionaryManager::ToPath(sfProperty::SPtr propPtr)
+{
+    sfValueProperty::SPtr valuePtr = propPtr == nullptr ? nullptr : propPtr->AsValue();
+    if (valuePtr == nullptr)
+    {
+        return "";
+    }
+    if (valuePtr->GetValue().GetType() == ksMultiType::STRING)
+    {
+        return sfPropertyUtil::ToString(valuePtr);
+    }
+    uint32_t id = valuePtr->GetValue();
+    if (id == 0)
+    {
+        return "";
+    }
+    auto iter = m_idToPath.find(id);
+    if (iter != m_idToPath.end())
+    {
+        return iter->second;
+    }
+    // The dictionary entry hasn't reached us yet. Remember the object so its reference is applied when it does.
+    sfObject::SPtr objPtr = propPtr->GetContainerObject();
+    if (objPtr != nullptr)
+    {
+        std::vector<std::weak_ptr<sfObject>>& objects = m_unresolved[id];
+        if (objects.empty() || objects.back().lock() != objPtr)
+        {
+            objects.push_back(objPtr);
+        }
+    }
+    return "";
+}
+
+uint32_t sfAssetDictionaryManager::AllocateId()
+{
+    if (m_idsUsedUp)
+    {
+        return 0;
+    }
+    uint32_t userId = m_sessionPtr->LocalUser()->Id();
+    // Skip ids used by a previous user with the same user id. User ids that don't fit in the upper bits have no range.
+    while (userId < (1u << (32 - ASSET_ID_COUNTER_BITS)) && m_nextId < (1u << ASSET_ID_COUNTER_BITS))
+    {
+        uint32_t id = (userId << ASSET_ID_COUNTER_BITS) | m_nextId;
+        m_nextId++;
+        if (m_idToPath.find(id) == m_idToPath.end())
+        {
+            return id;
+        }
+    }
+    m_idsUsedUp = true;
+    KS::Log::Warning("Asset dictionary ids for user " + std::to_string(userId) + " used up. Ids have " +
+        std::to_string(ASSET_ID_COUNTER_BITS) + " bits per user. Using asset paths for new assets instead.",
+        LOG_CHANNEL);
+    return 0;
+}
+
+#undef ASSET_ID_COUNTER_BITS
+#undef LOG_CHANNEL
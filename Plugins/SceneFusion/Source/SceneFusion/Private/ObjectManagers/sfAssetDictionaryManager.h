@@ -0,0 +1,115 @@
+#pragma once
+
+#include <CoreMinimal.h>
+#include <sfObject.h>
+#include <sfSession.h>
+#include <unordered_map>
+#include <vector>
+#include <memory>
+
+#include "IObjectManager.h"
+
+using namespace KS::SceneFusion2;
+using namespace KS;
+
+/**
+ * Manages the session's asset dictionary object, which maps asset paths to small integer ids so actors can reference
+ * assets by id instead of by path. Each user allocates ids from their own range so users can add entries at the same
+ * time without conflicts. Sessions without an asset dictionary use path strings.
+ */
+class sfAssetDictionaryManager : public IObjectManager
+{
+public:
+    /**
+     * Delegate for resolving asset ids.
+     *
+     * @param   sfObject::SPtr - object that referenced the id before it was known.
+     */
+    DECLARE_DELEGATE_OneParam(OnResolveDelegate, sfObject::SPtr);
+
+    /**
+     * Invoked when an id that could not be resolved to a path is added to the dictionary, once for each object that
+     * tried to resolve it, so the object's asset references can be applied again.
+     */
+    OnResolveDelegate OnResolve;
+
+    /**
+     * Constructor
+     */
+    sfAssetDictionaryManager();
+
+    /**
+     * Destructor
+     */
+    virtual ~sfAssetDictionaryManager();
+
+    /**
+     * Initialization. Called after connecting to a session. Creates the asset dictionary if we created the session.
+     */
+    virtual void Initialize() override;
+
+    /**
+     * Deinitialization. Called after disconnecting from a session.
+     */
+    virtual void CleanUp() override;
+
+    /**
+     * Creates a property that references an asset path. If the session has an asset dictionary, this is the path's
+     * id, and the path is added to the dictionary if it isn't in it. Otherwise this is the path string. Empty paths
+     * have id 0.
+     *
+     * @param   const FString& path
+     * @return  sfProperty::SPtr
+     */
+    sfProperty::SPtr FromPath(const FString& path);
+
+    /**
+     * Gets the asset path from a property created by FromPath. Supports path strings from sessions without an asset
+     * dictionary. Ids can reach us before their dictionary entries, so if the id is unknown, OnResolve is invoked for
+     * the property's object when the id is added.
+     *
+     * @param   sfProperty::SPtr propPtr
+     * @return  FString path, or empty string if the id is 0 or unknown.
+     */
+    FString ToPath(sfProperty::SPtr propPtr);
+
+private:
+    sfSession::SPtr m_sessionPtr;
+    sfObject::SPtr m_dictionaryObjPtr;
+    std::unordered_map<uint32_t, FString> m_idToPath;
+    TMap<FString, uint32_t> m_pathToId;
+    // Objects that referenced each unknown id
+    std::unordered_map<uint32_t, std::vector<std::weak_ptr<sfObject>>> m_unresolved;
+    uint32_t m_nextId;
+    bool m_idsUsedUp;
+
+    /**
+     * Called when the asset dictionary is created by another user.
+     *
+     * @param   sfObject::SPtr objPtr that was created.
+     * @param   int childIndex of new object. -1 if object is a root
+     */
+    virtual void OnCreate(sfObject::SPtr objPtr, int childIndex) override;
+
+    /**
+     * Called when another user adds an entry to the asset dictionary.
+     *
+     * @param   sfProperty::SPtr propertyPtr that changed.
+     */
+    virtual void OnPropertyChange(sfProperty::SPtr propertyPtr) override;
+
+    /**
+     * Adds a dictionary entry to the id and path maps.
+     *
+     * @param   const sfName& key - the entry's id as a string.
+     * @param   sfProperty::SPtr propPtr - the entry's path.
+     */
+    void AddEntry(const sfName& key, sfProperty::SPtr propPtr);
+
+    /**
+     * Allocates an unused id from the local user's range. Logs a warning the first time the range is used up.
+     *
+     * @return  uint32_t id, or 0 if the local user's range is used up.
+     */
+    uint32_t AllocateId();
+};
@@ -2,6 +2,8 @@
 #include "../sfPropertyUtil.h"
 #include "../SceneFusion.h"
 #include "../Consts.h"
+#include "../sfConfig.h"
+#include "../sfPackedTransform.h"
 #include "../Actors/sfBodyActor.h"
 #include "../Components/sfFlashlightComponent.h"
 
@@ -139,8 +141,15 @@ sfDictionaryProperty::SPtr sfAvatarManager::CreateAvatarProperty(
 {
     sfDictionaryProperty::SPtr propertiesPtr = sfDictionaryProperty::Create();
     propertiesPtr->Set(sfProp::Mesh, sfValueProperty::Create(meshId));
-    propertiesPtr->Set(sfProp::Location, sfPropertyUtil::FromVector(location));
-    propertiesPtr->Set(sfProp::Rotation, sfPropertyUtil::FromQuat(rotation));
+    if (sfConfig::Get().PackTransforms)
+    {
+        propertiesPtr->Set(sfProp::Transform, sfPackedTransform::Encode(location, rotation, FVector::OneVector));
+    }
+    else
+    {
+        propertiesPtr->Set(sfProp::Location, sfPropertyUtil::FromVector(location));
+        propertiesPtr->Set(sfProp::Rotation, sfPropertyUtil::FromQuat(rotation));
+    }
     return propertiesPtr;
 }
 
@@ -243,6 +252,23 @@ void sfAvatarManager::RegisterPropertyChangeHandlers()
         }
     };
 
+    m_propertyChangeHandlers[sfProp::Transform] = [this](sfProperty::SPtr propertyPtr)
+    {
+        AsfAvatarActor* actorPtr = m_sfObjToActor.FindRef(propertyPtr->GetContainerObject()->Id());
+        FVector location;
+        FQuat rotation;
+        FVector scale;
+        if (IsActorValid(actorPtr) && sfPackedTransform::Decode(propertyPtr, location, rotation, scale))
+        {
+            actorPtr->SetActorLocation(location);
+            actorPtr->SetRotation(rotation);
+            if (m_followingCameraPtr == actorPtr)
+            {
+                StartFollowing();
+            }
+        }
+    };
+
     m_propertyChangeHandlers[sfProp::Scale] = [this](sfProperty::SPtr propertyPtr)
     {
         sfObject::SPtr objPtr = propertyPtr->GetContainerObject();
@@ -281,11 +307,14 @@ void sfAvatarManager::OnCreate(sfObject::SPtr objPtr, int childIndex)
         uint32_t userId = GetOwnerId(currentObjectPtr);
         sfDictionaryProperty::SPtr propertiesPtr = currentObjectPtr->Property()->AsDict();
         int meshId = KS::SceneFusion2::ToInt(propertiesPtr->Get(sfProp::Mesh));
+        FVector location;
+        FQuat rotation;
+        GetTransform(propertiesPtr, location, rotation);
         if (meshId == HEAD)
         {
             actorPtr = AsfBodyActor::Create(
-                sfPropertyUtil::ToVector(propertiesPtr->Get(sfProp::Location)),
-                sfPropertyUtil::ToQuat(propertiesPtr->Get(sfProp::Rotation)).Rotator(),
+                location,
+                rotation.Rotator(),
                 m_meshPtrs[HEAD],
                 m_meshPtrs[HMD],
                 m_meshPtrs[BODY],
@@ -294,8 +323,8 @@ void sfAvatarManager::OnCreate(sfObject::SPtr objPtr, int childIndex)
         else
         {
             actorPtr = AsfAvatarActor::Create(
-                sfPropertyUtil::ToVector(propertiesPtr->Get(sfProp::Location)),
-                sfPropertyUtil::ToQuat(propertiesPtr->Get(sfProp::Rotation)).Rotator(),
+                location,
+                rotation.Rotator(),
                 m_meshPtrs[meshId],
                 m_userIdToMaterial[userId]);
         }
@@ -602,15 +631,51 @@ void sfAvatarManager::SendTransform(
     const FVector& location,
     const FQuat& rotation)
 {
+    sfProperty::SPtr oldPropPtr;
+    if (propertiesPtr->TryGet(sfProp::Transform, oldPropPtr))
+    {
+        // Compare encoded bytes so changes smaller than the quantization precision are not sent
+        sfProperty::SPtr transformPtr = sfPackedTransform::Encode(location, rotation, FVector::OneVector);
+        if (!sfPackedTransform::Equals(transformPtr, oldPropPtr))
+        {
+            propertiesPtr->Set(sfProp::Transform, transformPtr);
+            sfPackedTransform::RecordUpdate(true, 1, sfPropertyUtil::EstimateSize(transformPtr));
+        }
+        return;
+    }
 
+    int numProperties = 0;
+    int bytes = 0;
     if (sfPropertyUtil::ToVector(propertiesPtr->Get(sfProp::Location)) != location)
     {
-        propertiesPtr->Set(sfProp::Location, sfPropertyUtil::FromVector(location));
+        sfProperty::SPtr locationPtr = sfPropertyUtil::FromVector(location);
+        propertiesPtr->Set(sfProp::Location, locationPtr);
+        numProperties++;
+        bytes += sfPropertyUtil::EstimateSize(locationPtr);
     }
 
     if (sfPropertyUtil::ToQuat(propertiesPtr->Get(sfProp::Rotation)) != rotation)
     {
-        propertiesPtr->Set(sfProp::Rotation, sfPropertyUtil::FromQuat(rotation));
+        sfProperty::SPtr rotationPtr = sfPropertyUtil::FromQuat(rotation);
+        propertiesPtr->Set(sfProp::Rotation, rotationPtr);
+        numProperties++;
+        bytes += sfPropertyUtil::EstimateSize(rotationPtr);
+    }
+    if (numProperties > 0)
+    {
+        sfPackedTransform::RecordUpdate(false, numProperties, bytes);
+    }
+}
+
+void sfAvatarManager::GetTransform(sfDictionaryProperty::SPtr propertiesPtr, FVector& location, FQuat& rotation)
+{
+    sfProperty::SPtr propPtr;
+    FVector scale;
+    if (!propertiesPtr->TryGet(sfProp::Transform, propPtr) ||
+        !sfPackedTransform::Decode(propPtr, location, rotation, scale))
+    {
+        location = sfPropertyUtil::ToVector(propertiesPtr->Get(sfProp::Location));
+        rotation = sfPropertyUtil::ToQuat(propertiesPtr->Get(sfProp::Rotation));
     }
 }
 
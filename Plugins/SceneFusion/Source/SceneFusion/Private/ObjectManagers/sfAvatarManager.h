@@ -256,6 +256,15 @@ private:
      */
     void SendTransform(sfDictionaryProperty::SPtr propertiesPtr, const FVector& location, const FQuat& rotation);
 
+    /**
+     * Gets the location and rotation from an avatar's properties. Supports packed and unpacked transforms.
+     *
+     * @param   sfDictionaryProperty::SPtr propertiesPtr
+     * @param   FVector& location
+     * @param   FQuat& rotation
+     */
+    void GetTransform(sfDictionaryProperty::SPtr propertiesPtr, FVector& location, FQuat& rotation);
+
     /**
      * Toggles flashlight on controllerActorPtr.
      *
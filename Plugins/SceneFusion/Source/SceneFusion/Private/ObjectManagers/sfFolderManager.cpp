@@ -0,0 +1,596 @@
+#include "sfFolderManager.h"
+#include "../SceneFusion.h"
+#include "../sfPropertyUtil.h"
+#include "../sfUtils.h"
+#include "../Consts.h"
+
+#include <Editor.h>
+#include <Editor/UnrealEd/Public/EditorActorFolders.h>
+#include <sfPropertyUtils.h>
+
+// Ids are the local user id in the upper bits and a counter in the lower bits.
+#define FOLDER_ID_COUNTER_BITS 16
+#define LOG_CHANNEL "sfFolderManager"
+
+sfFolderManager::sfFolderManager() :
+    m_nextId{ 1 }
+{
+
+}
+
+sfFolderManager::~sfFolderManager()
+{
+
+}
+
+void sfFolderManager::Initialize()
+{
+    m_sessionPtr = SceneFusion::Service->Session();
+    m_nextId = 1;
+    m_onFolderCreateHandle = FActorFolders::OnFolderCreate.AddRaw(this, &sfFolderManager::OnFolderCreate);
+    m_onFolderMoveHandle = FActorFolders::OnFolderMove.AddRaw(this, &sfFolderManager::OnFolderMove);
+    m_onFolderDeleteHandle = FActorFolders::OnFolderDelete.AddRaw(this, &sfFolderManager::OnFolderDelete);
+    if (SceneFusion::IsSessionCreator)
+    {
+        sfDictionaryProperty::SPtr propertiesPtr = sfDictionaryProperty::Create();
+        propertiesPtr->Set(sfProp::Id, sfValueProperty::Create(ksMultiType((uint32_t)0)));
+        m_rootPtr = sfObject::Create(sfType::Folder, propertiesPtr);
+        m_idToObject[0] = m_rootPtr;
+        m_objectToPath[m_rootPtr] = NAME_None;
+        // Add objects for existing folders as children before creating the root so they are created together
+        UWorld* worldPtr = GEditor->GetEditorWorldContext().World();
+        if (worldPtr != nullptr && FActorFolders::IsAvailable())
+        {
+            for (const auto& iter : FActorFolders::Get().GetFolderPropertiesForWorld(*worldPtr))
+            {
+                GetOrCreateFolderObject(iter.Key);
+            }
+        }
+        m_sessionPtr->Create(m_rootPtr);
+    }
+}
+
+void sfFolderManager::CleanUp()
+{
+    FActorFolders::OnFolderCreate.Remove(m_onFolderCreateHandle);
+    FActorFolders::OnFolderMove.Remove(m_onFolderMoveHandle);
+    FActorFolders::OnFolderDelete.Remove(m_onFolderDeleteHandle);
+    m_sessionPtr = nullptr;
+    m_rootPtr = nullptr;
+    m_idToObject.clear();
+    m_objectToPath.clear();
+    m_pathToObject.Empty();
+    m_duplicateFolders.Empty();
+    m_movedFolders.Empty();
+    m_createdFolders.Empty();
+    m_deletedFolders.Empty();
+}
+
+void sfFolderManager::Tick()
+{
+    if (m_rootPtr == nullptr || !FActorFolders::IsAvailable())
+    {
+        m_movedFolders.Empty();
+        m_createdFolders.Empty();
+        m_deletedFolders.Empty();
+        return;
+    }
+    UWorld* worldPtr = GEditor->GetEditorWorldContext().World();
+
+    // Merge folders we created that have the same path as a folder with a lower id. Only the user who created a
+    // duplicate merges it, so it is only merged once.
+    TArray<TPair<sfObject::SPtr, sfObject::SPtr>> duplicateFolders = MoveTemp(m_duplicateFolders);
+    m_duplicateFolders.Empty();
+    uint32_t localUserId = m_sessionPtr->LocalUser()->Id();
+    for (const TPair<sfObject::SPtr, sfObject::SPtr>& duplicate : duplicateFolders)
+    {
+        auto pathIter = m_objectToPath.find(duplicate.Key);
+        if (pathIter != m_objectToPath.end() && m_pathToObject.FindRef(pathIter->second) == duplicate.Value &&
+            duplicate.Key->IsSyncing() && (GetId(duplicate.Key) >> FOLDER_ID_COUNTER_BITS) == localUserId)
+        {
+            MergeFolder(duplicate.Key, duplicate.Value);
+        }
+    }
+
+    // Unreal sends a move for a folder and for each of its subfolders. Moving parents first moves the subfolders'
+    // objects with them, so the subfolders' own moves find nothing left to do.
+    m_movedFolders.Sort([](const TPair<FName, FName>& a, const TPair<FName, FName>& b)
+    {
+        int32 aDepth = 0;
+        int32 bDepth = 0;
+        for (TCHAR c : a.Key.ToString())
+        {
+            aDepth += c == '/';
+        }
+        for (TCHAR c : b.Key.ToString())
+        {
+            bDepth += c == '/';
+        }
+        return aDepth < bDepth;
+    });
+    for (const TPair<FName, FName>& move : m_movedFolders)
+    {
+        sfObject::SPtr objPtr = m_pathToObject.FindRef(move.Key);
+        if (objPtr == nullptr)
+        {
+            continue;
+        }
+        // Paths are case insensitive, so renames that only change case find the folder's own object at the new path
+        sfObject::SPtr existingPtr = m_pathToObject.FindRef(move.Value);
+        if (existingPtr == nullptr || existingPtr == objPtr)
+        {
+            MoveFolderObject(objPtr, move.Value);
+        }
+        else
+        {
+            // The folder was moved onto an existing folder, which merges them in the world
+            MergeFolder(objPtr, existingPtr);
+        }
+    }
+    m_movedFolders.Empty();
+
+    for (FName path : m_createdFolders)
+    {
+        if (!m_pathToObject.Contains(path) && FActorFolders::Get().GetFolderProperties(*worldPtr, path) != nullptr)
+        {
+            GetOrCreateFolderObject(path);
+        }
+    }
+    m_createdFolders.Empty();
+
+    for (FName path : m_deletedFolders)
+    {
+        sfObject::SPtr objPtr = m_pathToObject.FindRef(path);
+        if (objPtr != nullptr && FActorFolders::Get().GetFolderProperties(*worldPtr, path) == nullptr)
+        {
+            TArray<FName> removedPaths;
+            RemoveFolder(objPtr, removedPaths);
+            m_sessionPtr->Delete(objPtr);
+        }
+    }
+    m_deletedFolders.Empty();
+}
+
+bool sfFolderManager::IsSyncingFolders() const
+{
+    return m_rootPtr != nullptr;
+}
+
+sfProperty::SPtr sfFolderManager::FromPath(FName path)
+{
+    if (m_rootPtr == nullptr)
+    {
+        // The session was created without folder objects
+        return sfPropertyUtil::FromString(path.ToString(), m_sessionPtr);
+    }
+    if (path.IsNone())
+    {
+        return sfValueProperty::Create(ksMultiType((uint32_t)0));
+    }
+    sfObject::SPtr objPtr = GetOrCreateFolderObject(path);
+    if (objPtr == nullptr)
+    {
+        return sfPropertyUtil::FromString(path.ToString(), m_sessionPtr);
+    }
+    return sfValueProperty::Create(ksMultiType(ToUInt(objPtr->Property()->AsDict()->Get(sfProp::Id))));
+}
+
+FName sfFolderManager::ToPath(sfProperty::SPtr propPtr)
+{
+    sfValueProperty::SPtr valuePtr = propPtr == nullptr ? nullptr : propPtr->AsValue();
+    if (valuePtr == nullptr)
+    {
+        return NAME_None;
+    }
+    if (valuePtr->GetValue().GetType() == ksMultiType::STRING)
+    {
+        return FName(*sfPropertyUtil::ToString(valuePtr));
+    }
+    uint32_t id = valuePtr->GetValue();
+    if (id == 0)
+    {
+        return NAME_None;
+    }
+    auto iter = m_idToObject.find(id);
+    if (iter == m_idToObject.end())
+    {
+        KS::Log::Warning("Unknown folder id " + std::to_string(id), LOG_CHANNEL);
+        return NAME_None;
+    }
+    return m_objectToPath[iter->second];
+}
+
+void sfFolderManager::OnCreate(sfObject::SPtr objPtr, int childIndex)
+{
+    if (objPtr->Parent() == nullptr)
+    {
+        m_rootPtr = objPtr;
+        m_idToObject[0] = m_rootPtr;
+        m_objectToPath[m_rootPtr] = NAME_None;
+        for (sfObject::SPtr childPtr : objPtr->Children())
+        {
+            AddFolder(childPtr);
+        }
+        return;
+    }
+    AddFolder(objPtr);
+}
+
+void sfFolderManager::OnDelete(sfObject::SPtr objPtr)
+{
+    if (objPtr == m_rootPtr)
+    {
+        m_rootPtr = nullptr;
+        m_idToObject.clear();
+        m_objectToPath.clear();
+        m_pathToObject.Empty();
+        m_duplicateFolders.Empty();
+        return;
+    }
+    TArray<FName> removedPaths;
+    RemoveFolder(objPtr, removedPaths);
+    UWorld* worldPtr = GEditor->GetEditorWorldContext().World();
+    if (worldPtr == nullptr || !FActorFolders::IsAvailable())
+    {
+        return;
+    }
+    sfEventGuard::Scope guard(m_folderEventGuard);
+    sfUtils::PreserveUndoStack([worldPtr, &removedPaths]()
+    {
+        for (FName path : removedPaths)
+        {
+            FActorFolders::Get().DeleteFolder(*worldPtr, path);
+        }
+    });
+}
+
+void sfFolderManager::OnParentChange(sfObject::SPtr objPtr, int childIndex)
+{
+    ApplyServerPath(objPtr);
+}
+
+void sfFolderManager::OnPropertyChange(sfProperty::SPtr propertyPtr)
+{
+    if (propertyPtr->GetDepth() != 1)
+    {
+        return;
+    }
+    if (propertyPtr->Key() == sfProp::Name)
+    {
+        ApplyServerPath(propertyPtr->GetContainerObject());
+    }
+    else if (propertyPtr->Key() == sfProp::MergedIds)
+    {
+        AddMergedIds(propertyPtr->GetContainerObject());
+    }
+}
+
+void sfFolderManager::OnFolderCreate(UWorld& world, FName path)
+{
+    if (!m_folderEventGuard.IsActive() && &world == GEditor->GetEditorWorldContext().World())
+    {
+        m_createdFolders.AddUnique(path);
+    }
+}
+
+void sfFolderManager::OnFolderMove(UWorld& world, FName oldPath, FName newPath)
+{
+    if (!m_folderEventGuard.IsActive() && &world == GEditor->GetEditorWorldContext().World())
+    {
+        m_movedFolders.Emplace(oldPath, newPath);
+    }
+}
+
+void sfFolderManager::OnFolderDelete(UWorld& world, FName path)
+{
+    if (!m_folderEventGuard.IsActive() && &world == GEditor->GetEditorWorldContext().World())
+    {
+        m_deletedFolders.AddUnique(path);
+    }
+}
+
+sfObject::SPtr sfFolderManager::GetOrCreateFolderObject(FName path)
+{
+    if (path.IsNone())
+    {
+        return m_rootPtr;
+    }
+    sfObject::SPtr objPtr = m_pathToObject.FindRef(path);
+    if (objPtr != nullptr)
+    {
+        return objPtr;
+    }
+    FName parentPath;
+    FString name;
+    SplitPath(path, parentPath, name);
+    sfObject::SPtr parentPtr = GetOrCreateFolderObject(parentPath);
+    if (parentPtr == nullptr)
+    {
+        return nullptr;
+    }
+    uint32_t id = AllocateId();
+    if (id == 0)
+    {
+        return nullptr;
+    }
+
+    sfDictionaryProperty::SPtr propertiesPtr = sfDictionaryProperty::Create();
+    propertiesPtr->Set(sfProp::Id, sfValueProperty::Create(ksMultiType(id)));
+    propertiesPtr->Set(sfProp::Name, sfPropertyUtil::FromString(name, m_sessionPtr));
+    objPtr = sfObject::Create(sfType::Folder, propertiesPtr);
+    m_idToObject[id] = objPtr;
+    m_objectToPath[objPtr] = path;
+    SetPathObject(path, objPtr);
+    if (parentPtr->IsSyncing())
+    {
+        m_sessionPtr->Create(objPtr, parentPtr, parentPtr->Children().size());
+    }
+    else
+    {
+        parentPtr->AddChild(objPtr);
+    }
+    return objPtr;
+}
+
+void sfFolderManager::MoveFolderObject(sfObject::SPtr objPtr, FName path)
+{
+    FName parentPath;
+    FString name;
+    SplitPath(path, parentPath, name);
+    sfObject::SPtr parentPtr = GetOrCreateFolderObject(parentPath);
+    if (parentPtr == nullptr)
+    {
+        return;
+    }
+    sfDictionaryProperty::SPtr propertiesPtr = objPtr->Property()->AsDict();
+    // FString comparison ignores case by default, so renames that only change case would be missed
+    if (!sfPropertyUtil::ToString(propertiesPtr->Get(sfProp::Name)).Equals(name, ESearchCase::CaseSensitive))
+    {
+        propertiesPtr->Set(sfProp::Name, sfPropertyUtil::FromString(name, m_sessionPtr));
+    }
+    if (objPtr->Parent() != parentPtr)
+    {
+        parentPtr->AddChild(objPtr);
+    }
+    UpdatePaths(objPtr);
+}
+
+void sfFolderManager::MergeFolder(sfObject::SPtr fromPtr, sfObject::SPtr intoPtr)
+{
+    // Record the merged folder's id and the ids merged into it on the other folder, so actors that reference them
+    // resolve to its path, including for users who join later. The whole list is set so other users get a property
+    // change.
+    sfDictionaryProperty::SPtr intoPropertiesPtr = intoPtr->Property()->AsDict();
+    sfListProperty::SPtr mergedIdsPtr = sfListProperty::Create();
+    sfProperty::SPtr oldIdsPtr;
+    if (intoPropertiesPtr->TryGet(sfProp::MergedIds, oldIdsPtr))
+    {
+        for (int i = 0; i < oldIdsPtr->AsList()->Size(); i++)
+        {
+            mergedIdsPtr->Add(sfValueProperty::Create(ksMultiType(ToUInt(oldIdsPtr->AsList()->Get(i)))));
+        }
+    }
+    mergedIdsPtr->Add(sfValueProperty::Create(ksMultiType(GetId(fromPtr))));
+    if (fromPtr->Property()->AsDict()->TryGet(sfProp::MergedIds, oldIdsPtr))
+    {
+        for (int i = 0; i < oldIdsPtr->AsList()->Size(); i++)
+        {
+            mergedIdsPtr->Add(sfValueProperty::Create(ksMultiType(ToUInt(oldIdsPtr->AsList()->Get(i)))));
+        }
+    }
+    intoPropertiesPtr->Set(sfProp::MergedIds, mergedIdsPtr);
+    AddMergedIds(intoPtr);
+
+    // Move the subfolders into the other folder, merging them with its subfolders that have the same name
+    FName intoPath = m_objectToPath[intoPtr];
+    std::list<sfObject::SPtr> children = fromPtr->Children();
+    for (sfObject::SPtr childPtr : children)
+    {
+        FString name = sfPropertyUtil::ToString(childPtr->Property()->AsDict()->Get(sfProp::Name));
+        FName childPath = intoPath.IsNone() ? FName(*name) : FName(*(intoPath.ToString() + "/" + name));
+        sfObject::SPtr existingPtr = m_pathToObject.FindRef(childPath);
+        if (existingPtr != nullptr && existingPtr != childPtr)
+        {
+            MergeFolder(childPtr, existingPtr);
+        }
+        else
+        {
+            intoPtr->AddChild(childPtr);
+            UpdatePaths(childPtr);
+        }
+    }
+
+    TArray<FName> removedPaths;
+    RemoveFolder(fromPtr, removedPaths);
+    m_sessionPtr->Delete(fromPtr);
+}
+
+void sfFolderManager::SetPathObject(FName path, sfObject::SPtr objPtr)
+{
+    sfObject::SPtr existingPtr = m_pathToObject.FindRef(path);
+    if (existingPtr == nullptr || existingPtr == objPtr)
+    {
+        m_pathToObject.Add(path, objPtr);
+        return;
+    }
+    // Another user created or moved a folder to the same path at the same time. Every user keeps the folder with the
+    // lowest id so they agree on which one to use.
+    if (GetId(objPtr) < GetId(existingPtr))
+    {
+        m_pathToObject.Add(path, objPtr);
+        m_duplicateFolders.Emplace(existingPtr, objPtr);
+    }
+    else
+    {
+        m_duplicateFolders.Emplace(objPtr, existingPtr);
+    }
+}
+
+void sfFolderManager::AddMergedIds(sfObject::SPtr objPtr)
+{
+    sfProperty::SPtr mergedIdsPtr;
+    if (objPtr == nullptr || !objPtr->Property()->AsDict()->TryGet(sfProp::MergedIds, mergedIdsPtr))
+    {
+        return;
+    }
+    for (int i = 0; i < mergedIdsPtr->AsList()->Size(); i++)
+    {
+        m_idToObject[ToUInt(mergedIdsPtr->AsList()->Get(i))] = objPtr;
+    }
+}
+
+void sfFolderManager::AddFolder(sfObject::SPtr objPtr)
+{
+    m_idToObject[GetId(objPtr)] = objPtr;
+    AddMergedIds(objPtr);
+    FName path = CalculatePath(objPtr);
+    m_objectToPath[objPtr] = path;
+    SetPathObject(path, objPtr);
+
+    UWorld* worldPtr = GEditor->GetEditorWorldContext().World();
+    if (worldPtr != nullptr && FActorFolders::IsAvailable() &&
+        FActorFolders::Get().GetFolderProperties(*worldPtr, path) == nullptr)
+    {
+        sfEventGuard::Scope guard(m_folderEventGuard);
+        sfUtils::PreserveUndoStack([worldPtr, path]()
+        {
+            FActorFolders::Get().CreateFolder(*worldPtr, path);
+        });
+    }
+
+    for (sfObject::SPtr childPtr : objPtr->Children())
+    {
+        AddFolder(childPtr);
+    }
+}
+
+void sfFolderManager::RemoveFolder(sfObject::SPtr objPtr, TArray<FName>& removedPaths)
+{
+    for (sfObject::SPtr childPtr : objPtr->Children())
+    {
+        RemoveFolder(childPtr, removedPaths);
+    }
+    // The folder's id is kept if it was merged into another folder
+    auto idIter = m_idToObject.find(GetId(objPtr));
+    if (idIter != m_idToObject.end() && idIter->second == objPtr)
+    {
+        m_idToObject.erase(idIter);
+    }
+    sfProperty::SPtr mergedIdsPtr;
+    if (objPtr->Property()->AsDict()->TryGet(sfProp::MergedIds, mergedIdsPtr))
+    {
+        for (int i = 0; i < mergedIdsPtr->AsList()->Size(); i++)
+        {
+            idIter = m_idToObject.find(ToUInt(mergedIdsPtr->AsList()->Get(i)));
+            if (idIter != m_idToObject.end() && idIter->second == objPtr)
+            {
+                m_idToObject.erase(idIter);
+            }
+        }
+    }
+    auto iter = m_objectToPath.find(objPtr);
+    if (iter != m_objectToPath.end())
+    {
+        // Don't remove the path if it belongs to a folder with the same path that this folder was merged into
+        if (m_pathToObject.FindRef(iter->second) == objPtr)
+        {
+            m_pathToObject.Remove(iter->second);
+            removedPaths.Add(iter->second);
+        }
+        m_objectToPath.erase(iter);
+    }
+}
+
+void sfFolderManager::UpdatePaths(sfObject::SPtr objPtr)
+{
+    FName& path = m_objectToPath[objPtr];
+    if (m_pathToObject.FindRef(path) == objPtr)
+    {
+        m_pathToObject.Remove(path);
+    }
+    path = CalculatePath(objPtr);
+    SetPathObject(path, objPtr);
+    for (sfObject::SPtr childPtr : objPtr->Children())
+    {
+        UpdatePaths(childPtr);
+    }
+}
+
+void sfFolderManager::ApplyServerPath(sfObject::SPtr objPtr)
+{
+    auto iter = m_objectToPath.find(objPtr);
+    if (objPtr == nullptr || objPtr == m_rootPtr || iter == m_objectToPath.end())
+    {
+        return;
+    }
+    FName oldPath = iter->second;
+    UpdatePaths(objPtr);
+    FName newPath = m_objectToPath[objPtr];
+    UWorld* worldPtr = GEditor->GetEditorWorldContext().World();
+    // FName comparison ignores case, so we compare strings to apply renames that only change case
+    if (oldPath.ToString().Equals(newPath.ToString(), ESearchCase::CaseSensitive) || worldPtr == nullptr ||
+        !FActorFolders::IsAvailable())
+    {
+        return;
+    }
+    // Renaming the folder moves its subfolders and actors. The actors' folder ids don't change, so the actor manager
+    // has nothing to send for them.
+    sfEventGuard::Scope guard(m_folderEventGuard);
+    sfUtils::PreserveUndoStack([worldPtr, oldPath, newPath]()
+    {
+        FActorFolders::Get().RenameFolderInWorld(*worldPtr, oldPath, newPath);
+    });
+}
+
+FName sfFolderManager::CalculatePath(sfObject::SPtr objPtr)
+{
+    FString name = sfPropertyUtil::ToString(objPtr->Property()->AsDict()->Get(sfProp::Name));
+    sfObject::SPtr parentPtr = objPtr->Parent();
+    auto iter = parentPtr == nullptr ? m_objectToPath.end() : m_objectToPath.find(parentPtr);
+    if (iter == m_objectToPath.end() || iter->second.IsNone())
+    {
+        return FName(*name);
+    }
+    return FName(*(iter->second.ToString() + "/" + name));
+}
+
+uint32_t sfFolderManager::GetId(sfObject::SPtr objPtr)
+{
+    return ToUInt(objPtr->Property()->AsDict()->Get(sfProp::Id));
+}
+
+void sfFolderManager::SplitPath(FName path, FName& parentPath, FString& name)
+{
+    FString pathString = path.ToString();
+    int32 index;
+    if (pathString.FindLastChar('/', index))
+    {
+        parentPath = FName(*pathString.Left(index));
+        name = pathString.Mid(index + 1);
+    }
+    else
+    {
+        parentPath = NAME_None;
+        name = pathString;
+    }
+}
+
+uint32_t sfFolderManager::AllocateId()
+{
+    uint32_t baseId = m_sessionPtr->LocalUser()->Id() << FOLDER_ID_COUNTER_BITS;
+    // Skip ids used by a previous user with the same user id
+    while (m_nextId < (1u << FOLDER_ID_COUNTER_BITS))
+    {
+        uint32_t id = baseId | m_nextId;
+        m_nextId++;
+        if (m_idToObject.find(id) == m_idToObject.end())
+        {
+            return id;
+        }
+    }
+    KS::Log::Warning("Folder ids used up. Using folder paths instead.", LOG_CHANNEL);
+    return 0;
+}
+
+#undef FOLDER_ID_COUNTER_BITS
+#undef LOG_CHANNEL
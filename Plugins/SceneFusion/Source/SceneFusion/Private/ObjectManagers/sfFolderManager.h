@@ -0,0 +1,260 @@
+#pragma once
+
+#include <CoreMinimal.h>
+#include <sfObject.h>
+#include <sfSession.h>
+#include <unordered_map>
+#include <list>
+
+#include "IObjectManager.h"
+#include "../sfEventGuard.h"
+
+using namespace KS::SceneFusion2;
+using namespace KS;
+
+/**
+ * Syncs World Outliner folders as objects so renaming or moving a folder is one change instead of a folder change for
+ * every actor in it. Each folder object has an id and the folder's name, and is a child of its parent folder's
+ * object. Actors reference their folder by id. The root folder object has id 0 and is created by the session creator.
+ * Each user allocates ids from their own range so users can create folders at the same time without conflicts.
+ * Folders are case insensitive, so if users create or move folders to the same path at the same time, the folder with
+ * the lowest id is used for the path and the others are merged into it by the users who created them. A merged
+ * folder's subfolders are moved into the folder it was merged into, and its id is recorded on that folder so actors
+ * that reference it resolve to the same path. Sessions without a root folder object use folder path strings.
+ */
+class sfFolderManager : public IObjectManager
+{
+public:
+    /**
+     * Constructor
+     */
+    sfFolderManager();
+
+    /**
+     * Destructor
+     */
+    virtual ~sfFolderManager();
+
+    /**
+     * Initialization. Called after connecting to a session. Creates objects for the world's folders if we created
+     * the session.
+     */
+    virtual void Initialize() override;
+
+    /**
+     * Deinitialization. Called after disconnecting from a session.
+     */
+    virtual void CleanUp() override;
+
+    /**
+     * Sends folders created, moved and deleted in the World Outliner since the last tick. Moves are sent before
+     * creates so a renamed folder keeps its object.
+     */
+    void Tick();
+
+    /**
+     * Checks if the session syncs folders as objects.
+     *
+     * @return  bool
+     */
+    bool IsSyncingFolders() const;
+
+    /**
+     * Creates a property that references a folder path. If the session syncs folders as objects, this is the id of
+     * the folder's object, and objects are created for the folder and its parents if they don't have them. Otherwise
+     * this is the path string. Actors that aren't in a folder have id 0.
+     *
+     * @param   FName path
+     * @return  sfProperty::SPtr
+     */
+    sfProperty::SPtr FromPath(FName path);
+
+    /**
+     * Gets the folder path from a property created by FromPath. Supports path strings from sessions that don't sync
+     * folders as objects.
+     *
+     * @param   sfProperty::SPtr propPtr
+     * @return  FName path, or NAME_None if the id is 0 or unknown.
+     */
+    FName ToPath(sfProperty::SPtr propPtr);
+
+private:
+    sfSession::SPtr m_sessionPtr;
+    sfObject::SPtr m_rootPtr;
+    std::unordered_map<uint32_t, sfObject::SPtr> m_idToObject;
+    std::unordered_map<sfObject::SPtr, FName> m_objectToPath;
+    TMap<FName, sfObject::SPtr> m_pathToObject;
+    // Folders that have the same path as a folder with a lower id, and the folder they should be merged into
+    TArray<TPair<sfObject::SPtr, sfObject::SPtr>> m_duplicateFolders;
+    uint32_t m_nextId;
+    // Suppresses folder events while we change folders
+    sfEventGuard m_folderEventGuard;
+    // Folder changes from the World Outliner to send on the next tick
+    TArray<TPair<FName, FName>> m_movedFolders;
+    TArray<FName> m_createdFolders;
+    TArray<FName> m_deletedFolders;
+    FDelegateHandle m_onFolderCreateHandle;
+    FDelegateHandle m_onFolderMoveHandle;
+    FDelegateHandle m_onFolderDeleteHandle;
+
+    /**
+     * Called when a folder object is created by another user. Creates folders for the object and its descendants.
+     *
+     * @param   sfObject::SPtr objPtr that was created.
+     * @param   int childIndex of new object. -1 if object is a root
+     */
+    virtual void OnCreate(sfObject::SPtr objPtr, int childIndex) override;
+
+    /**
+     * Called when a folder object is deleted by another user. Deletes the folder and its subfolders.
+     *
+     * @param   sfObject::SPtr objPtr that was deleted.
+     */
+    virtual void OnDelete(sfObject::SPtr objPtr) override;
+
+    /**
+     * Called when a folder is moved to a different parent folder by another user.
+     *
+     * @param   sfObject::SPtr objPtr whose parent changed.
+     * @param   int childIndex of the object. -1 if the object is a root.
+     */
+    virtual void OnParentChange(sfObject::SPtr objPtr, int childIndex) override;
+
+    /**
+     * Called when a folder is renamed by another user, or another user merges a folder into it.
+     *
+     * @param   sfProperty::SPtr propertyPtr that changed.
+     */
+    virtual void OnPropertyChange(sfProperty::SPtr propertyPtr) override;
+
+    /**
+     * Called when a folder is created in the World Outliner.
+     *
+     * @param   UWorld& world the folder was created in.
+     * @param   FName path of the folder.
+     */
+    void OnFolderCreate(UWorld& world, FName path);
+
+    /**
+     * Called when a folder is renamed or moved in the World Outliner. Called for the folder and each of its
+     * subfolders.
+     *
+     * @param   UWorld& world the folder is in.
+     * @param   FName oldPath
+     * @param   FName newPath
+     */
+    void OnFolderMove(UWorld& world, FName oldPath, FName newPath);
+
+    /**
+     * Called when a folder is deleted in the World Outliner.
+     *
+     * @param   UWorld& world the folder was deleted from.
+     * @param   FName path of the folder.
+     */
+    void OnFolderDelete(UWorld& world, FName path);
+
+    /**
+     * Gets the object for a folder, creating objects for it and its parents if they don't have them.
+     *
+     * @param   FName path of the folder.
+     * @return  sfObject::SPtr object for the folder, the root object if the path is NAME_None, or nullptr if the
+     *          local user's id range is used up.
+     */
+    sfObject::SPtr GetOrCreateFolderObject(FName path);
+
+    /**
+     * Sets the name and parent of a folder's object to match a new path.
+     *
+     * @param   sfObject::SPtr objPtr for the folder.
+     * @param   FName path to move the folder to.
+     */
+    void MoveFolderObject(sfObject::SPtr objPtr, FName path);
+
+    /**
+     * Merges a folder object into another folder object with the same path. Moves its subfolders into the other
+     * folder, records its id and merged ids on the other folder, and deletes it.
+     *
+     * @param   sfObject::SPtr fromPtr - folder to merge.
+     * @param   sfObject::SPtr intoPtr - folder to merge into.
+     */
+    void MergeFolder(sfObject::SPtr fromPtr, sfObject::SPtr intoPtr);
+
+    /**
+     * Maps a path to a folder object. If another folder object has the path, the one with the lowest id is used, and
+     * the other is queued to be merged into it.
+     *
+     * @param   FName path
+     * @param   sfObject::SPtr objPtr for the folder.
+     */
+    void SetPathObject(FName path, sfObject::SPtr objPtr);
+
+    /**
+     * Maps the ids recorded as merged into a folder object to the object.
+     *
+     * @param   sfObject::SPtr objPtr for the folder.
+     */
+    void AddMergedIds(sfObject::SPtr objPtr);
+
+    /**
+     * Adds a folder object and its descendants to the id and path maps, and creates their folders in the world.
+     *
+     * @param   sfObject::SPtr objPtr to add.
+     */
+    void AddFolder(sfObject::SPtr objPtr);
+
+    /**
+     * Removes a folder object and its descendants from the id and path maps.
+     *
+     * @param   sfObject::SPtr objPtr to remove.
+     * @param   TArray<FName>& removedPaths - the paths of the removed folders are added to this. Paths that belong to
+     *          another folder object are not added.
+     */
+    void RemoveFolder(sfObject::SPtr objPtr, TArray<FName>& removedPaths);
+
+    /**
+     * Recalculates the paths of a folder object and its descendants from their names and parents.
+     *
+     * @param   sfObject::SPtr objPtr to recalculate paths for.
+     */
+    void UpdatePaths(sfObject::SPtr objPtr);
+
+    /**
+     * Updates the paths of a folder object and its descendants after another user renamed or moved it, and renames
+     * the folder in the world.
+     *
+     * @param   sfObject::SPtr objPtr that was renamed or moved.
+     */
+    void ApplyServerPath(sfObject::SPtr objPtr);
+
+    /**
+     * Calculates a folder object's path from its name and its parent's path.
+     *
+     * @param   sfObject::SPtr objPtr
+     * @return  FName
+     */
+    FName CalculatePath(sfObject::SPtr objPtr);
+
+    /**
+     * Gets the id of a folder object.
+     *
+     * @param   sfObject::SPtr objPtr
+     * @return  uint32_t
+     */
+    static uint32_t GetId(sfObject::SPtr objPtr);
+
+    /**
+     * Splits a folder path into its parent path and its name.
+     *
+     * @param   FName path to split.
+     * @param   FName& parentPath - set to the parent path, or NAME_None if the folder is at the top level.
+     * @param   FString& name - set to the folder's name.
+     */
+    static void SplitPath(FName path, FName& parentPath, FString& name);
+
+    /**
+     * Allocates an unused id from the local user's range.
+     *
+     * @return  uint32_t id, or 0 if the local user's range is used up.
+     */
+    uint32_t AllocateId();
+};
@@ -182,83 +182,75 @@ void sfLevelManager::OnCreate(sfObject::SPtr objPtr, int childIndex)
     FString levelPath = *sfPropertyUtil::ToString(propertiesPtr->Get(sfProp::Name));
     bool isPersistentLevel = propertiesPtr->Get(sfProp::IsPersistentLevel)->AsValue()->GetValue();
 
-    // Temporarily remove event handlers
-    FEditorSupportDelegates::PrepareToCleanseEditorObject.Remove(m_onPrepareToCleanseEditorObjectHandle);
-    FEditorDelegates::OnAddLevelToWorld.Remove(m_onAddLevelToWorldHandle);
-    FCoreUObjectDelegates::OnObjectModified.Remove(m_onObjectModifiedHandle);
-
-    ULevel* levelPtr = FindLevelInLoadedLevels(levelPath, isPersistentLevel);
-    if (levelPtr == nullptr && !levelPath.StartsWith("/Temp") && FPackageName::DoesPackageExist(levelPath))
-    {
-        levelPtr = TryLoadLevelFromFile(levelPath, isPersistentLevel);
-    }
-    if (levelPtr == nullptr)
+    ULevel* levelPtr = nullptr;
     {
-        KS::Log::Warning("Could not find level " + std::string(TCHAR_TO_UTF8(*levelPath)) +
-            ". Please make sure that your project is up to date.");
-        levelPtr = CreateMap(levelPath, isPersistentLevel);
-    }
+        // Suppress our event handlers while loading the level
+        sfEventGuard::Scope cleanseGuard(m_cleanseGuard);
+        sfEventGuard::Scope addLevelGuard(m_addLevelGuard);
+        sfEventGuard::Scope objectModifiedGuard(m_objectModifiedGuard);
+        sfEventGuard::Scope levelTransformGuard(m_levelTransformGuard);
 
-    if (levelPtr != nullptr)
-    {
-        m_levelToObjectMap.Add(levelPtr, objPtr);
-        m_objectToLevelMap[objPtr] = levelPtr;
-        m_levelsToUpload.erase(levelPtr);
-    }
-    else
-    {
-        KS::Log::Error("Failed to load or create level " + std::string(TCHAR_TO_UTF8(*levelPath)) +
-            ". Disconnect.");
-        SceneFusion::Service->LeaveSession();
-        return;
-    }
+        levelPtr = FindLevelInLoadedLevels(levelPath, isPersistentLevel);
+        if (levelPtr == nullptr && !levelPath.StartsWith("/Temp") && FPackageName::DoesPackageExist(levelPath))
+        {
+            levelPtr = TryLoadLevelFromFile(levelPath, isPersistentLevel);
+        }
+        if (levelPtr == nullptr)
+        {
+            KS::Log::Warning("Could not find level " + std::string(TCHAR_TO_UTF8(*levelPath)) +
+                ". Please make sure that your project is up to date.");
+            levelPtr = CreateMap(levelPath, isPersistentLevel);
+        }
 
-    sfProperty::SPtr propPtr;
-    if (!isPersistentLevel) // If it is a streaming level, set transform and folder path on it.
-    {
-        ULevelStreaming* streamingLevelPtr = FLevelUtils::FindStreamingLevel(levelPtr);
-        if (streamingLevelPtr != nullptr)
+        if (levelPtr != nullptr)
         {
-            // Set level transform
-            if (propertiesPtr->TryGet(sfProp::Location, propPtr))
-            {
-                FTransform transform = streamingLevelPtr->LevelTransform;
-                transform.SetLocation(sfPropertyUtil::ToVector(propPtr));
-                FRotator rotation = transform.Rotator();
-                rotation.Yaw = propertiesPtr->Get(sfProp::Rotation)->AsValue()->GetValue();
-                transform.SetRotation(rotation.Quaternion());
-                sfUtils::PreserveUndoStack([streamingLevelPtr, transform]()
-                {
-                    FLevelUtils::SetEditorTransform(streamingLevelPtr, transform);
-                });
-                FDelegateHandle handle = levelPtr->OnApplyLevelTransform.AddLambda(
-                    [this, levelPtr](const FTransform& transform) {
-                    m_movedLevels.emplace(levelPtr);
-                });
-                m_onLevelTransformChangeHandles.Add(levelPtr, handle);
-            }
+            m_levelToObjectMap.Add(levelPtr, objPtr);
+            m_objectToLevelMap[objPtr] = levelPtr;
+            m_levelsToUpload.erase(levelPtr);
+        }
+        else
+        {
+            KS::Log::Error("Failed to load or create level " + std::string(TCHAR_TO_UTF8(*levelPath)) +
+                ". Disconnect.");
+            SceneFusion::Service->LeaveSession();
+            return;
+        }
 
-            // Set folder path
-            if (propertiesPtr->TryGet(sfProp::Folder, propPtr))
+        sfProperty::SPtr propPtr;
+        if (!isPersistentLevel) // If it is a streaming level, set transform and folder path on it.
+        {
+            ULevelStreaming* streamingLevelPtr = FLevelUtils::FindStreamingLevel(levelPtr);
+            if (streamingLevelPtr != nullptr)
             {
-                sfUtils::PreserveUndoStack([streamingLevelPtr, propPtr]()
+                // Set level transform
+                if (propertiesPtr->TryGet(sfProp::Location, propPtr))
+                {
+                    FTransform transform = streamingLevelPtr->LevelTransform;
+                    transform.SetLocation(sfPropertyUtil::ToVector(propPtr));
+                    FRotator rotation = transform.Rotator();
+                    rotation.Yaw = propertiesPtr->Get(sfProp::Rotation)->AsValue()->GetValue();
+                    transform.SetRotation(rotation.Quaternion());
+                    sfUtils::PreserveUndoStack([streamingLevelPtr, transform]()
+                    {
+                        FLevelUtils::SetEditorTransform(streamingLevelPtr, transform);
+                    });
+                    BindLevelTransformHandler(levelPtr);
+                }
+
+                // Set folder path
+                if (propertiesPtr->TryGet(sfProp::Folder, propPtr))
                 {
-                    streamingLevelPtr->SetFolderPath(*sfPropertyUtil::ToString(propPtr));
-                });
+                    sfUtils::PreserveUndoStack([streamingLevelPtr, propPtr]()
+                    {
+                        streamingLevelPtr->SetFolderPath(*sfPropertyUtil::ToString(propPtr));
+                    });
+                }
             }
         }
-    }
-
-    // Refresh levels window
-    FEditorDelegates::RefreshLevelBrowser.Broadcast();
 
-    // Add event handlers back
-    m_onPrepareToCleanseEditorObjectHandle = FEditorSupportDelegates::PrepareToCleanseEditorObject.AddRaw(
-        this,
-        &sfLevelManager::OnPrepareToCleanseEditorObject);
-    m_onAddLevelToWorldHandle = FEditorDelegates::OnAddLevelToWorld.AddRaw(this, &sfLevelManager::OnAddLevelToWorld);
-    m_onObjectModifiedHandle
-        = FCoreUObjectDelegates::OnObjectModified.AddRaw(this, &sfLevelManager::OnObjectModified);
+        // Refresh levels window
+        FEditorDelegates::RefreshLevelBrowser.Broadcast();
+    }
 
     SceneFusion::ActorManager->OnSFLevelObjectCreate(objPtr, levelPtr);
 
@@ -275,10 +267,10 @@ void sfLevelManager::OnDelete(sfObject::SPtr objPtr)
     ULevel* levelPtr = iter->second;
     m_objectToLevelMap.erase(iter);
     m_levelToObjectMap.Remove(levelPtr);
-    m_onLevelTransformChangeHandles.Remove(levelPtr);
+    UnbindLevelTransformHandler(levelPtr);
 
-    // Temporarily remove PrepareToCleanseEditorObject event handler
-    FEditorSupportDelegates::PrepareToCleanseEditorObject.Remove(m_onPrepareToCleanseEditorObjectHandle);
+    // Suppress PrepareToCleanseEditorObject events while removing the level
+    sfEventGuard::Scope guard(m_cleanseGuard);
 
     SceneFusion::ActorManager->OnRemoveLevel(levelPtr); // Remove actors in this level from actor manager
 
@@ -309,11 +301,6 @@ void sfLevelManager::OnDelete(sfObject::SPtr objPtr)
         GEditor->SelectActor(actorPtr, true, true, true);
     }
 
-    // Add PrepareToCleanseEditorObject event handler back
-    m_onPrepareToCleanseEditorObjectHandle = FEditorSupportDelegates::PrepareToCleanseEditorObject.AddRaw(
-        this,
-        &sfLevelManager::OnPrepareToCleanseEditorObject);
-
     // Refresh levels window
     FEditorDelegates::RefreshLevelBrowser.Broadcast();
 }
@@ -459,11 +446,7 @@ void sfLevelManager::UploadLevel(ULevel* levelPtr)
             FTransform transform = streamingLevelPtr->LevelTransform;
             propertiesPtr->Set(sfProp::Location, sfPropertyUtil::FromVector(transform.GetLocation()));
             propertiesPtr->Set(sfProp::Rotation, sfValueProperty::Create(transform.Rotator().Yaw));
-            FDelegateHandle handle = levelPtr->OnApplyLevelTransform.AddLambda(
-                [this, levelPtr](const FTransform& transform) {
-                m_movedLevels.emplace(levelPtr);
-            });
-            m_onLevelTransformChangeHandles.Add(levelPtr, handle);// Add transform change handler on level
+            BindLevelTransformHandler(levelPtr);
 
             // Set folder property
             propertiesPtr->Set(sfProp::Folder,
@@ -471,34 +454,46 @@ void sfLevelManager::UploadLevel(ULevel* levelPtr)
         }
     }
 
-    for (AActor* actorPtr : levelPtr->Actors)
-    {
-        if (SceneFusion::ActorManager->IsSyncable(actorPtr) && actorPtr->GetAttachParentActor() == nullptr)
-        {
-            sfObject::SPtr objPtr = SceneFusion::ActorManager->CreateObject(actorPtr);
-            if (objPtr != nullptr)
-            {
-                levelObjectPtr->AddChild(objPtr);
-            }
-        }
-    }
-
     // Add level to maps
     m_levelToObjectMap.Add(levelPtr, levelObjectPtr);
     m_objectToLevelMap[levelObjectPtr] = levelPtr;
 
     // Create
     m_sessionPtr->Create(levelObjectPtr);
+
+    // Root actors go into the actor manager's upload list so large levels are uploaded in batches over several ticks.
+    // Children are uploaded with their roots. Actors already in the list are skipped when they are uploaded, so we
+    // don't search the list for them here.
+    for (AActor* actorPtr : levelPtr->Actors)
+    {
+        if (actorPtr != nullptr)
+        {
+            SceneFusion::ActorManager->m_folderIndex.Update(actorPtr);
+        }
+        if (SceneFusion::ActorManager->IsSyncable(actorPtr) && actorPtr->GetAttachParentActor() == nullptr)
+        {
+            SceneFusion::ActorManager->m_uploadList.Add(actorPtr);
+        }
+    }
 }
 
 void sfLevelManager::OnAddLevelToWorld(ULevel* newLevelPtr)
 {
+    if (m_addLevelGuard.IsActive())
+    {
+        return;
+    }
     RequestLock();
     m_levelsToUpload.emplace(newLevelPtr);
 }
 
 void sfLevelManager::OnPrepareToCleanseEditorObject(UObject* uobjPtr)
 {
+    if (m_cleanseGuard.IsActive())
+    {
+        return;
+    }
+
     // Disconnect if the world is going to be destroyed
     UWorld* worldPtr = Cast<UWorld>(uobjPtr);
     if (worldPtr == m_worldPtr)
@@ -521,7 +516,7 @@ void sfLevelManager::OnPrepareToCleanseEditorObject(UObject* uobjPtr)
         m_levelsToUpload.erase(levelPtr);
         m_levelToObjectMap.Remove(levelPtr);
         m_objectToLevelMap.erase(levelObjPtr);
-        m_onLevelTransformChangeHandles.Remove(levelPtr);
+        UnbindLevelTransformHandler(levelPtr);
         if (levelObjPtr->IsLocked())
         {
             m_levelsNeedToBeLoaded.emplace(levelObjPtr);
@@ -657,6 +652,10 @@ void sfLevelManager::RegisterPropertyChangeHandlers()
 
 void sfLevelManager::OnObjectModified(UObject* uobjPtr)
 {
+    if (m_objectModifiedGuard.IsActive())
+    {
+        return;
+    }
     ULevelStreaming* streamingLevelPtr = Cast<ULevelStreaming>(uobjPtr);
     if (streamingLevelPtr != nullptr)
     {
@@ -724,21 +723,37 @@ void sfLevelManager::OnUndoRedo(FUndoSessionContext context, bool success)
 
 void sfLevelManager::ModifyLevelWithoutTriggerEvent(ULevel* levelPtr, Callback callback)
 {
-    // Temporarily remove event handlers
-    m_onLevelTransformChangeHandles.Remove(levelPtr);
-    FCoreUObjectDelegates::OnObjectModified.Remove(m_onObjectModifiedHandle);
+    BindLevelTransformHandler(levelPtr);
+    sfEventGuard::Scope levelTransformGuard(m_levelTransformGuard);
+    sfEventGuard::Scope objectModifiedGuard(m_objectModifiedGuard);
 
     // Invoke callback function and prevents any changes to the undo stack during the call.
     sfUtils::PreserveUndoStack(callback);
+}
 
-    // Add event handlers back
+void sfLevelManager::BindLevelTransformHandler(ULevel* levelPtr)
+{
+    if (m_onLevelTransformChangeHandles.Contains(levelPtr))
+    {
+        return;
+    }
     FDelegateHandle handle = levelPtr->OnApplyLevelTransform.AddLambda(
         [this, levelPtr](const FTransform& transform) {
-        m_movedLevels.emplace(levelPtr);
+        if (!m_levelTransformGuard.IsActive())
+        {
+            m_movedLevels.emplace(levelPtr);
+        }
     });
     m_onLevelTransformChangeHandles.Add(levelPtr, handle);
-    m_onObjectModifiedHandle
-        = FCoreUObjectDelegates::OnObjectModified.AddRaw(this, &sfLevelManager::OnObjectModified);
+}
+
+void sfLevelManager::UnbindLevelTransformHandler(ULevel* levelPtr)
+{
+    FDelegateHandle handle;
+    if (m_onLevelTransformChangeHandles.RemoveAndCopyValue(levelPtr, handle))
+    {
+        levelPtr->OnApplyLevelTransform.Remove(handle);
+    }
 }
 
 void sfLevelManager::OnDirectLockChange(sfObject::SPtr objPtr)
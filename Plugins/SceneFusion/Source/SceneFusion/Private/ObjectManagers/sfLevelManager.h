@@ -7,6 +7,7 @@
 #include <unordered_set>
 
 #include "IObjectManager.h"
+#include "../sfEventGuard.h"
 
 using namespace KS::SceneFusion2;
 using namespace KS;
@@ -121,6 +122,11 @@ private:
     FDelegateHandle m_onUndoHandle;
     FDelegateHandle m_onRedoHandle;
     TMap<ULevel*, FDelegateHandle> m_onLevelTransformChangeHandles;
+    // Guards that suppress editor event handlers while we apply server changes
+    sfEventGuard m_addLevelGuard;
+    sfEventGuard m_cleanseGuard;
+    sfEventGuard m_objectModifiedGuard;
+    sfEventGuard m_levelTransformGuard;
 
     std::unordered_map<sfName, PropertyChangeHandler> m_propertyChangeHandlers;
 
@@ -208,7 +214,7 @@ private:
     void OnUndoRedo(FUndoSessionContext context, bool success);
 
     /**
-     * Modifies a ULevel. Removes event handlers before and adds event handlers back after.
+     * Modifies a ULevel. Suppresses level transform and object modified events during the call.
      * Prevents any changes to the undo stack during the call.
      *
      * @param   ULevel* levelPtr to modify
@@ -216,6 +222,20 @@ private:
      */
     void ModifyLevelWithoutTriggerEvent(ULevel* levelPtr, Callback callback);
 
+    /**
+     * Adds a transform change handler to a level if it doesn't already have one.
+     *
+     * @param   ULevel* levelPtr to add transform change handler to.
+     */
+    void BindLevelTransformHandler(ULevel* levelPtr);
+
+    /**
+     * Removes the transform change handler from a level.
+     *
+     * @param   ULevel* levelPtr to remove transform change handler from.
+     */
+    void UnbindLevelTransformHandler(ULevel* levelPtr);
+
     /**
      * Uploads the given level.
      *
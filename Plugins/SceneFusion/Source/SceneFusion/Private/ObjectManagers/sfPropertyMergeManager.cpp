@@ -0,0 +1,216 @@
+#include "sfPropertyMergeManager.h"
+#include "../SceneFusion.h"
+#include "../sfConfig.h"
+#include "../Consts.h"
+#include "../sfUtils.h"
+
+#include <string>
+#include <vector>
+
+#define LOG_CHANNEL "sfPropertyMergeManager"
+
+sfPropertyMergeManager::sfPropertyMergeManager()
+{
+    // Properties that don't affect other properties, so edits to them can be merged without the actor's lock
+    m_mergedProperties.insert(sfProp::Label);
+    m_mergedProperties.insert(sfProp::Folder);
+}
+
+sfPropertyMergeManager::~sfPropertyMergeManager()
+{
+
+}
+
+void sfPropertyMergeManager::Initialize()
+{
+    m_sessionPtr = SceneFusion::Service->Session();
+    // The merge object is created even if we don't merge our own edits so users who do can use it
+    if (SceneFusion::IsSessionCreator)
+    {
+        m_rootPtr = sfObject::Create(sfType::PropertyMerge, sfDictionaryProperty::Create());
+        m_sessionPtr->Create(m_rootPtr);
+    }
+}
+
+void sfPropertyMergeManager::CleanUp()
+{
+    m_sessionPtr = nullptr;
+    m_rootPtr = nullptr;
+}
+
+bool sfPropertyMergeManager::IsMerged(const sfName& name) const
+{
+    return m_rootPtr != nullptr && sfConfig::Get().MergeIndependentProperties &&
+        m_mergedProperties.find(name) != m_mergedProperties.end();
+}
+
+sfProperty::SPtr sfPropertyMergeManager::GetValue(sfObject::SPtr objPtr, const sfName& name) const
+{
+    sfProperty::SPtr valuePtr = GetMergedValue(objPtr, name);
+    return valuePtr != nullptr ? valuePtr : objPtr->Property()->AsDict()->Get(name);
+}
+
+sfProperty::SPtr sfPropertyMergeManager::GetMergedValue(sfObject::SPtr objPtr, const sfName& name) const
+{
+    sfProperty::SPtr valuesPtr;
+    sfProperty::SPtr valuePtr;
+    if (m_rootPtr != nullptr && m_rootPtr->Property()->AsDict()->TryGet(GetKey(objPtr), valuesPtr) &&
+        valuesPtr->AsDict()->TryGet(name, valuePtr))
+    {
+        return valuePtr;
+    }
+    return nullptr;
+}
+
+bool sfPropertyMergeManager::SetValue(sfObject::SPtr objPtr, const sfName& name, sfProperty::SPtr valuePtr)
+{
+    if (!IsMerged(name))
+    {
+        return false;
+    }
+    sfDictionaryProperty::SPtr rootDictPtr = m_rootPtr->Property()->AsDict();
+    sfName key = GetKey(objPtr);
+    sfProperty::SPtr valuesPtr;
+    if (rootDictPtr->TryGet(key, valuesPtr))
+    {
+        valuesPtr->AsDict()->Set(name, valuePtr);
+    }
+    else
+    {
+        // Set the actor's values together so they are sent as one change
+        sfDictionaryProperty::SPtr newValuesPtr = sfDictionaryProperty::Create();
+        newValuesPtr->Set(name, valuePtr);
+        rootDictPtr->Set(key, newValuesPtr);
+    }
+    return true;
+}
+
+void sfPropertyMergeManager::ClearValue(sfObject::SPtr objPtr, const sfName& name)
+{
+    sfProperty::SPtr valuesPtr;
+    if (m_rootPtr == nullptr || !m_rootPtr->Property()->AsDict()->TryGet(GetKey(objPtr), valuesPtr))
+    {
+        return;
+    }
+    sfDictionaryProperty::SPtr valuesDictPtr = valuesPtr->AsDict();
+    if (valuesDictPtr->Remove(name) && valuesDictPtr->Size() == 0)
+    {
+        m_rootPtr->Property()->AsDict()->Remove(GetKey(objPtr));
+    }
+}
+
+void sfPropertyMergeManager::PruneValues()
+{
+    if (m_rootPtr == nullptr || m_rootPtr->Property()->AsDict()->Size() == 0)
+    {
+        return;
+    }
+    // Keys are collected first since removing them while iterating would invalidate the iterator
+    std::vector<sfName> deletedKeys;
+    for (auto iter : *m_rootPtr->Property()->AsDict())
+    {
+        sfObject::SPtr objPtr = GetActorObject(iter.second);
+        if (objPtr == nullptr || !objPtr->IsSyncing())
+        {
+            deletedKeys.push_back(iter.first);
+        }
+    }
+    for (const sfName& key : deletedKeys)
+    {
+        m_rootPtr->Property()->AsDict()->Remove(key);
+    }
+}
+
+void sfPropertyMergeManager::OnCreate(sfObject::SPtr objPtr, int childIndex)
+{
+    m_rootPtr = objPtr;
+    for (auto iter : *m_rootPtr->Property()->AsDict())
+    {
+        InvokeChanges(iter.second->AsDict());
+    }
+}
+
+void sfPropertyMergeManager::OnDelete(sfObject::SPtr objPtr)
+{
+    if (objPtr == m_rootPtr)
+    {
+        m_rootPtr = nullptr;
+    }
+}
+
+void sfPropertyMergeManager::OnPropertyChange(sfProperty::SPtr propertyPtr)
+{
+    switch (propertyPtr->GetDepth())
+    {
+        // An actor's first merged value
+        case 1:
+        {
+            InvokeChanges(propertyPtr->AsDict());
+            break;
+        }
+        case 2:
+        {
+            sfObject::SPtr objPtr = GetActorObject(propertyPtr->GetParentProperty());
+            if (objPtr != nullptr)
+            {
+                OnMergedValueChange.ExecuteIfBound(objPtr, propertyPtr->Key());
+            }
+            break;
+        }
+    }
+}
+
+void sfPropertyMergeManager::OnRemoveField(sfDictionaryProperty::SPtr dictPtr, const sfName& name)
+{
+    if (dictPtr->GetDepth() == 1)
+    {
+        sfObject::SPtr objPtr = GetActorObject(dictPtr);
+        if (objPtr != nullptr)
+        {
+            OnMergedValueChange.ExecuteIfBound(objPtr, name);
+        }
+        return;
+    }
+    // An actor's dictionary was removed. We don't know which values it had, so invoke changes for every merged
+    // property.
+    uint32_t id;
+    sfObject::SPtr objPtr = m_sessionPtr == nullptr || !sfUtils::TryParseId(*name, id) ? nullptr :
+        m_sessionPtr->GetObject(id);
+    if (objPtr != nullptr)
+    {
+        for (const sfName& propertyName : m_mergedProperties)
+        {
+            OnMergedValueChange.ExecuteIfBound(objPtr, propertyName);
+        }
+    }
+}
+
+void sfPropertyMergeManager::InvokeChanges(sfDictionaryProperty::SPtr valuesPtr)
+{
+    sfObject::SPtr objPtr = GetActorObject(valuesPtr);
+    if (objPtr == nullptr)
+    {
+        return;
+    }
+    for (auto iter : *valuesPtr)
+    {
+        OnMergedValueChange.ExecuteIfBound(objPtr, iter.first);
+    }
+}
+
+sfObject::SPtr sfPropertyMergeManager::GetActorObject(sfProperty::SPtr valuesPtr) const
+{
+    uint32_t id;
+    if (m_sessionPtr == nullptr || !sfUtils::TryParseId(*valuesPtr->Key(), id))
+    {
+        return nullptr;
+    }
+    return m_sessionPtr->GetObject(id);
+}
+
+sfName sfPropertyMergeManager::GetKey(sfObject::SPtr objPtr)
+{
+    return sfName(std::to_string(objPtr->Id()));
+}
+
+#undef LOG_CHANNEL
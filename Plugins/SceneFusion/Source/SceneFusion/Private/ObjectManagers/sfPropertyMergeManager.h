@@ -0,0 +1,173 @@
+#pragma once
+
+#include <CoreMinimal.h>
+#include <sfObject.h>
+#include <sfSession.h>
+#include <sfDictionaryProperty.h>
+#include <unordered_set>
+
+#include "IObjectManager.h"
+
+using namespace KS::SceneFusion2;
+using namespace KS;
+
+/**
+ * Lets users edit independent actor properties, such as the label and folder, on actors locked by other users. An
+ * edit to a merged property on a locked actor is stored in a merge object instead of the actor's object. The merge
+ * object is never locked, so edits from different users to different properties merge, and merged edits to the same
+ * property are last-writer-wins in server order. A merged value overrides the actor object's value until the lock
+ * holder receives it and applies it to the actor's object, or until a user who can edit the actor sets the property on
+ * the actor's object. Either one clears the merged value. Because the lock holder applies merged values when it
+ * receives them, a merged edit wins over an edit the lock holder made before receiving it, even if the lock holder's
+ * edit reached the server later. The merge object is a dictionary of actor object ids to dictionaries of merged
+ * values, and is created by the session creator. Values for deleted actor objects are removed by PruneValues.
+ */
+class sfPropertyMergeManager : public IObjectManager
+{
+public:
+    /**
+     * Delegate for merged value changes.
+     *
+     * @param   sfObject::SPtr - actor object whose merged value changed.
+     * @param   const sfName& - name of the property that changed.
+     */
+    DECLARE_DELEGATE_TwoParams(OnMergedValueChangeDelegate, sfObject::SPtr, const sfName&);
+
+    /**
+     * Invoked when another user sets or clears a merged value.
+     */
+    OnMergedValueChangeDelegate OnMergedValueChange;
+
+    /**
+     * Constructor
+     */
+    sfPropertyMergeManager();
+
+    /**
+     * Destructor
+     */
+    virtual ~sfPropertyMergeManager();
+
+    /**
+     * Initialization. Called after connecting to a session. Creates the merge object if we created the session.
+     */
+    virtual void Initialize() override;
+
+    /**
+     * Deinitialization. Called after disconnecting from a session.
+     */
+    virtual void CleanUp() override;
+
+    /**
+     * Checks if edits to a property are merged on actors locked by other users. Only true when merging is enabled in
+     * the config and the session has a merge object.
+     *
+     * @param   const sfName& name of the property.
+     * @return  bool
+     */
+    bool IsMerged(const sfName& name) const;
+
+    /**
+     * Gets a property's value for an actor object. This is the merged value if there is one, otherwise the value on
+     * the actor's object.
+     *
+     * @param   sfObject::SPtr objPtr for the actor.
+     * @param   const sfName& name of the property.
+     * @return  sfProperty::SPtr value, or nullptr if the property is not set.
+     */
+    sfProperty::SPtr GetValue(sfObject::SPtr objPtr, const sfName& name) const;
+
+    /**
+     * Gets the merged value of a property for an actor object.
+     *
+     * @param   sfObject::SPtr objPtr for the actor.
+     * @param   const sfName& name of the property.
+     * @return  sfProperty::SPtr merged value, or nullptr if the property has no merged value.
+     */
+    sfProperty::SPtr GetMergedValue(sfObject::SPtr objPtr, const sfName& name) const;
+
+    /**
+     * Sets the merged value of a property for an actor object.
+     *
+     * @param   sfObject::SPtr objPtr for the actor.
+     * @param   const sfName& name of the property.
+     * @param   sfProperty::SPtr valuePtr to set.
+     * @return  bool false if the property is not merged.
+     */
+    bool SetValue(sfObject::SPtr objPtr, const sfName& name, sfProperty::SPtr valuePtr);
+
+    /**
+     * Clears the merged value of a property for an actor object so the value on the actor's object is used. Call
+     * after setting the property on the actor's object.
+     *
+     * @param   sfObject::SPtr objPtr for the actor.
+     * @param   const sfName& name of the property.
+     */
+    void ClearValue(sfObject::SPtr objPtr, const sfName& name);
+
+    /**
+     * Removes the merged values of actor objects that were deleted. Call after deleting actor objects or receiving
+     * deletes from the server.
+     */
+    void PruneValues();
+
+private:
+    sfSession::SPtr m_sessionPtr;
+    sfObject::SPtr m_rootPtr;
+    // Properties whose edits are merged
+    std::unordered_set<sfName> m_mergedProperties;
+
+    /**
+     * Called when the merge object is created by another user. Invokes OnMergedValueChange for its values.
+     *
+     * @param   sfObject::SPtr objPtr that was created.
+     * @param   int childIndex of new object. -1 if object is a root
+     */
+    virtual void OnCreate(sfObject::SPtr objPtr, int childIndex) override;
+
+    /**
+     * Called when the merge object is deleted.
+     *
+     * @param   sfObject::SPtr objPtr that was deleted.
+     */
+    virtual void OnDelete(sfObject::SPtr objPtr) override;
+
+    /**
+     * Called when another user sets merged values. Invokes OnMergedValueChange for them.
+     *
+     * @param   sfProperty::SPtr propertyPtr that changed.
+     */
+    virtual void OnPropertyChange(sfProperty::SPtr propertyPtr) override;
+
+    /**
+     * Called when another user clears a merged value or an actor's merged values. Invokes OnMergedValueChange for
+     * them.
+     *
+     * @param   sfDictionaryProperty::SPtr dictPtr the field was removed from.
+     * @param   const sfName& name of removed field.
+     */
+    virtual void OnRemoveField(sfDictionaryProperty::SPtr dictPtr, const sfName& name) override;
+
+    /**
+     * Invokes OnMergedValueChange for each value in an actor's dictionary of merged values.
+     *
+     * @param   sfDictionaryProperty::SPtr valuesPtr - dictionary of merged values keyed by property name.
+     */
+    void InvokeChanges(sfDictionaryProperty::SPtr valuesPtr);
+
+    /**
+     * Gets the actor object for a dictionary of merged values.
+     *
+     * @param   sfProperty::SPtr valuesPtr - dictionary of merged values keyed by property name.
+     * @return  sfObject::SPtr actor object, or nullptr if it was deleted.
+     */
+    sfObject::SPtr GetActorObject(sfProperty::SPtr valuesPtr) const;
+
+    /**
+     * Gets the merge object key for an actor object.
+     *
+     * @param   sfObject::SPtr objPtr for the actor.
+     * @return  sfName
+     */
+    static sfName GetKey(sfObject::SPtr objPtr);
+};
@@ -5,6 +5,9 @@
 #include "Testing/sfTestUtil.h"
 #include "Consts.h"
 #include "sfConfig.h"
+#include "sfAssetCache.h"
+#include "sfPackedTransform.h"
+#include "sfPropertySchema.h"
 
 #include <Runtime/Projects/Public/Interfaces/IPluginManager.h>
 #include <Editor.h>
@@ -37,11 +40,18 @@ void SceneFusion::StartupModule()
     m_levelManagerPtr = MakeShareable(new sfLevelManager);
     ObjectEventDispatcher->Register(sfType::Level, m_levelManagerPtr);
     ObjectEventDispatcher->Register(sfType::LevelLock, m_levelManagerPtr);
-    ActorManager = MakeShareable(new sfActorManager(m_levelManagerPtr));
-    ObjectEventDispatcher->Register(sfType::Actor, ActorManager);
+    m_assetDictionaryManagerPtr = MakeShareable(new sfAssetDictionaryManager);
+    ObjectEventDispatcher->Register(sfType::AssetDictionary, m_assetDictionaryManagerPtr);
+    m_folderManagerPtr = MakeShareable(new sfFolderManager);
+    ObjectEventDispatcher->Register(sfType::Folder, m_folderManagerPtr);
+    m_propertyMergeManagerPtr = MakeShareable(new sfPropertyMergeManager);
+    ObjectEventDispatcher->Register(sfType::PropertyMerge, m_propertyMergeManagerPtr);
+    ActorManager = MakeShareable(new sfActorManager(m_levelManagerPtr, m_assetDictionaryManagerPtr,
+        m_folderManagerPtr, m_propertyMergeManagerPtr));
+    ObjectEventDispatcher->Register(sfType::Actor, ActorManager, true);
 
     AvatarManager = MakeShareable(new sfAvatarManager);
-    ObjectEventDispatcher->Register(sfType::Avatar, AvatarManager);
+    ObjectEventDispatcher->Register(sfType::Avatar, AvatarManager, true);
 
     if (FSlateApplication::IsInitialized())
     {
@@ -55,6 +65,8 @@ void SceneFusion::StartupModule()
     }
 
     sfTestUtil::RegisterCommands();
+    sfAssetCache::Initialize();
+    sfPackedTransform::Initialize();
 
     // Register an FTickerDelegate to be called 60 times per second.
     m_updateHandle = FTicker::GetCoreTicker().AddTicker(
@@ -67,6 +79,8 @@ void SceneFusion::ShutdownModule()
 
     m_sfUIPtr.Reset();
     sfTestUtil::CleanUp();
+    sfAssetCache::CleanUp();
+    sfPackedTransform::CleanUp();
     m_sfUIPtr.Reset();
     if (FSlateApplication::IsInitialized())
     {
@@ -78,12 +92,15 @@ void SceneFusion::ShutdownModule()
 
 void SceneFusion::OnConnect()
 {
+    sfPropertySchema::Initialize();
     ObjectEventDispatcher->Initialize();
 }
 
 void SceneFusion::OnDisconnect()
 {
     ObjectEventDispatcher->CleanUp();
+    sfAssetCache::Clear();
+    sfPropertySchema::CleanUp();
     SetDetailPanelEnabled(true);
 }
 
@@ -92,10 +109,16 @@ bool SceneFusion::Tick(float deltaTime)
     Service->Update(deltaTime);
     if (Service->Session() != nullptr && Service->Session()->IsConnected())
     {
+        ObjectEventDispatcher->ApplyEvents();
         if (m_levelManagerPtr.IsValid())
         {
             m_levelManagerPtr->Tick();
         }
+        // Folder changes are sent before actor folder changes so actors in a renamed folder keep their folder ids
+        if (m_folderManagerPtr.IsValid())
+        {
+            m_folderManagerPtr->Tick();
+        }
         if (ActorManager.IsValid())
         {
             ActorManager->Tick(deltaTime);
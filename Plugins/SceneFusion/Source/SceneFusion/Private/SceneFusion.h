@@ -9,6 +9,9 @@
 #include "ObjectManagers/sfActorManager.h"
 #include "ObjectManagers/sfAvatarManager.h"
 #include "ObjectManagers/sfLevelManager.h"
+#include "ObjectManagers/sfAssetDictionaryManager.h"
+#include "ObjectManagers/sfFolderManager.h"
+#include "ObjectManagers/sfPropertyMergeManager.h"
 
 #include <LevelEditor.h>
 #include <CoreMinimal.h>
@@ -91,6 +94,9 @@ private:
     FDelegateHandle m_updateHandle;
     FAreObjectsEditable m_editableObjectPredicate;
     TSharedPtr<sfLevelManager> m_levelManagerPtr;
+    TSharedPtr<sfAssetDictionaryManager> m_assetDictionaryManagerPtr;
+    TSharedPtr<sfFolderManager> m_folderManagerPtr;
+    TSharedPtr<sfPropertyMergeManager> m_propertyMergeManagerPtr;
     
     /**
      * Register selection predicate for detail panel.
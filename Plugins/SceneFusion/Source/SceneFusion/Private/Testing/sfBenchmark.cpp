@@ -0,0 +1,614 @@
+#include "sfBenchmark.h"
+#include "sfCountingMalloc.h"
+#include "../sfActorRegistry.h"
+#include "../sfActorUtil.h"
+#include "../sfEventGuard.h"
+#include "../sfLevelNameIndex.h"
+#include "../sfLockBatch.h"
+#include "../sfLockRenderer.h"
+#include "../sfPropertySchema.h"
+#include "../sfPropertyUtil.h"
+#include "../Consts.h"
+
+#include <Log.h>
+#include <Editor.h>
+#include <LevelEditorViewport.h>
+#include <RHI.h>
+#include <RenderingThread.h>
+#include <ShaderCompiler.h>
+#include <Engine/StaticMeshActor.h>
+#include <Engine/PostProcessVolume.h>
+#include <sfDictionaryProperty.h>
+#include <map>
+#include <vector>
+
+#define DEFAULT_REGISTRY_COUNT 100000
+#define DEFAULT_NAMES_COUNT 50000
+// Searching the level for every actor is quadratic, so only this many searches are timed
+#define MAX_LEVEL_SEARCHES 1000
+#define DEFAULT_LOCKS_COUNT 5000
+// Distance in cm from the camera to the grid of actors locked by the locks benchmark
+#define LOCKS_GRID_DISTANCE 2000.0f
+#define DEFAULT_SUBTREE_COUNT 1000
+#define DEFAULT_SCHEMA_COUNT 2000
+#define DEFAULT_PATHS_COUNT 100000
+#define DEFAULT_GUARDS_COUNT 100000
+#define LOG_CHANNEL "sfBenchmark"
+
+void sfBenchmark::Run(const TArray<FString>& args)
+{
+    if (args.Num() == 0 || args[0].Equals("registry", ESearchCase::IgnoreCase))
+    {
+        int count = args.Num() > 1 ? FCString::Atoi(*args[1]) : DEFAULT_REGISTRY_COUNT;
+        ActorRegistry(count > 0 ? count : DEFAULT_REGISTRY_COUNT);
+        return;
+    }
+    if (args[0].Equals("names", ESearchCase::IgnoreCase))
+    {
+        int count = args.Num() > 1 ? FCString::Atoi(*args[1]) : DEFAULT_NAMES_COUNT;
+        Names(count > 0 ? count : DEFAULT_NAMES_COUNT);
+        return;
+    }
+    if (args[0].Equals("locks", ESearchCase::IgnoreCase))
+    {
+        int count = args.Num() > 1 ? FCString::Atoi(*args[1]) : DEFAULT_LOCKS_COUNT;
+        Locks(count > 0 ? count : DEFAULT_LOCKS_COUNT);
+        return;
+    }
+    if (args[0].Equals("subtree", ESearchCase::IgnoreCase))
+    {
+        int count = args.Num() > 1 ? FCString::Atoi(*args[1]) : DEFAULT_SUBTREE_COUNT;
+        SubtreeLocks(count > 0 ? count : DEFAULT_SUBTREE_COUNT);
+        return;
+    }
+    if (args[0].Equals("schema", ESearchCase::IgnoreCase))
+    {
+        int count = args.Num() > 1 ? FCString::Atoi(*args[1]) : DEFAULT_SCHEMA_COUNT;
+        PropertySchema(count > 0 ? count : DEFAULT_SCHEMA_COUNT);
+        return;
+    }
+    if (args[0].Equals("paths", ESearchCase::IgnoreCase))
+    {
+        int count = args.Num() > 1 ? FCString::Atoi(*args[1]) : DEFAULT_PATHS_COUNT;
+        PropertyPaths(count > 0 ? count : DEFAULT_PATHS_COUNT);
+        return;
+    }
+    if (args[0].Equals("guards", ESearchCase::IgnoreCase))
+    {
+        int count = args.Num() > 1 ? FCString::Atoi(*args[1]) : DEFAULT_GUARDS_COUNT;
+        EventGuards(count > 0 ? count : DEFAULT_GUARDS_COUNT);
+        return;
+    }
+    KS::Log::Warning("Unknown benchmark " + std::string(TCHAR_TO_UTF8(*args[0])), LOG_CHANNEL);
+}
+
+void sfBenchmark::ActorRegistry(int count)
+{
+    // Actors are created outside of any level so the editor does not send events for them.
+    std::vector<AActor*> actors;
+    std::vector<sfObject::SPtr> objects;
+    actors.reserve(count);
+    objects.reserve(count);
+    sfActorRegistry registry;
+    std::map<sfObject::SPtr, AActor*> objectToActorMap;
+    TMap<AActor*, sfObject::SPtr> actorToObjectMap;
+    for (int i = 0; i < count; i++)
+    {
+        AActor* actorPtr = NewObject<AActor>(GetTransientPackage(), NAME_None, RF_Transient);
+        sfObject::SPtr objPtr = sfObject::Create(sfType::Actor, sfDictionaryProperty::Create());
+        actors.push_back(actorPtr);
+        objects.push_back(objPtr);
+        registry.Add(actorPtr, objPtr);
+        objectToActorMap[objPtr] = actorPtr;
+        actorToObjectMap.Add(actorPtr, objPtr);
+    }
+
+    // Look up in random order so the benchmark isn't helped by entries being adjacent in memory.
+    std::vector<int> order(count);
+    for (int i = 0; i < count; i++)
+    {
+        order[i] = i;
+    }
+    FRandomStream random(count);
+    for (int i = count - 1; i > 0; i--)
+    {
+        std::swap(order[i], order[random.RandRange(0, i)]);
+    }
+
+    int found = 0;
+    double startTime = FPlatformTime::Seconds();
+    for (int i : order)
+    {
+        found += registry.FindActor(objects[i]) != nullptr;
+    }
+    double registryActorTime = FPlatformTime::Seconds() - startTime;
+
+    startTime = FPlatformTime::Seconds();
+    for (int i : order)
+    {
+        found += registry.FindObject(actors[i]) != nullptr;
+    }
+    double registryObjectTime = FPlatformTime::Seconds() - startTime;
+
+    startTime = FPlatformTime::Seconds();
+    for (int i : order)
+    {
+        found += objectToActorMap.find(objects[i]) != objectToActorMap.end();
+    }
+    double mapActorTime = FPlatformTime::Seconds() - startTime;
+
+    startTime = FPlatformTime::Seconds();
+    for (int i : order)
+    {
+        found += actorToObjectMap.FindRef(actors[i]) != nullptr;
+    }
+    double mapObjectTime = FPlatformTime::Seconds() - startTime;
+
+    double toNanoseconds = 1000000000.0 / count;
+    KS::Log::Info("Actor registry with " + std::to_string(count) + " actors (" + std::to_string(found) +
+        " lookups found):", LOG_CHANNEL);
+    KS::Log::Info("  Registry object -> actor: " + std::to_string(registryActorTime * toNanoseconds) +
+        " ns per lookup", LOG_CHANNEL);
+    KS::Log::Info("  Registry actor -> object: " + std::to_string(registryObjectTime * toNanoseconds) +
+        " ns per lookup", LOG_CHANNEL);
+    KS::Log::Info("  std::map object -> actor: " + std::to_string(mapActorTime * toNanoseconds) +
+        " ns per lookup", LOG_CHANNEL);
+    KS::Log::Info("  TMap actor -> object: " + std::to_string(mapObjectTime * toNanoseconds) +
+        " ns per lookup", LOG_CHANNEL);
+
+    for (AActor* actorPtr : actors)
+    {
+        actorPtr->MarkPendingKill();
+    }
+}
+
+void sfBenchmark::Names(int count)
+{
+    // Each method renames actors in its own level so the names from one method don't collide with the other's.
+    ULevel* counterLevelPtr = NewObject<ULevel>(GetTransientPackage(), NAME_None, RF_Transient);
+    ULevel* randomLevelPtr = NewObject<ULevel>(GetTransientPackage(), NAME_None, RF_Transient);
+    FString name = "sfBenchmarkActor";
+    std::vector<AActor*> actors;
+    actors.reserve(count * 2);
+
+    double startTime = FPlatformTime::Seconds();
+    for (int i = 0; i < count; i++)
+    {
+        AActor* actorPtr = NewObject<AActor>(counterLevelPtr, NAME_None, RF_Transient);
+        sfActorUtil::Rename(actorPtr, name);
+        counterLevelPtr->Actors.Add(actorPtr);
+        actors.push_back(actorPtr);
+    }
+    double counterTime = FPlatformTime::Seconds() - startTime;
+
+    int64 randomAttempts = 0;
+    startTime = FPlatformTime::Seconds();
+    for (int i = 0; i < count; i++)
+    {
+        AActor* actorPtr = NewObject<AActor>(randomLevelPtr, NAME_None, RF_Transient);
+        FString randomName = name;
+        randomAttempts++;
+        while (!actorPtr->Rename(*randomName, nullptr, REN_Test))
+        {
+            randomName += FString::FromInt(rand() % 10);
+            randomAttempts++;
+        }
+        actorPtr->Rename(*randomName);
+        randomLevelPtr->Actors.Add(actorPtr);
+        actors.push_back(actorPtr);
+    }
+    double randomTime = FPlatformTime::Seconds() - startTime;
+
+    int found = 0;
+    startTime = FPlatformTime::Seconds();
+    sfLevelNameIndex nameIndex(counterLevelPtr);
+    for (AActor* actorPtr : counterLevelPtr->Actors)
+    {
+        found += nameIndex.Contains(actorPtr) && nameIndex.FindOther(actorPtr) == nullptr;
+    }
+    double indexTime = FPlatformTime::Seconds() - startTime;
+
+    int searches = FMath::Min(count, MAX_LEVEL_SEARCHES);
+    startTime = FPlatformTime::Seconds();
+    for (int i = 0; i < searches; i++)
+    {
+        AActor* actorPtr = counterLevelPtr->Actors[i];
+        bool inLevel = false;
+        for (AActor* otherPtr : counterLevelPtr->Actors)
+        {
+            if (otherPtr == actorPtr)
+            {
+                inLevel = true;
+            }
+            else if (otherPtr->GetFName() == actorPtr->GetFName())
+            {
+                inLevel = false;
+                break;
+            }
+        }
+        found += inLevel;
+    }
+    double searchTime = (FPlatformTime::Seconds() - startTime) * count / searches;
+
+    KS::Log::Info("Renaming " + std::to_string(count) + " actors to " + std::string(TCHAR_TO_UTF8(*name)) + ":",
+        LOG_CHANNEL);
+    KS::Log::Info("  Rename counter: " + std::to_string(counterTime * 1000.0) + " ms", LOG_CHANNEL);
+    KS::Log::Info("  Random digits: " + std::to_string(randomTime * 1000.0) + " ms, " +
+        std::to_string((double)randomAttempts / count) + " attempts per actor", LOG_CHANNEL);
+    KS::Log::Info("Finding name collisions (" + std::to_string(found) + " actors without collisions):", LOG_CHANNEL);
+    KS::Log::Info("  Level name index: " + std::to_string(indexTime * 1000.0) + " ms", LOG_CHANNEL);
+    KS::Log::Info("  Level search per actor: " + std::to_string(searchTime * 1000.0) + " ms (estimated from " +
+        std::to_string(searches) + " searches)", LOG_CHANNEL);
+
+    for (AActor* actorPtr : actors)
+    {
+        actorPtr->MarkPendingKill();
+    }
+    counterLevelPtr->MarkPendingKill();
+    randomLevelPtr->MarkPendingKill();
+}
+
+void sfBenchmark::Locks(int count)
+{
+    // Actors are transient so they are not saved or synced. They are put in a grid in front of the camera so they are
+    // drawn.
+    UWorld* worldPtr = GEditor->GetEditorWorldContext().World();
+    UStaticMesh* meshPtr = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+    FVector center = FVector::ZeroVector;
+    FRotator rotation = FRotator::ZeroRotator;
+    if (GCurrentLevelEditingViewportClient)
+    {
+        center = GCurrentLevelEditingViewportClient->GetViewLocation();
+        rotation = GCurrentLevelEditingViewportClient->GetViewRotation();
+    }
+    center += rotation.Vector() * LOCKS_GRID_DISTANCE;
+    FVector right = FRotationMatrix(rotation).GetScaledAxis(EAxis::Y);
+    FVector up = FRotationMatrix(rotation).GetScaledAxis(EAxis::Z);
+    int columns = FMath::CeilToInt(FMath::Sqrt((float)count));
+    float spacing = LOCKS_GRID_DISTANCE / columns;
+    FActorSpawnParameters spawnParams;
+    spawnParams.ObjectFlags = RF_Transient;
+    spawnParams.bHideFromSceneOutliner = true;
+    std::vector<AActor*> actors;
+    actors.reserve(count);
+    for (int i = 0; i < count; i++)
+    {
+        FVector location = center + right * ((i % columns - columns / 2) * spacing) +
+            up * ((i / columns - columns / 2) * spacing);
+        AStaticMeshActor* actorPtr = worldPtr->SpawnActor<AStaticMeshActor>(location, rotation, spawnParams);
+        actorPtr->GetStaticMeshComponent()->SetStaticMesh(meshPtr);
+        actorPtr->SetActorScale3D(FVector(spacing * 0.5f / 100.0f));
+        actors.push_back(actorPtr);
+    }
+
+    KS::Log::Info("Locking " + std::to_string(count) + " actors:", LOG_CHANNEL);
+    // Draw calls are measured from frames of the viewport, so they include the custom depth and post-process passes
+    // outlines add.
+    int unlockedDraws = DrawViewport();
+    if (unlockedDraws < 0)
+    {
+        KS::Log::Info("  Draw calls are not measured because there is no level editor viewport", LOG_CHANNEL);
+    }
+    sfLockRenderer::Mode modes[] = { sfLockRenderer::DuplicateMeshes, sfLockRenderer::Outlines };
+    for (sfLockRenderer::Mode mode : modes)
+    {
+        sfLockRenderer renderer;
+        renderer.Initialize(mode);
+
+        double startTime = FPlatformTime::Seconds();
+        for (AActor* actorPtr : actors)
+        {
+            renderer.Lock(actorPtr, nullptr);
+        }
+        double lockTime = FPlatformTime::Seconds() - startTime;
+
+        int addedComponents = 0;
+        for (AActor* actorPtr : actors)
+        {
+            TArray<UsfLockComponent*> locks;
+            sfActorUtil::GetSceneComponents<UsfLockComponent>(actorPtr, locks);
+            for (UsfLockComponent* lockPtr : locks)
+            {
+                addedComponents += 1 + lockPtr->GetNumChildrenComponents();
+            }
+        }
+        // Outline materials compile asynchronously, so wait for them before drawing
+        if (mode == sfLockRenderer::Outlines && GShaderCompilingManager != nullptr)
+        {
+            GShaderCompilingManager->FinishAllCompilation();
+        }
+        int lockedDraws = DrawViewport();
+
+        startTime = FPlatformTime::Seconds();
+        for (AActor* actorPtr : actors)
+        {
+            renderer.Unlock(actorPtr);
+        }
+        double unlockTime = FPlatformTime::Seconds() - startTime;
+
+        std::string draws = unlockedDraws < 0 ? "" : ", " + std::to_string(lockedDraws - unlockedDraws) +
+            " draw calls added to " + std::to_string(unlockedDraws);
+        KS::Log::Info(std::string("  ") + (mode == sfLockRenderer::Outlines ? "Outlines" : "Duplicate meshes") +
+            ": lock " + std::to_string(lockTime * 1000.0) + " ms, unlock " + std::to_string(unlockTime * 1000.0) +
+            " ms, " + std::to_string(addedComponents) + " components added" + draws, LOG_CHANNEL);
+        renderer.CleanUp();
+    }
+
+    for (AActor* actorPtr : actors)
+    {
+        worldPtr->DestroyActor(actorPtr);
+    }
+}
+
+int sfBenchmark::DrawViewport()
+{
+    if (!GCurrentLevelEditingViewportClient || GCurrentLevelEditingViewportClient->Viewport == nullptr)
+    {
+        return -1;
+    }
+    // The RHI resets the draw call count at the start of each frame, so after the render thread finishes the frame
+    // it holds the frame's draw calls.
+    GCurrentLevelEditingViewportClient->Viewport->Draw();
+    FlushRenderingCommands();
+    return GNumDrawCallsRHI;
+}
+
+void sfBenchmark::SubtreeLocks(int count)
+{
+    // Objects are not synced, so lock requests are not sent to the server.
+    sfObject::SPtr rootPtr = sfObject::Create(sfType::Actor, sfDictionaryProperty::Create());
+    std::vector<sfObject::SPtr> objects;
+    objects.reserve(count + 1);
+    objects.push_back(rootPtr);
+    for (int i = 0; i < count; i++)
+    {
+        sfObject::SPtr childPtr = sfObject::Create(sfType::Actor, sfDictionaryProperty::Create());
+        rootPtr->AddChild(childPtr);
+        objects.push_back(childPtr);
+    }
+
+    KS::Log::Info("Locking an actor and its " + std::to_string(count) + " children:", LOG_CHANNEL);
+    bool modes[] = { false, true };
+    for (bool subtreeLocks : modes)
+    {
+        sfLockBatch batch;
+        batch.SetSubtreeLocks(subtreeLocks);
+        // Children are requested first, as they would be if they were selected before the root
+        for (int i = count; i >= 0; i--)
+        {
+            batch.Request(objects[i]);
+        }
+        double startTime = FPlatformTime::Seconds();
+        int requests = (int)batch.Send().size();
+        double lockTime = FPlatformTime::Seconds() - startTime;
+
+        // Sending with nothing queued checks that covered objects are still covered
+        startTime = FPlatformTime::Seconds();
+        batch.Send();
+        double checkTime = FPlatformTime::Seconds() - startTime;
+
+        for (const sfObject::SPtr& objPtr : objects)
+        {
+            batch.Release(objPtr);
+        }
+        startTime = FPlatformTime::Seconds();
+        batch.Send();
+        double releaseTime = FPlatformTime::Seconds() - startTime;
+
+        KS::Log::Info(std::string("  ") + (subtreeLocks ? "Subtree lock" : "Lock per object") + ": " +
+            std::to_string(requests) + " lock requests, lock " + std::to_string(lockTime * 1000.0) + " ms, " +
+            "coverage check " + std::to_string(checkTime * 1000.0) + " ms per tick, release " +
+            std::to_string(releaseTime * 1000.0) + " ms", LOG_CHANNEL);
+    }
+}
+
+void sfBenchmark::PropertySchema(int count)
+{
+    // Actors are created outside of any level so the editor does not send events for them.
+    std::vector<AActor*> actors;
+    actors.reserve(count);
+    for (int i = 0; i < count; i++)
+    {
+        AStaticMeshActor* actorPtr = NewObject<AStaticMeshActor>(GetTransientPackage(), NAME_None, RF_Transient);
+        // Give the actors some non-default values
+        actorPtr->bHidden = i % 2 == 0;
+        actorPtr->Tags.Add(FName("sfBenchmark"));
+        actors.push_back(actorPtr);
+    }
+    std::vector<sfDictionaryProperty::SPtr> iterationDicts;
+    std::vector<sfDictionaryProperty::SPtr> schemaDicts;
+    iterationDicts.reserve(count);
+    schemaDicts.reserve(count);
+
+    // This is how properties were created before schemas were cached
+    double startTime = FPlatformTime::Seconds();
+    for (AActor* actorPtr : actors)
+    {
+        sfDictionaryProperty::SPtr dictPtr = sfDictionaryProperty::Create();
+        for (TFieldIterator<UProperty> iter(actorPtr->GetClass()); iter; ++iter)
+        {
+            if (iter->PropertyFlags & CPF_Edit && !(iter->PropertyFlags & CPF_DisableEditOnInstance) &&
+                !sfPropertyUtil::IsDefaultValue(actorPtr, *iter))
+            {
+                sfProperty::SPtr propPtr = sfPropertyUtil::GetValue(actorPtr, *iter);
+                if (propPtr != nullptr)
+                {
+                    dictPtr->Set(std::string(TCHAR_TO_UTF8(*iter->GetName())), propPtr);
+                }
+            }
+        }
+        iterationDicts.push_back(dictPtr);
+    }
+    double iterationCreateTime = FPlatformTime::Seconds() - startTime;
+
+    startTime = FPlatformTime::Seconds();
+    for (int i = 0; i < count; i++)
+    {
+        AActor* actorPtr = actors[i];
+        for (TFieldIterator<UProperty> iter(actorPtr->GetClass()); iter; ++iter)
+        {
+            if (iter->PropertyFlags & CPF_Edit && !(iter->PropertyFlags & CPF_DisableEditOnInstance))
+            {
+                sfProperty::SPtr propPtr;
+                if (!iterationDicts[i]->TryGet(std::string(TCHAR_TO_UTF8(*iter->GetName())), propPtr))
+                {
+                    sfPropertyUtil::SetToDefaultValue(actorPtr, *iter);
+                }
+                else
+                {
+                    sfPropertyUtil::SetValue(
+                        sfUPropertyInstance(*iter, iter->ContainerPtrToValuePtr<void>(actorPtr)), propPtr);
+                }
+            }
+        }
+    }
+    double iterationApplyTime = FPlatformTime::Seconds() - startTime;
+
+    // Time building the schema separately since it only happens once per class
+    startTime = FPlatformTime::Seconds();
+    TSharedPtr<const sfPropertySchema::Schema> schemaPtr = sfPropertySchema::Get(AStaticMeshActor::StaticClass());
+    double buildTime = FPlatformTime::Seconds() - startTime;
+
+    startTime = FPlatformTime::Seconds();
+    for (AActor* actorPtr : actors)
+    {
+        sfDictionaryProperty::SPtr dictPtr = sfDictionaryProperty::Create();
+        sfPropertyUtil::CreateProperties(actorPtr, dictPtr);
+        schemaDicts.push_back(dictPtr);
+    }
+    double schemaCreateTime = FPlatformTime::Seconds() - startTime;
+
+    startTime = FPlatformTime::Seconds();
+    for (int i = 0; i < count; i++)
+    {
+        sfPropertyUtil::ApplyProperties(actors[i], schemaDicts[i]);
+    }
+    double schemaApplyTime = FPlatformTime::Seconds() - startTime;
+
+    int iterationFields = 0;
+    int schemaFields = 0;
+    for (int i = 0; i < count; i++)
+    {
+        iterationFields += iterationDicts[i]->Size();
+        schemaFields += schemaDicts[i]->Size();
+    }
+    double toMicroseconds = 1000000.0 / count;
+    KS::Log::Info("Property dictionaries for " + std::to_string(count) + " static mesh actors (" +
+        std::to_string(schemaPtr->Fields.Num()) + " syncable properties per actor):", LOG_CHANNEL);
+    KS::Log::Info("  Iterating properties: create " + std::to_string(iterationCreateTime * toMicroseconds) +
+        " us, apply " + std::to_string(iterationApplyTime * toMicroseconds) + " us per actor, " +
+        std::to_string(iterationFields) + " fields", LOG_CHANNEL);
+    KS::Log::Info("  Cached schema: create " + std::to_string(schemaCreateTime * toMicroseconds) + " us, apply " +
+        std::to_string(schemaApplyTime * toMicroseconds) + " us per actor, " + std::to_string(schemaFields) +
+        " fields, " + std::to_string(buildTime * 1000.0) + " ms to build the schema", LOG_CHANNEL);
+
+    for (AActor* actorPtr : actors)
+    {
+        actorPtr->MarkPendingKill();
+    }
+}
+
+void sfBenchmark::PropertyPaths(int count)
+{
+    // The actor is created outside of any level so the editor does not send events for it.
+    APostProcessVolume* volumePtr = NewObject<APostProcessVolume>(GetTransientPackage(), NAME_None, RF_Transient);
+    sfDictionaryProperty::SPtr settingsPtr = sfDictionaryProperty::Create();
+    sfValueProperty::SPtr bloomPtr = sfValueProperty::Create(ksMultiType(1.0f));
+    settingsPtr->Set("BloomIntensity", bloomPtr);
+    sfDictionaryProperty::SPtr propertiesPtr = sfDictionaryProperty::Create();
+    propertiesPtr->Set("Settings", settingsPtr);
+    // The object is not synced. It makes the properties' depths match those of a synced actor's properties.
+    sfObject::SPtr objPtr = sfObject::Create(sfType::Actor, propertiesPtr);
+
+    // This is how the UProperty was found before path accessors were cached
+    int found = 0;
+    double startTime = FPlatformTime::Seconds();
+    for (int i = 0; i < count; i++)
+    {
+        UStructProperty* structPropPtr = Cast<UStructProperty>(volumePtr->GetClass()->FindPropertyByName(
+            FName(UTF8_TO_TCHAR(settingsPtr->Key()->c_str()))));
+        if (structPropPtr != nullptr)
+        {
+            void* ptr = structPropPtr->ContainerPtrToValuePtr<void>(volumePtr);
+            UProperty* fieldPtr = structPropPtr->Struct->FindPropertyByName(
+                FName(UTF8_TO_TCHAR(bloomPtr->Key()->c_str())));
+            found += fieldPtr != nullptr && fieldPtr->ContainerPtrToValuePtr<void>(ptr) != nullptr;
+        }
+    }
+    double nameTime = FPlatformTime::Seconds() - startTime;
+
+    // Time compiling the accessor separately since it only happens once per path
+    startTime = FPlatformTime::Seconds();
+    found += sfPropertyUtil::FindUProperty(volumePtr, bloomPtr).IsValid();
+    double compileTime = FPlatformTime::Seconds() - startTime;
+
+    startTime = FPlatformTime::Seconds();
+    for (int i = 0; i < count; i++)
+    {
+        found += sfPropertyUtil::FindUProperty(volumePtr, bloomPtr).IsValid();
+    }
+    double accessorTime = FPlatformTime::Seconds() - startTime;
+
+    double toNanoseconds = 1000000000.0 / count;
+    KS::Log::Info("Finding Settings.BloomIntensity on a post process volume " + std::to_string(count) + " times (" +
+        std::to_string(found) + " found):", LOG_CHANNEL);
+    KS::Log::Info("  Lookups by name: " + std::to_string(nameTime * toNanoseconds) + " ns per lookup", LOG_CHANNEL);
+    KS::Log::Info("  Cached accessor: " + std::to_string(accessorTime * toNanoseconds) + " ns per lookup, " +
+        std::to_string(compileTime * 1000000.0) + " us to compile", LOG_CHANNEL);
+
+    volumePtr->MarkPendingKill();
+}
+
+/**
+ * Actor deleted handler for the event guards benchmark. Does nothing.
+ *
+ * @param   AActor* actorPtr that was deleted.
+ */
+static void IgnoreActorDeleted(AActor* actorPtr)
+{
+
+}
+
+void sfBenchmark::EventGuards(int count)
+{
+    // Other threads may still call the counting allocator after it is swapped out, so it is never destroyed. It only
+    // counts allocations made on the game thread.
+    FMalloc* mallocPtr = GMalloc;
+    static sfCountingMalloc countingMalloc(mallocPtr);
+
+    // This is how handlers were suppressed before event guards
+    FDelegateHandle handle = GEngine->OnLevelActorDeleted().AddStatic(&IgnoreActorDeleted);
+    GMalloc = &countingMalloc;
+    int64 startAllocations = countingMalloc.NumAllocations();
+    double startTime = FPlatformTime::Seconds();
+    for (int i = 0; i < count; i++)
+    {
+        GEngine->OnLevelActorDeleted().Remove(handle);
+        handle = GEngine->OnLevelActorDeleted().AddStatic(&IgnoreActorDeleted);
+    }
+    double rebindTime = FPlatformTime::Seconds() - startTime;
+    int64 rebindAllocations = countingMalloc.NumAllocations() - startAllocations;
+
+    sfEventGuard guard;
+    startAllocations = countingMalloc.NumAllocations();
+    startTime = FPlatformTime::Seconds();
+    for (int i = 0; i < count; i++)
+    {
+        sfEventGuard::Scope scope(guard);
+    }
+    double guardTime = FPlatformTime::Seconds() - startTime;
+    int64 guardAllocations = countingMalloc.NumAllocations() - startAllocations;
+    GMalloc = mallocPtr;
+    GEngine->OnLevelActorDeleted().Remove(handle);
+
+    double toNanoseconds = 1000000000.0 / count;
+    KS::Log::Info("Suppressing the level actor deleted handler " + std::to_string(count) + " times:", LOG_CHANNEL);
+    KS::Log::Info("  Remove and re-add handler: " + std::to_string(rebindAllocations) + " allocations (" +
+        std::to_string((double)rebindAllocations / count) + " per suppression), " +
+        std::to_string(rebindTime * toNanoseconds) + " ns per suppression", LOG_CHANNEL);
+    KS::Log::Info("  Event guard scope: " + std::to_string(guardAllocations) + " allocations (" +
+        std::to_string((double)guardAllocations / count) + " per suppression), " +
+        std::to_string(guardTime * toNanoseconds) + " ns per suppression", LOG_CHANNEL);
+}
+
+#undef LOG_CHANNEL
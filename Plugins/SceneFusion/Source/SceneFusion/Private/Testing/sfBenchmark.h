@@ -0,0 +1,83 @@
+#pragma once
+
+#include <CoreMinimal.h>
+
+/**
+ * Micro-benchmarks for data structures used while syncing. Results are logged.
+ */
+class sfBenchmark
+{
+public:
+    /**
+     * Runs the benchmark named by the first argument.
+     *
+     * @param   const TArray<FString>& args - benchmark name followed by benchmark arguments.
+     */
+    static void Run(const TArray<FString>& args);
+
+private:
+    /**
+     * Times object and actor lookups in an actor registry, and in the ordered map and hash map the registry
+     * replaced.
+     *
+     * @param   int count - number of actors to register.
+     */
+    static void ActorRegistry(int count);
+
+    /**
+     * Times giving actors in a level the same name using the rename counter and by appending random digits, and
+     * times finding name collisions with a level name index and by searching the level for each actor.
+     *
+     * @param   int count - number of actors to rename.
+     */
+    static void Names(int count);
+
+    /**
+     * Locks and unlocks transient cube actors in front of the level editor camera by duplicating their meshes and by
+     * outlining them, and logs the time taken, the number of components added and the draw calls added to a frame of
+     * the active level editor viewport.
+     *
+     * @param   int count - number of actors to lock.
+     */
+    static void Locks(int count);
+
+    /**
+     * Draws the active level editor viewport and waits for the render thread to finish it.
+     *
+     * @return  int number of RHI draw calls in the frame, as counted by DrawPrimitiveCalls in stat RHI. -1 if there
+     *          is no level editor viewport.
+     */
+    static int DrawViewport();
+
+    /**
+     * Requests and releases locks on an actor object and its children through a lock batch, with a lock for each
+     * object and with one subtree lock, and logs the number of lock requests sent and the time taken.
+     *
+     * @param   int count - number of children.
+     */
+    static void SubtreeLocks(int count);
+
+    /**
+     * Creates and applies property dictionaries for static mesh actors by iterating their class's properties with
+     * reflection and with the cached property schema, and logs the time taken.
+     *
+     * @param   int count - number of actors.
+     */
+    static void PropertySchema(int count);
+
+    /**
+     * Finds the UProperty for a change to a nested struct field by looking up properties by name at each level of the
+     * path and with the cached path accessor, and logs the time taken.
+     *
+     * @param   int count - number of lookups.
+     */
+    static void PropertyPaths(int count);
+
+    /**
+     * Suppresses an editor event handler by removing and re-adding it to the delegate and by opening an event guard
+     * scope, and logs the heap allocations made on the game thread and the time taken.
+     *
+     * @param   int count - number of times to suppress the handler.
+     */
+    static void EventGuards(int count);
+};
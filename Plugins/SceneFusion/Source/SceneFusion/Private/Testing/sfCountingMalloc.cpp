@@ -0,0 +1,59 @@
+#include "sfCountingMalloc.h"
+
+#include <HAL/PlatformTLS.h>
+
+sfCountingMalloc::sfCountingMalloc(FMalloc* innerPtr) :
+    m_innerPtr{ innerPtr },
+    m_threadId{ FPlatformTLS::GetCurrentThreadId() },
+    m_numAllocations{ 0 }
+{
+
+}
+
+void* sfCountingMalloc::Malloc(SIZE_T size, uint32 alignment)
+{
+    if (FPlatformTLS::GetCurrentThreadId() == m_threadId)
+    {
+        m_numAllocations++;
+    }
+    return m_innerPtr->Malloc(size, alignment);
+}
+
+void* sfCountingMalloc::Realloc(void* ptr, SIZE_T size, uint32 alignment)
+{
+    if (size > 0 && FPlatformTLS::GetCurrentThreadId() == m_threadId)
+    {
+        m_numAllocations++;
+    }
+    return m_innerPtr->Realloc(ptr, size, alignment);
+}
+
+void sfCountingMalloc::Free(void* ptr)
+{
+    m_innerPtr->Free(ptr);
+}
+
+bool sfCountingMalloc::GetAllocationSize(void* ptr, SIZE_T& size)
+{
+    return m_innerPtr->GetAllocationSize(ptr, size);
+}
+
+SIZE_T sfCountingMalloc::QuantizeSize(SIZE_T count, uint32 alignment)
+{
+    return m_innerPtr->QuantizeSize(count, alignment);
+}
+
+bool sfCountingMalloc::IsInternallyThreadSafe() const
+{
+    return m_innerPtr->IsInternallyThreadSafe();
+}
+
+const TCHAR* sfCountingMalloc::GetDescriptiveName()
+{
+    return TEXT("sfCountingMalloc");
+}
+
+int64 sfCountingMalloc::NumAllocations() const
+{
+    return m_numAllocations;
+}
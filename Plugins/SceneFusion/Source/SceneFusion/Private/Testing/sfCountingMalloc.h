@@ -0,0 +1,81 @@
+#pragma once
+
+#include <CoreMinimal.h>
+#include <HAL/MemoryBase.h>
+
+/**
+ * Allocator that forwards to another allocator and counts the allocations made by the thread that created it.
+ * Allocations made by other threads are forwarded without being counted.
+ */
+class sfCountingMalloc : public FMalloc
+{
+public:
+    /**
+     * Constructor
+     *
+     * @param   FMalloc* innerPtr - allocator to forward to.
+     */
+    sfCountingMalloc(FMalloc* innerPtr);
+
+    /**
+     * Allocates memory and counts the allocation.
+     *
+     * @param   SIZE_T size in bytes.
+     * @param   uint32 alignment
+     * @return  void* allocated memory.
+     */
+    virtual void* Malloc(SIZE_T size, uint32 alignment) override;
+
+    /**
+     * Reallocates memory and counts the allocation unless the memory is freed.
+     *
+     * @param   void* ptr to memory to reallocate.
+     * @param   SIZE_T size in bytes.
+     * @param   uint32 alignment
+     * @return  void* reallocated memory.
+     */
+    virtual void* Realloc(void* ptr, SIZE_T size, uint32 alignment) override;
+
+    /**
+     * Frees memory.
+     *
+     * @param   void* ptr to memory to free.
+     */
+    virtual void Free(void* ptr) override;
+
+    /**
+     * Gets the size of an allocation from the inner allocator.
+     *
+     * @param   void* ptr to allocated memory.
+     * @param   SIZE_T& size - set to the allocation size.
+     * @return  bool true if the size was found.
+     */
+    virtual bool GetAllocationSize(void* ptr, SIZE_T& size) override;
+
+    /**
+     * @param   SIZE_T count - number of bytes to allocate.
+     * @param   uint32 alignment
+     * @return  SIZE_T number of bytes the inner allocator would allocate.
+     */
+    virtual SIZE_T QuantizeSize(SIZE_T count, uint32 alignment) override;
+
+    /**
+     * @return  bool true if the inner allocator is thread safe.
+     */
+    virtual bool IsInternallyThreadSafe() const override;
+
+    /**
+     * @return  const TCHAR* name of the allocator.
+     */
+    virtual const TCHAR* GetDescriptiveName() override;
+
+    /**
+     * @return  int64 - number of allocations made by the thread that created the allocator.
+     */
+    int64 NumAllocations() const;
+
+private:
+    FMalloc* m_innerPtr;
+    uint32 m_threadId;
+    int64 m_numAllocations;
+};
@@ -8,6 +8,7 @@ IConsoleCommand* sfTestUtil::m_monkeyCommandPtr = nullptr;
 TSharedPtr<sfTimer> sfTestUtil::m_timerPtr;
 IConsoleCommand* sfTestUtil::m_timerCommandPtr = nullptr;
 TSharedPtr<sfAction> sfTestUtil::m_actionPtr;
+IConsoleCommand* sfTestUtil::m_benchmarkCommandPtr = nullptr;
 
 #define LOG_CHANNEL "sfTestUtil"
 
@@ -40,6 +41,26 @@ void sfTestUtil::RegisterCommands()
         "  -at time: Sets time to run the action. The time format should be YYYY.MM.DD-HH.MM.SS or HH.MM.SS\n"
         ),
         FConsoleCommandWithArgsDelegate::CreateStatic(&sfTestUtil::Run));
+
+    m_benchmarkCommandPtr = IConsoleManager::Get().RegisterConsoleCommand(
+        TEXT("SFBenchmark"),
+        TEXT("Usage: SFBenchmark [benchmark] [args]. Runs a micro-benchmark and logs the results.\n"
+        "Benchmarks:\n"
+        "  registry [count]: Times object and actor lookups in the actor registry. Count defaults to 100000.\n"
+        "  names [count]: Times renaming actors to the same name and finding name collisions. Count defaults to "
+        "50000.\n"
+        "  locks [count]: Times locking and unlocking actors and measures the draw calls locks add to a viewport frame "
+        "for each lock drawing method. Count defaults to 5000.\n"
+        "  subtree [count]: Times locking an actor and its children with a lock for each object and with one subtree "
+        "lock. Count defaults to 1000.\n"
+        "  schema [count]: Times creating and applying actor property dictionaries by iterating class properties and "
+        "with cached property schemas. Count defaults to 2000.\n"
+        "  paths [count]: Times finding the UProperty for a nested struct field change by looking up properties by "
+        "name and with a cached path accessor. Count defaults to 100000.\n"
+        "  guards [count]: Counts the allocations made suppressing an editor event handler by re-adding it to its "
+        "delegate and with an event guard. Count defaults to 100000.\n"
+        ),
+        FConsoleCommandWithArgsDelegate::CreateStatic(&sfBenchmark::Run));
 }
 
 void sfTestUtil::CleanUp()
@@ -60,6 +81,7 @@ void sfTestUtil::CleanUp()
         m_timerPtr.Reset();
     }
     IConsoleManager::Get().UnregisterConsoleObject(m_timerCommandPtr);
+    IConsoleManager::Get().UnregisterConsoleObject(m_benchmarkCommandPtr);
 }
 
 void sfTestUtil::CombineQuotedArgs(const TArray<FString>& inArgs, TArray<FString>& outArgs)
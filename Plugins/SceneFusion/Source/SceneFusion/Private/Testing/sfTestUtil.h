@@ -3,6 +3,7 @@
 #include "sfMonkey.h"
 #include "sfTimer.h"
 #include "sfAction.h"
+#include "sfBenchmark.h"
 
 #include <CoreMinimal.h>
 #include <Editor.h>
@@ -29,6 +30,7 @@ private:
     static TSharedPtr<sfTimer> m_timerPtr;
     static IConsoleCommand* m_timerCommandPtr;
     static TSharedPtr<sfAction> m_actionPtr;
+    static IConsoleCommand* m_benchmarkCommandPtr;
 
     /**
      * Monkey console command. If no arguments are given, toggles the monkey on or off. If at least one argument is
@@ -54,6 +54,27 @@ void sfUIOnlinePanel::InfoArea()
                 .Text_Lambda([]()->const FText {
                     FString info = "Synced Actors: ";
                     info.AppendInt(SceneFusion::ActorManager->NumSyncedActors());
+                    int numPending = SceneFusion::ActorManager->NumPendingUploads();
+                    if (numPending > 0)
+                    {
+                        info += " (uploading ";
+                        info.AppendInt(numPending);
+                        info += ")";
+                    }
+                    numPending = SceneFusion::ActorManager->NumPendingSpawns();
+                    if (numPending > 0)
+                    {
+                        info += " (loading ";
+                        info.AppendInt(numPending);
+                        info += ")";
+                    }
+                    numPending = SceneFusion::ObjectEventDispatcher->NumQueuedEvents();
+                    if (numPending > 0)
+                    {
+                        info += " (applying ";
+                        info.AppendInt(numPending);
+                        info += " changes)";
+                    }
                     return FText::FromString(info); 
                 })
             ]
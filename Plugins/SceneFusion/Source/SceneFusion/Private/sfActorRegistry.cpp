@@ -0,0 +1,122 @@
+#include "sfActorRegistry.h"
+
+#include <Log.h>
+
+#define LOG_CHANNEL "sfActorRegistry"
+
+void sfActorRegistry::Add(AActor* actorPtr, sfObject::SPtr objPtr)
+{
+    int32* indexPtr = m_actorIndices.Find(actorPtr);
+    if (indexPtr != nullptr)
+    {
+        RemoveAt(*indexPtr);
+    }
+    indexPtr = m_objectIndices.Find(objPtr.get());
+    if (indexPtr != nullptr)
+    {
+        RemoveAt(*indexPtr);
+    }
+    int32 index = m_entries.Num();
+    m_entries.Add(Entry{ actorPtr, actorPtr, objPtr });
+    m_actorIndices.Add(actorPtr, index);
+    m_objectIndices.Add(objPtr.get(), index);
+}
+
+sfObject::SPtr sfActorRegistry::FindObject(const AActor* actorPtr)
+{
+    int32* indexPtr = m_actorIndices.Find(actorPtr);
+    if (indexPtr == nullptr)
+    {
+        return nullptr;
+    }
+    // If the actor was garbage collected, a new actor may have been created at the same address.
+    int32 index = *indexPtr;
+    if (GetActorOrRemove(index) != actorPtr)
+    {
+        return nullptr;
+    }
+    return m_entries[index].ObjPtr;
+}
+
+AActor* sfActorRegistry::FindActor(const sfObject::SPtr& objPtr)
+{
+    int32* indexPtr = m_objectIndices.Find(objPtr.get());
+    return indexPtr == nullptr ? nullptr : GetActorOrRemove(*indexPtr);
+}
+
+bool sfActorRegistry::Contains(const AActor* actorPtr)
+{
+    return FindObject(actorPtr) != nullptr;
+}
+
+bool sfActorRegistry::Contains(const sfObject::SPtr& objPtr)
+{
+    return FindActor(objPtr) != nullptr;
+}
+
+sfObject::SPtr sfActorRegistry::RemoveActor(const AActor* actorPtr)
+{
+    int32* indexPtr = m_actorIndices.Find(actorPtr);
+    if (indexPtr == nullptr)
+    {
+        return nullptr;
+    }
+    int32 index = *indexPtr;
+    sfObject::SPtr objPtr = m_entries[index].ObjPtr;
+    RemoveAt(index);
+    return objPtr;
+}
+
+AActor* sfActorRegistry::RemoveObject(const sfObject::SPtr& objPtr)
+{
+    int32* indexPtr = m_objectIndices.Find(objPtr.get());
+    if (indexPtr == nullptr)
+    {
+        return nullptr;
+    }
+    int32 index = *indexPtr;
+    AActor* actorPtr = m_entries[index].ActorPtr.Get(true);
+    RemoveAt(index);
+    return actorPtr;
+}
+
+int sfActorRegistry::Num() const
+{
+    return m_entries.Num();
+}
+
+void sfActorRegistry::Clear()
+{
+    m_entries.Empty();
+    m_actorIndices.Empty();
+    m_objectIndices.Empty();
+}
+
+AActor* sfActorRegistry::GetActorOrRemove(int32 index)
+{
+    // Actors being destroyed are pending kill but still valid until they are garbage collected.
+    AActor* actorPtr = m_entries[index].ActorPtr.Get(true);
+    if (actorPtr == nullptr)
+    {
+        KS::Log::Warning("Removing object " + std::to_string(m_entries[index].ObjPtr->Id()) +
+            " whose actor was garbage collected without being removed.", LOG_CHANNEL);
+        RemoveAt(index);
+    }
+    return actorPtr;
+}
+
+void sfActorRegistry::RemoveAt(int32 index)
+{
+    m_actorIndices.Remove(m_entries[index].ActorKey);
+    m_objectIndices.Remove(m_entries[index].ObjPtr.get());
+    int32 lastIndex = m_entries.Num() - 1;
+    if (index != lastIndex)
+    {
+        m_entries[index] = MoveTemp(m_entries[lastIndex]);
+        m_actorIndices[m_entries[index].ActorKey] = index;
+        m_objectIndices[m_entries[index].ObjPtr.get()] = index;
+    }
+    m_entries.RemoveAt(lastIndex, 1, false);
+}
+
+#undef LOG_CHANNEL
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <CoreMinimal.h>
+#include <GameFramework/Actor.h>
+#include <sfObject.h>
+
+using namespace KS::SceneFusion2;
+
+/**
+ * Maps synced actors to their objects and objects to their actors. Entries are stored in a dense array and found
+ * through hashed indices keyed by actor and object address, so lookups are constant time and don't change shared
+ * pointer reference counts. Objects are keyed by address instead of id because locally created objects don't have
+ * ids until the server acknowledges them. Actors are held by weak pointers; an entry whose actor was garbage collected
+ * is stale and is removed when it is found instead of returning a dangling pointer.
+ */
+class sfActorRegistry
+{
+public:
+    /**
+     * Adds an actor and its object. Replaces any existing entries for the actor or object.
+     *
+     * @param   AActor* actorPtr
+     * @param   sfObject::SPtr objPtr for the actor.
+     */
+    void Add(AActor* actorPtr, sfObject::SPtr objPtr);
+
+    /**
+     * Gets the object for an actor.
+     *
+     * @param   const AActor* actorPtr
+     * @return  sfObject::SPtr object for the actor, or nullptr if the actor is not registered.
+     */
+    sfObject::SPtr FindObject(const AActor* actorPtr);
+
+    /**
+     * Gets the actor for an object.
+     *
+     * @param   const sfObject::SPtr& objPtr
+     * @return  AActor* actor for the object, or nullptr if the object is not registered or its actor was garbage
+     *          collected.
+     */
+    AActor* FindActor(const sfObject::SPtr& objPtr);
+
+    /**
+     * Checks if an actor is registered.
+     *
+     * @param   const AActor* actorPtr
+     * @return  bool
+     */
+    bool Contains(const AActor* actorPtr);
+
+    /**
+     * Checks if an object is registered with an actor that has not been garbage collected.
+     *
+     * @param   const sfObject::SPtr& objPtr
+     * @return  bool
+     */
+    bool Contains(const sfObject::SPtr& objPtr);
+
+    /**
+     * Removes an actor and its object. The actor pointer is only used as a key so it may be stale.
+     *
+     * @param   const AActor* actorPtr to remove.
+     * @return  sfObject::SPtr object that was removed, or nullptr if the actor was not registered.
+     */
+    sfObject::SPtr RemoveActor(const AActor* actorPtr);
+
+    /**
+     * Removes an object and its actor.
+     *
+     * @param   const sfObject::SPtr& objPtr to remove.
+     * @return  AActor* actor that was removed, or nullptr if the object was not registered or its actor was garbage
+     *          collected.
+     */
+    AActor* RemoveObject(const sfObject::SPtr& objPtr);
+
+    /**
+     * @return  int - number of registered actors, including stale entries that have not been found yet.
+     */
+    int Num() const;
+
+    /**
+     * Removes all entries.
+     */
+    void Clear();
+
+private:
+    /**
+     * An actor and its object.
+     */
+    struct Entry
+    {
+    public:
+        // Address the entry is indexed by. Not dereferenced since the actor may have been garbage collected.
+        const AActor* ActorKey;
+        TWeakObjectPtr<AActor> ActorPtr;
+        sfObject::SPtr ObjPtr;
+    };
+
+    TArray<Entry> m_entries;
+    TMap<const AActor*, int32> m_actorIndices;
+    TMap<const sfObject*, int32> m_objectIndices;
+
+    /**
+     * Gets the actor for an entry. Removes the entry if the actor was garbage collected.
+     *
+     * @param   int32 index of the entry.
+     * @return  AActor* actor for the entry, or nullptr if it was garbage collected.
+     */
+    AActor* GetActorOrRemove(int32 index);
+
+    /**
+     * Removes an entry by moving the last entry into its place.
+     *
+     * @param   int32 index of the entry to remove.
+     */
+    void RemoveAt(int32 index);
+};
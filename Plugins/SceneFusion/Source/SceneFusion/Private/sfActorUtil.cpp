@@ -0,0 +1,3 @@
+#include "sfActorUtil.h"
+
+TMap<const ULevel*, TMap<FName, int32>> sfActorUtil::m_nameSuffixes;
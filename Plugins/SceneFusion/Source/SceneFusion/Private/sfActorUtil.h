@@ -2,6 +2,7 @@
 
 #include <Log.h>
 #include <CoreMinimal.h>
+#include <Editor.h>
 #include <GameFramework/Actor.h>
 #include <Runtime/Engine/Classes/Components/SceneComponent.h>
 
@@ -46,21 +47,36 @@ public:
     }
 
     /**
-     * Renames an actor. If the name is not available, appends random digits to the name until it finds a name that is
-     * available.
+     * Renames an actor. If the name is not available, appends a number from a counter kept for the name in the actor's
+     * level. The counter only increases, so a free name is found on the first try unless other names were made with
+     * the same numbers.
      *
      * @param   AActor* actorPtr to rename.
-     * @param   FString name to set. If this name is already used, random digits will be appended to the name.
+     * @param   FString name to set. If this name is already used, a number will be appended to the name.
      */
     static void Rename(AActor* actorPtr, FString name)
     {
-        while (!actorPtr->Rename(*name, nullptr, REN_Test))
+        if (!actorPtr->Rename(*name, nullptr, REN_Test))
         {
-            name += FString::FromInt(rand() % 10);
+            int32& suffix = m_nameSuffixes.FindOrAdd(actorPtr->GetLevel()).FindOrAdd(FName(*name));
+            FString baseName = name;
+            do
+            {
+                suffix++;
+                name = baseName + FString::FromInt(suffix);
+            } while (!actorPtr->Rename(*name, nullptr, REN_Test));
         }
         actorPtr->Rename(*name);
     }
 
+    /**
+     * Resets the counters Rename appends to names.
+     */
+    static void ClearNameSuffixes()
+    {
+        m_nameSuffixes.Empty();
+    }
+
     /**
      * Tries to rename an actor. Logs a warning if the actor could not be renamed because the name is already in use.
      * If a deleted actor is using the name, renames the deleted actor to make the name available.
@@ -130,6 +146,10 @@ public:
             GetSceneComponents(actorPtr, childPtr, components);
         }
     }
+
+private:
+    // Last number appended to each name by Rename, for each level
+    static TMap<const ULevel*, TMap<FName, int32>> m_nameSuffixes;
 };
 
 #undef LOG_CHANNEL
\ No newline at end of file
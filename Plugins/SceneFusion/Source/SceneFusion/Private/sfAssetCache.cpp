@@ -0,0 +1,137 @@
+#include "sfAssetCache.h"
+
+#include <Log.h>
+#include <Editor.h>
+#include <UObject/SoftObjectPath.h>
+
+#define LOG_CHANNEL "sfAssetCache"
+
+TMap<FString, TWeakObjectPtr<UClass>> sfAssetCache::m_classes;
+TMap<FString, TWeakObjectPtr<UObject>> sfAssetCache::m_assets;
+sfAssetCache::Stats sfAssetCache::m_classStats;
+sfAssetCache::Stats sfAssetCache::m_assetStats;
+IConsoleCommand* sfAssetCache::m_statsCommandPtr = nullptr;
+FDelegateHandle sfAssetCache::m_onPackageReloadedHandle;
+FDelegateHandle sfAssetCache::m_onAssetsDeletedHandle;
+
+void sfAssetCache::Initialize()
+{
+    m_onPackageReloadedHandle = FCoreUObjectDelegates::OnPackageReloaded.AddLambda(
+        [](EPackageReloadPhase phase, FPackageReloadedEvent* eventPtr)
+    {
+        Invalidate();
+    });
+    m_onAssetsDeletedHandle = FEditorDelegates::OnAssetsDeleted.AddLambda([](const TArray<UClass*>& classes)
+    {
+        Invalidate();
+    });
+
+    m_statsCommandPtr = IConsoleManager::Get().RegisterConsoleCommand(
+        TEXT("SFAssetCacheStats"),
+        TEXT("Usage: SFAssetCacheStats. Logs hit and miss rates for the class and asset caches."),
+        FConsoleCommandDelegate::CreateStatic(&sfAssetCache::LogStats));
+}
+
+void sfAssetCache::CleanUp()
+{
+    FCoreUObjectDelegates::OnPackageReloaded.Remove(m_onPackageReloadedHandle);
+    FEditorDelegates::OnAssetsDeleted.Remove(m_onAssetsDeletedHandle);
+    IConsoleManager::Get().UnregisterConsoleObject(m_statsCommandPtr);
+    m_statsCommandPtr = nullptr;
+    Clear();
+}
+
+void sfAssetCache::Clear()
+{
+    Invalidate();
+    m_classStats = Stats();
+    m_assetStats = Stats();
+}
+
+void sfAssetCache::Invalidate()
+{
+    m_classes.Empty();
+    m_assets.Empty();
+}
+
+UClass* sfAssetCache::FindClass(const FString& className)
+{
+    TWeakObjectPtr<UClass>* classPtrPtr = m_classes.Find(className);
+    if (classPtrPtr != nullptr && IsUsable(classPtrPtr->Get()) &&
+        !(*classPtrPtr)->HasAnyClassFlags(CLASS_NewerVersionExists))
+    {
+        m_classStats.Hits++;
+        return classPtrPtr->Get();
+    }
+    m_classStats.Misses++;
+    UClass* classPtr = FindObject<UClass>(ANY_PACKAGE, *className);
+    if (classPtr != nullptr)
+    {
+        m_classes.Add(className, classPtr);
+    }
+    else
+    {
+        m_classes.Remove(className);
+    }
+    return classPtr;
+}
+
+UObject* sfAssetCache::Find(const FString& path)
+{
+    TWeakObjectPtr<UObject>* uobjPtrPtr = m_assets.Find(path);
+    if (uobjPtrPtr != nullptr && IsUsable(uobjPtrPtr->Get()))
+    {
+        m_assetStats.Hits++;
+        return uobjPtrPtr->Get();
+    }
+    m_assetStats.Misses++;
+    UObject* uobjPtr = FSoftObjectPath(path).ResolveObject();
+    if (uobjPtr != nullptr)
+    {
+        m_assets.Add(path, uobjPtr);
+    }
+    else
+    {
+        m_assets.Remove(path);
+    }
+    return uobjPtr;
+}
+
+UObject* sfAssetCache::Load(const FString& path)
+{
+    UObject* uobjPtr = Find(path);
+    if (uobjPtr == nullptr)
+    {
+        // Disable loading dialog that causes a crash if we are dragging objects
+        GIsSlowTask = true;
+        uobjPtr = LoadObject<UObject>(nullptr, *path);
+        GIsSlowTask = false;
+        if (uobjPtr != nullptr)
+        {
+            m_assets.Add(path, uobjPtr);
+        }
+    }
+    return uobjPtr;
+}
+
+bool sfAssetCache::IsUsable(UObject* uobjPtr)
+{
+    return uobjPtr != nullptr && !uobjPtr->IsPendingKill() && !uobjPtr->HasAnyFlags(RF_NewerVersionExists);
+}
+
+void sfAssetCache::LogStats()
+{
+    LogCacheStats("Class", m_classStats, m_classes.Num());
+    LogCacheStats("Asset", m_assetStats, m_assets.Num());
+}
+
+void sfAssetCache::LogCacheStats(const FString& name, const Stats& stats, int size)
+{
+    int total = stats.Hits + stats.Misses;
+    float hitRate = total == 0 ? 0.0f : stats.Hits * 100.0f / total;
+    KS::Log::Info(std::string(TCHAR_TO_UTF8(*name)) + " cache: " + std::to_string(size) + " entries, " +
+        std::to_string(stats.Hits) + " hits, " + std::to_string(stats.Misses) + " misses, " +
+        std::to_string(hitRate) + "% hit rate.", LOG_CHANNEL);
+}
+
+#undef LOG_CHANNEL
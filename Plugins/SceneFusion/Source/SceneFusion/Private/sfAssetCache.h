@@ -0,0 +1,111 @@
+#pragma once
+
+#include <CoreMinimal.h>
+#include <UObject/UObjectGlobals.h>
+#include <HAL/IConsoleManager.h>
+
+/**
+ * Session-scoped cache of resolved classes and assets by name or path. Entries are weak pointers and are discarded
+ * when the object is destroyed or replaced by a newer version, and the cache is emptied when packages are reloaded or
+ * assets are deleted.
+ */
+class sfAssetCache
+{
+public:
+    /**
+     * Registers invalidation event handlers and the stats console command.
+     */
+    static void Initialize();
+
+    /**
+     * Unregisters event handlers and console commands and clears the cache.
+     */
+    static void CleanUp();
+
+    /**
+     * Clears the cache and stats. Called when we disconnect from a session.
+     */
+    static void Clear();
+
+    /**
+     * Finds a native class by name.
+     *
+     * @param   const FString& className
+     * @return  UClass* class with the given name, or nullptr if it was not found.
+     */
+    static UClass* FindClass(const FString& className);
+
+    /**
+     * Finds a loaded asset by path. Does not load the asset if it is not loaded.
+     *
+     * @param   const FString& path
+     * @return  UObject* asset at the path, or nullptr if it is not loaded.
+     */
+    static UObject* Find(const FString& path);
+
+    /**
+     * Finds a loaded asset by path. Does not load the asset if it is not loaded.
+     *
+     * @param   const FString& path
+     * @return  T* asset at the path, or nullptr if it is not loaded or is not a T.
+     */
+    template<typename T>
+    static T* Find(const FString& path)
+    {
+        return Cast<T>(Find(path));
+    }
+
+    /**
+     * Finds an asset by path, and loads it synchronously if it is not loaded.
+     *
+     * @param   const FString& path
+     * @return  UObject* asset at the path, or nullptr if it could not be loaded.
+     */
+    static UObject* Load(const FString& path);
+
+private:
+    /**
+     * Cache hit and miss counts.
+     */
+    struct Stats
+    {
+    public:
+        int Hits = 0;
+        int Misses = 0;
+    };
+
+    static TMap<FString, TWeakObjectPtr<UClass>> m_classes;
+    static TMap<FString, TWeakObjectPtr<UObject>> m_assets;
+    static Stats m_classStats;
+    static Stats m_assetStats;
+    static IConsoleCommand* m_statsCommandPtr;
+    static FDelegateHandle m_onPackageReloadedHandle;
+    static FDelegateHandle m_onAssetsDeletedHandle;
+
+    /**
+     * Checks if a cached object can still be used.
+     *
+     * @param   UObject* uobjPtr
+     * @return  bool false if the object is null, pending kill or was replaced by a newer version.
+     */
+    static bool IsUsable(UObject* uobjPtr);
+
+    /**
+     * Removes all cached entries without resetting the stats.
+     */
+    static void Invalidate();
+
+    /**
+     * Logs hit and miss counts and rates.
+     */
+    static void LogStats();
+
+    /**
+     * Logs hit and miss counts and rates for a cache.
+     *
+     * @param   const FString& name of the cache.
+     * @param   const Stats& stats
+     * @param   int size - number of entries in the cache.
+     */
+    static void LogCacheStats(const FString& name, const Stats& stats, int size);
+};
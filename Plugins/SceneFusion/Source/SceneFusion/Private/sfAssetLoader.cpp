@@ -0,0 +1,219 @@
+#include "sfAssetLoader.h"
+#include "SceneFusion.h"
+#include "sfAssetCache.h"
+
+#define LOG_CHANNEL "sfAssetLoader"
+
+sfAssetLoader::sfAssetLoader() :
+    m_nextId{ 1 },
+    m_numActivePrefetches{ 0 },
+    m_prefetchStartTime{ 0.0 }
+{
+
+}
+
+sfAssetLoader::~sfAssetLoader()
+{
+    Clear();
+}
+
+void sfAssetLoader::Load(UObject* targetPtr, int slot, const FString& path, Callback callback)
+{
+    TPair<UObject*, int> key(targetPtr, slot);
+    FSoftObjectPath softPath(path);
+    UObject* assetPtr = path.IsEmpty() ? nullptr : sfAssetCache::Find(path);
+    if (path.IsEmpty() || assetPtr != nullptr)
+    {
+        // Discard any pending request for this slot
+        if (targetPtr != nullptr)
+        {
+            m_latestRequests.Remove(key);
+        }
+        callback(assetPtr);
+        return;
+    }
+
+    TSharedPtr<Request> requestPtr = MakeShareable(new Request);
+    requestPtr->Id = m_nextId++;
+    requestPtr->TargetPtr = targetPtr;
+    requestPtr->HasTarget = targetPtr != nullptr;
+    requestPtr->Key = key;
+    requestPtr->Path = softPath;
+    requestPtr->OnLoad = callback;
+    m_requests.Add(requestPtr->Id, requestPtr);
+    if (targetPtr != nullptr)
+    {
+        // Replaces any pending request for this slot
+        m_latestRequests.Add(key, requestPtr->Id);
+    }
+    // The handle keeps the asset from being garbage collected until we apply it
+    requestPtr->HandlePtr = m_streamableManager.RequestAsyncLoad(softPath,
+        FStreamableDelegate::CreateRaw(this, &sfAssetLoader::OnLoadComplete, requestPtr->Id));
+}
+
+uint32_t sfAssetLoader::Prefetch(const TSet<FString>& paths, int numUsers)
+{
+    TArray<FSoftObjectPath> pathsToLoad;
+    int numAlreadyLoaded = 0;
+    for (const FString& path : paths)
+    {
+        if (path.IsEmpty())
+        {
+            continue;
+        }
+        if (sfAssetCache::Find(path) != nullptr)
+        {
+            numAlreadyLoaded++;
+        }
+        else
+        {
+            pathsToLoad.Add(FSoftObjectPath(path));
+        }
+    }
+    if (pathsToLoad.Num() == 0 || numUsers <= 0)
+    {
+        m_prefetchStats.NumAlreadyLoaded += numAlreadyLoaded;
+        return 0;
+    }
+
+    if (m_numActivePrefetches == 0)
+    {
+        m_prefetchStartTime = FPlatformTime::Seconds();
+    }
+    m_numActivePrefetches++;
+    int numPrefetched = pathsToLoad.Num();
+    TSharedPtr<FStreamableHandle> handlePtr = m_streamableManager.RequestAsyncLoad(pathsToLoad,
+        FStreamableDelegate::CreateRaw(this, &sfAssetLoader::OnPrefetchComplete, numPrefetched, numAlreadyLoaded));
+    if (!handlePtr.IsValid())
+    {
+        return 0;
+    }
+    uint32_t id = m_nextId++;
+    m_prefetchHandles.Add(id, handlePtr);
+    m_prefetchUsers.Add(id, numUsers);
+    return id;
+}
+
+void sfAssetLoader::ReleasePrefetch(uint32_t id)
+{
+    int* numUsersPtr = m_prefetchUsers.Find(id);
+    if (numUsersPtr == nullptr || --(*numUsersPtr) > 0)
+    {
+        return;
+    }
+    m_prefetchUsers.Remove(id);
+    TSharedPtr<FStreamableHandle> handlePtr;
+    if (m_prefetchHandles.RemoveAndCopyValue(id, handlePtr))
+    {
+        // If the assets are still loading, the handle is released when they finish.
+        handlePtr->ReleaseHandle();
+    }
+}
+
+void sfAssetLoader::OnPrefetchComplete(int numPrefetched, int numAlreadyLoaded)
+{
+    m_numActivePrefetches--;
+    m_prefetchStats.NumPrefetched += numPrefetched;
+    m_prefetchStats.NumAlreadyLoaded += numAlreadyLoaded;
+    if (m_numActivePrefetches <= 0)
+    {
+        m_numActivePrefetches = 0;
+        m_prefetchStats.Seconds += FPlatformTime::Seconds() - m_prefetchStartTime;
+        KS::Log::Info("Prefetched " + std::to_string(m_prefetchStats.NumPrefetched) + " assets in " +
+            std::to_string(m_prefetchStats.Seconds) + " seconds. " +
+            std::to_string(m_prefetchStats.NumAlreadyLoaded) + " assets were already loaded.", LOG_CHANNEL);
+    }
+}
+
+bool sfAssetLoader::IsPrefetching()
+{
+    return m_numActivePrefetches > 0;
+}
+
+bool sfAssetLoader::IsLoading(const FSoftObjectPath& path)
+{
+    return !m_streamableManager.IsAsyncLoadComplete(path);
+}
+
+void sfAssetLoader::OnLoadComplete(uint32_t id)
+{
+    if (m_requests.Contains(id))
+    {
+        m_completedRequests.Add(id);
+    }
+}
+
+void sfAssetLoader::Tick()
+{
+    if (m_completedRequests.Num() == 0)
+    {
+        return;
+    }
+    // Callbacks may request more loads, so we swap the completed list out before iterating it.
+    TArray<uint32_t> completedRequests = MoveTemp(m_completedRequests);
+    m_completedRequests.Empty();
+    for (uint32_t id : completedRequests)
+    {
+        TSharedPtr<Request> requestPtr;
+        if (!m_requests.RemoveAndCopyValue(id, requestPtr))
+        {
+            continue;
+        }
+        if (requestPtr->HasTarget)
+        {
+            if (IsStale(*requestPtr))
+            {
+                // The slot was assigned again after this load started
+                continue;
+            }
+            m_latestRequests.Remove(requestPtr->Key);
+            if (!requestPtr->TargetPtr.IsValid())
+            {
+                continue;
+            }
+        }
+        UObject* assetPtr = sfAssetCache::Find(requestPtr->Path.ToString());
+        if (assetPtr == nullptr)
+        {
+            KS::Log::Warning("Unable to load " + std::string(TCHAR_TO_UTF8(*requestPtr->Path.ToString())),
+                LOG_CHANNEL);
+        }
+        requestPtr->OnLoad(assetPtr);
+        requestPtr->HandlePtr.Reset();
+    }
+}
+
+bool sfAssetLoader::IsStale(const Request& request)
+{
+    uint32_t* idPtr = m_latestRequests.Find(request.Key);
+    return idPtr == nullptr || *idPtr != request.Id;
+}
+
+void sfAssetLoader::Clear()
+{
+    for (auto iter : m_requests)
+    {
+        if (iter.Value->HandlePtr.IsValid())
+        {
+            iter.Value->HandlePtr->CancelHandle();
+        }
+    }
+    for (auto iter : m_prefetchHandles)
+    {
+        iter.Value->CancelHandle();
+    }
+    m_requests.Empty();
+    m_latestRequests.Empty();
+    m_completedRequests.Empty();
+    m_prefetchHandles.Empty();
+    m_prefetchUsers.Empty();
+    m_numActivePrefetches = 0;
+    m_prefetchStats = PrefetchStats();
+}
+
+int sfAssetLoader::NumPendingLoads()
+{
+    return m_requests.Num();
+}
+
+#undef LOG_CHANNEL
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <CoreMinimal.h>
+#include <Engine/StreamableManager.h>
+#include <functional>
+
+/**
+ * Loads assets asynchronously so uncached assets don't block the game thread. Completed loads are applied in a batch
+ * from Tick. Each load is for a slot on a target object, and a newer load for the same slot discards the older one.
+ */
+class sfAssetLoader
+{
+public:
+    /**
+     * Called with the loaded asset, or nullptr if the asset could not be loaded.
+     *
+     * @param   UObject* assetPtr
+     */
+    typedef std::function<void(UObject* assetPtr)> Callback;
+
+    /**
+     * Prefetch statistics for all prefetches since the loader was last cleared. Logged when prefetching finishes.
+     */
+    struct PrefetchStats
+    {
+    public:
+        // Number of assets that were loaded by prefetching
+        int NumPrefetched = 0;
+        // Number of assets that were already loaded when prefetching was requested
+        int NumAlreadyLoaded = 0;
+        // Seconds spent waiting for prefetched assets to load
+        double Seconds = 0.0;
+    };
+
+    /**
+     * Constructor
+     */
+    sfAssetLoader();
+
+    /**
+     * Destructor
+     */
+    ~sfAssetLoader();
+
+    /**
+     * Calls the callback with the asset at the given path. If the path is empty or the asset is already loaded, the
+     * callback is called immediately. Otherwise the asset is loaded asynchronously and the callback is called from
+     * Tick after the load completes. Discards any pending load for the same target and slot.
+     *
+     * @param   UObject* targetPtr the asset will be assigned to. The callback is not called if the target is
+     *          destroyed before the load completes. If nullptr, the load is not tied to a target and is never
+     *          discarded.
+     * @param   int slot on the target the asset will be assigned to.
+     * @param   const FString& path of asset to load.
+     * @param   Callback callback to call with the loaded asset.
+     */
+    void Load(UObject* targetPtr, int slot, const FString& path, Callback callback);
+
+    /**
+     * Starts loading assets asynchronously so they are already loaded when they are needed. All assets that are not
+     * loaded are requested at once so they load concurrently. Logs stats once they finish loading. The prefetched
+     * assets are kept from being garbage collected until ReleasePrefetch is called once for each user.
+     *
+     * @param   const TSet<FString>& paths of assets to prefetch.
+     * @param   int numUsers - number of times ReleasePrefetch will be called for this prefetch.
+     * @return  uint32_t id of the prefetch, or 0 if all the assets were already loaded.
+     */
+    uint32_t Prefetch(const TSet<FString>& paths, int numUsers);
+
+    /**
+     * Releases a user of a prefetch. When every user is released, the prefetched assets can be garbage collected.
+     *
+     * @param   uint32_t id of the prefetch. Does nothing if 0.
+     */
+    void ReleasePrefetch(uint32_t id);
+
+    /**
+     * @return  bool true if there are prefetched assets still loading.
+     */
+    bool IsPrefetching();
+
+    /**
+     * Checks if an asset is being loaded asynchronously.
+     *
+     * @param   const FSoftObjectPath& path of the asset.
+     * @return  bool
+     */
+    bool IsLoading(const FSoftObjectPath& path);
+
+    /**
+     * Calls the callbacks for completed loads.
+     */
+    void Tick();
+
+    /**
+     * Discards all pending and completed loads.
+     */
+    void Clear();
+
+    /**
+     * @return  int - number of loads that have not been applied yet.
+     */
+    int NumPendingLoads();
+
+private:
+    /**
+     * An asset load request.
+     */
+    struct Request
+    {
+    public:
+        uint32_t Id;
+        TWeakObjectPtr<UObject> TargetPtr;
+        bool HasTarget;
+        // Target and slot
+        TPair<UObject*, int> Key;
+        FSoftObjectPath Path;
+        Callback OnLoad;
+        TSharedPtr<FStreamableHandle> HandlePtr;
+    };
+
+    FStreamableManager m_streamableManager;
+    uint32_t m_nextId;
+    // Pending requests by id
+    TMap<uint32_t, TSharedPtr<Request>> m_requests;
+    // Id of the latest request for each target and slot
+    TMap<TPair<UObject*, int>, uint32_t> m_latestRequests;
+    TArray<uint32_t> m_completedRequests;
+    // Prefetch handles keep prefetched assets from being garbage collected before they are used
+    TMap<uint32_t, TSharedPtr<FStreamableHandle>> m_prefetchHandles;
+    // Number of users that have not released each prefetch
+    TMap<uint32_t, int> m_prefetchUsers;
+    int m_numActivePrefetches;
+    double m_prefetchStartTime;
+    PrefetchStats m_prefetchStats;
+
+    /**
+     * Called when an asynchronous load completes.
+     *
+     * @param   uint32_t id of the request that completed.
+     */
+    void OnLoadComplete(uint32_t id);
+
+    /**
+     * Called when a prefetch completes.
+     *
+     * @param   int numPrefetched - number of assets requested by the prefetch.
+     * @param   int numAlreadyLoaded - number of assets that were already loaded.
+     */
+    void OnPrefetchComplete(int numPrefetched, int numAlreadyLoaded);
+
+    /**
+     * Checks if a request was replaced by a newer request for the same target and slot.
+     *
+     * @param   const Request& request
+     * @return  bool true if the request was replaced.
+     */
+    bool IsStale(const Request& request);
+};
@@ -20,7 +20,23 @@ private:
         WebURL("https://console.kinematicsoup.com"),
         MockWebServerAddress(""),
         MockWebServerPort(""),
-        ShowAvatar(true)
+        ShowAvatar(true),
+        UploadTimeBudget(10.0f),
+        UploadByteBudget(256 * 1024),
+        UploadBatchSize(500),
+        SpawnTimeBudget(10.0f),
+        PackTransforms(false),
+        TransformPositionBits(8),
+        TransformRotationBits(15),
+        DragSendRate(20.0f),
+        DragUpdateBudget(2000),
+        DragMinDistance(0.1f),
+        DragMinAngle(0.1f),
+        EventTimeBudget(10.0f),
+        LockOutlines(false),
+        OptimisticLocks(true),
+        SubtreeLocks(true),
+        MergeIndependentProperties(false)
     {}
 
 public:
@@ -44,6 +60,42 @@ public:
     FString MockWebServerAddress;
     FString MockWebServerPort;
     bool ShowAvatar;
+    // Max milliseconds per tick spent creating server objects for actors
+    float UploadTimeBudget;
+    // Max estimated bytes of actor objects to create per tick
+    int UploadByteBudget;
+    // Max number of objects in one create request
+    int UploadBatchSize;
+    // Max milliseconds per tick spent spawning actors for objects received when joining a session
+    float SpawnTimeBudget;
+    // If true, actors and avatars we create store their transform in a single quantized property
+    bool PackTransforms;
+    // Number of fractional bits in packed locations. 8 bits is 1/256 cm precision.
+    int TransformPositionBits;
+    // Number of bits per component in packed rotations
+    int TransformRotationBits;
+    // Max transform updates per second while dragging actors
+    float DragSendRate;
+    // Max actor transform updates per second while dragging. Lowers the send rate for large selections.
+    int DragUpdateBudget;
+    // Min distance in cm an actor must move during a drag before its location is sent
+    float DragMinDistance;
+    // Min angle in degrees an actor must rotate during a drag before its rotation is sent
+    float DragMinAngle;
+    // Max milliseconds per tick spent applying actor and avatar events received from the server
+    float EventTimeBudget;
+    // If true, actors locked by other users are outlined in the lock owner's color instead of drawing a copy of their
+    // meshes with a lock material.
+    bool LockOutlines;
+    // If true, actors can be moved while we wait for their locks. Their transforms are sent when the lock is granted,
+    // or reverted if another user gets the lock first.
+    bool OptimisticLocks;
+    // If true, selecting an actor and its descendants requests one lock on the topmost selected actor, which also
+    // locks its descendants, instead of a lock for each actor.
+    bool SubtreeLocks;
+    // If true, label and folder changes to actors locked by other users are merged instead of reverted. The last
+    // change to a property wins.
+    bool MergeIndependentProperties;
 
     /**
      * Relative Path to the Scene Fusion configuration file.
@@ -70,6 +122,22 @@ public:
         configs.Add("MockWebServerAddress=" + MockWebServerAddress);
         configs.Add("MockWebServerPort=" + MockWebServerPort);
         configs.Add("ShowAvatar=" + FString((ShowAvatar ? "true" : "false")));
+        configs.Add("UploadTimeBudget=" + FString::SanitizeFloat(UploadTimeBudget));
+        configs.Add("UploadByteBudget=" + FString::FromInt(UploadByteBudget));
+        configs.Add("UploadBatchSize=" + FString::FromInt(UploadBatchSize));
+        configs.Add("SpawnTimeBudget=" + FString::SanitizeFloat(SpawnTimeBudget));
+        configs.Add("PackTransforms=" + FString((PackTransforms ? "true" : "false")));
+        configs.Add("TransformPositionBits=" + FString::FromInt(TransformPositionBits));
+        configs.Add("TransformRotationBits=" + FString::FromInt(TransformRotationBits));
+        configs.Add("DragSendRate=" + FString::SanitizeFloat(DragSendRate));
+        configs.Add("DragUpdateBudget=" + FString::FromInt(DragUpdateBudget));
+        configs.Add("DragMinDistance=" + FString::SanitizeFloat(DragMinDistance));
+        configs.Add("DragMinAngle=" + FString::SanitizeFloat(DragMinAngle));
+        configs.Add("EventTimeBudget=" + FString::SanitizeFloat(EventTimeBudget));
+        configs.Add("LockOutlines=" + FString((LockOutlines ? "true" : "false")));
+        configs.Add("OptimisticLocks=" + FString((OptimisticLocks ? "true" : "false")));
+        configs.Add("SubtreeLocks=" + FString((SubtreeLocks ? "true" : "false")));
+        configs.Add("MergeIndependentProperties=" + FString((MergeIndependentProperties ? "true" : "false")));
         FFileHelper::SaveStringArrayToFile(configs, *Path());
     }
 
@@ -135,6 +203,102 @@ public:
                         ShowAvatar = value == "true";
                         continue;
                     }
+
+                    if (key.Equals("UploadTimeBudget"))
+                    {
+                        UploadTimeBudget = FCString::Atof(*value);
+                        continue;
+                    }
+
+                    if (key.Equals("UploadByteBudget"))
+                    {
+                        UploadByteBudget = FCString::Atoi(*value);
+                        continue;
+                    }
+
+                    if (key.Equals("UploadBatchSize"))
+                    {
+                        UploadBatchSize = FCString::Atoi(*value);
+                        continue;
+                    }
+
+                    if (key.Equals("SpawnTimeBudget"))
+                    {
+                        SpawnTimeBudget = FCString::Atof(*value);
+                        continue;
+                    }
+
+                    if (key.Equals("PackTransforms"))
+                    {
+                        PackTransforms = value == "true";
+                        continue;
+                    }
+
+                    if (key.Equals("TransformPositionBits"))
+                    {
+                        TransformPositionBits = FCString::Atoi(*value);
+                        continue;
+                    }
+
+                    if (key.Equals("TransformRotationBits"))
+                    {
+                        TransformRotationBits = FCString::Atoi(*value);
+                        continue;
+                    }
+
+                    if (key.Equals("DragSendRate"))
+                    {
+                        DragSendRate = FCString::Atof(*value);
+                        continue;
+                    }
+
+                    if (key.Equals("DragUpdateBudget"))
+                    {
+                        DragUpdateBudget = FCString::Atoi(*value);
+                        continue;
+                    }
+
+                    if (key.Equals("DragMinDistance"))
+                    {
+                        DragMinDistance = FCString::Atof(*value);
+                        continue;
+                    }
+
+                    if (key.Equals("DragMinAngle"))
+                    {
+                        DragMinAngle = FCString::Atof(*value);
+                        continue;
+                    }
+
+                    if (key.Equals("EventTimeBudget"))
+                    {
+                        EventTimeBudget = FCString::Atof(*value);
+                        continue;
+                    }
+
+                    if (key.Equals("LockOutlines"))
+                    {
+                        LockOutlines = value == "true";
+                        continue;
+                    }
+
+                    if (key.Equals("OptimisticLocks"))
+                    {
+                        OptimisticLocks = value == "true";
+                        continue;
+                    }
+
+                    if (key.Equals("SubtreeLocks"))
+                    {
+                        SubtreeLocks = value == "true";
+                        continue;
+                    }
+
+                    if (key.Equals("MergeIndependentProperties"))
+                    {
+                        MergeIndependentProperties = value == "true";
+                        continue;
+                    }
                 }
             }
         }
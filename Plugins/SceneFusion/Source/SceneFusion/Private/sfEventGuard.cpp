@@ -0,0 +1,31 @@
+#include "sfEventGuard.h"
+
+int64 sfEventGuard::m_numScopes = 0;
+
+sfEventGuard::Scope::Scope(sfEventGuard& guard) :
+    m_guard(guard)
+{
+    m_guard.m_depth++;
+    m_numScopes++;
+}
+
+sfEventGuard::Scope::~Scope()
+{
+    m_guard.m_depth--;
+}
+
+sfEventGuard::sfEventGuard() :
+    m_depth{ 0 }
+{
+
+}
+
+bool sfEventGuard::IsActive() const
+{
+    return m_depth > 0;
+}
+
+int64 sfEventGuard::NumScopes()
+{
+    return m_numScopes;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <CoreMinimal.h>
+
+/**
+ * Suppresses an event handler while we make changes that would trigger it, such as applying changes from the server.
+ * The handler stays bound and returns early while the guard is active instead of being unbound and rebound around
+ * each change. Scopes can be nested; the guard stays active until the outermost scope ends.
+ */
+class sfEventGuard
+{
+public:
+    /**
+     * Activates a guard until the scope is destroyed.
+     */
+    class Scope
+    {
+    public:
+        /**
+         * Constructor
+         *
+         * @param   sfEventGuard& guard to activate.
+         */
+        Scope(sfEventGuard& guard);
+
+        /**
+         * Destructor
+         */
+        ~Scope();
+
+    private:
+        sfEventGuard& m_guard;
+    };
+
+    /**
+     * Constructor
+     */
+    sfEventGuard();
+
+    /**
+     * @return  bool true if at least one scope for this guard exists.
+     */
+    bool IsActive() const;
+
+    /**
+     * @return  int64 - number of scopes created for all guards. Each scope replaces unbinding and rebinding a
+     *          delegate handler.
+     */
+    static int64 NumScopes();
+
+private:
+    int m_depth;
+
+    static int64 m_numScopes;
+};
@@ -0,0 +1,88 @@
+#include "sfFolderIndex.h"
+
+#include <EngineUtils.h>
+
+void sfFolderIndex::Rebuild(UWorld* worldPtr)
+{
+    Clear();
+    if (worldPtr == nullptr)
+    {
+        return;
+    }
+    for (TActorIterator<AActor> iter(worldPtr); iter; ++iter)
+    {
+        Update(*iter);
+    }
+}
+
+void sfFolderIndex::Update(const AActor* actorPtr)
+{
+    FName folder = actorPtr->GetFolderPath();
+    FName* oldFolderPtr = m_actorFolders.Find(actorPtr);
+    FName oldFolder = oldFolderPtr == nullptr ? NAME_None : *oldFolderPtr;
+    if (folder == oldFolder)
+    {
+        return;
+    }
+    AddToCount(oldFolder, -1);
+    AddToCount(folder, 1);
+    if (folder.IsNone())
+    {
+        m_actorFolders.Remove(actorPtr);
+    }
+    else
+    {
+        m_actorFolders.Add(actorPtr, folder);
+    }
+}
+
+void sfFolderIndex::Remove(const AActor* actorPtr)
+{
+    FName folder;
+    if (m_actorFolders.RemoveAndCopyValue(actorPtr, folder))
+    {
+        AddToCount(folder, -1);
+    }
+}
+
+int sfFolderIndex::Count(FName folder) const
+{
+    const int32* countPtr = m_folderCounts.Find(folder);
+    return countPtr == nullptr ? 0 : *countPtr;
+}
+
+bool sfFolderIndex::IsEmpty(FName folder) const
+{
+    return !m_folderCounts.Contains(folder);
+}
+
+void sfFolderIndex::Clear()
+{
+    m_actorFolders.Empty();
+    m_folderCounts.Empty();
+}
+
+void sfFolderIndex::AddToCount(FName folder, int32 delta)
+{
+    if (folder.IsNone())
+    {
+        return;
+    }
+    FString path = folder.ToString();
+    while (true)
+    {
+        FName key(*path);
+        int32& count = m_folderCounts.FindOrAdd(key);
+        count += delta;
+        if (count <= 0)
+        {
+            m_folderCounts.Remove(key);
+        }
+        int32 index;
+        if (!path.FindLastChar('/', index))
+        {
+            break;
+        }
+        path = path.Left(index);
+    }
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <CoreMinimal.h>
+#include <GameFramework/Actor.h>
+
+/**
+ * Counts the actors in each world outliner folder, including actors in subfolders, so we can tell if a folder is
+ * empty without iterating every actor in the world. Counts include synced and unsynced actors. The index is built
+ * once from the world and kept up to date from actor add, delete and folder change events.
+ */
+class sfFolderIndex
+{
+public:
+    /**
+     * Clears the index and adds all actors in a world.
+     *
+     * @param   UWorld* worldPtr to index.
+     */
+    void Rebuild(UWorld* worldPtr);
+
+    /**
+     * Adds an actor to the index, or moves it to its current folder if it is already indexed.
+     *
+     * @param   const AActor* actorPtr
+     */
+    void Update(const AActor* actorPtr);
+
+    /**
+     * Removes an actor from the index. The actor pointer is only used as a key so it may be stale.
+     *
+     * @param   const AActor* actorPtr
+     */
+    void Remove(const AActor* actorPtr);
+
+    /**
+     * Gets the number of actors in a folder and its subfolders.
+     *
+     * @param   FName folder
+     * @return  int
+     */
+    int Count(FName folder) const;
+
+    /**
+     * Checks if a folder and its subfolders have no actors.
+     *
+     * @param   FName folder
+     * @return  bool
+     */
+    bool IsEmpty(FName folder) const;
+
+    /**
+     * Removes all actors and folders.
+     */
+    void Clear();
+
+private:
+    // Folder of each indexed actor. Actors that aren't in a folder are not stored.
+    TMap<const AActor*, FName> m_actorFolders;
+    // Number of actors in each folder and its subfolders. Folders with no actors are not stored.
+    TMap<FName, int32> m_folderCounts;
+
+    /**
+     * Adds to the count of a folder and all of its parent folders.
+     *
+     * @param   FName folder
+     * @param   int32 delta to add.
+     */
+    void AddToCount(FName folder, int32 delta);
+};
@@ -0,0 +1,46 @@
+#include "sfLevelNameIndex.h"
+
+sfLevelNameIndex::sfLevelNameIndex(ULevel* levelPtr)
+{
+    if (levelPtr == nullptr)
+    {
+        return;
+    }
+    m_actors.Reserve(levelPtr->Actors.Num());
+    for (AActor* actorPtr : levelPtr->Actors)
+    {
+        if (actorPtr != nullptr)
+        {
+            Add(actorPtr);
+        }
+    }
+}
+
+bool sfLevelNameIndex::Contains(const AActor* actorPtr) const
+{
+    return m_actors.Contains(actorPtr);
+}
+
+AActor* sfLevelNameIndex::FindOther(const AActor* actorPtr) const
+{
+    for (auto iter = m_actorsByName.CreateConstKeyIterator(actorPtr->GetFName()); iter; ++iter)
+    {
+        if (iter.Value() != actorPtr)
+        {
+            return iter.Value();
+        }
+    }
+    return nullptr;
+}
+
+void sfLevelNameIndex::Add(AActor* actorPtr)
+{
+    m_actors.Add(actorPtr);
+    m_actorsByName.AddUnique(actorPtr->GetFName(), actorPtr);
+}
+
+void sfLevelNameIndex::Remove(AActor* actorPtr)
+{
+    m_actors.Remove(actorPtr);
+    m_actorsByName.RemoveSingle(actorPtr->GetFName(), actorPtr);
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <CoreMinimal.h>
+#include <GameFramework/Actor.h>
+#include <Engine/Level.h>
+
+/**
+ * Indexes the actors in a level's actor list by name so checking many actors for name collisions takes one pass over
+ * the level instead of one pass per actor. The index is a snapshot; callers keep it current by adding and removing
+ * actors they spawn, rename or destroy while using it.
+ */
+class sfLevelNameIndex
+{
+public:
+    /**
+     * Constructor. Indexes the actors in a level.
+     *
+     * @param   ULevel* levelPtr to index.
+     */
+    sfLevelNameIndex(ULevel* levelPtr);
+
+    /**
+     * Checks if an actor is in the level's actor list.
+     *
+     * @param   const AActor* actorPtr
+     * @return  bool
+     */
+    bool Contains(const AActor* actorPtr) const;
+
+    /**
+     * Finds another actor in the level with the same name as an actor.
+     *
+     * @param   const AActor* actorPtr
+     * @return  AActor* with the same name, or nullptr if no other actor has the name.
+     */
+    AActor* FindOther(const AActor* actorPtr) const;
+
+    /**
+     * Adds an actor to the index.
+     *
+     * @param   AActor* actorPtr
+     */
+    void Add(AActor* actorPtr);
+
+    /**
+     * Removes an actor from the index. Call this before renaming the actor.
+     *
+     * @param   AActor* actorPtr
+     */
+    void Remove(AActor* actorPtr);
+
+private:
+    TSet<const AActor*> m_actors;
+    TMultiMap<FName, AActor*> m_actorsByName;
+};
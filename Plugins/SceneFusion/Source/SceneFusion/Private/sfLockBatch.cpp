@@ -0,0 +1,286 @@
+#include "sfLockBatch.h"
+
+#include <Log.h>
+#include <algorithm>
+
+#define LOG_CHANNEL "sfLockBatch"
+
+sfLockBatch::sfLockBatch() :
+    m_subtreeLocks{ true },
+    m_waitStartTime{ 0.0 },
+    m_waitCount{ 0 },
+    m_statsCommandPtr{ nullptr }
+{
+
+}
+
+sfLockBatch::~sfLockBatch()
+{
+
+}
+
+void sfLockBatch::Initialize(bool subtreeLocks)
+{
+    m_subtreeLocks = subtreeLocks;
+    m_stats = Stats();
+    m_statsCommandPtr = IConsoleManager::Get().RegisterConsoleCommand(
+        TEXT("SFLockStats"),
+        TEXT("Usage: SFLockStats. Logs how long lock requests for selections took and how lock events were grouped."),
+        FConsoleCommandDelegate::CreateRaw(this, &sfLockBatch::LogStats));
+}
+
+void sfLockBatch::CleanUp()
+{
+    if (m_statsCommandPtr != nullptr)
+    {
+        IConsoleManager::Get().UnregisterConsoleObject(m_statsCommandPtr);
+        m_statsCommandPtr = nullptr;
+    }
+    m_requests.clear();
+    m_releases.clear();
+    m_sent.clear();
+    m_pending.clear();
+    m_held.clear();
+    m_covered.clear();
+    m_waitCount = 0;
+}
+
+void sfLockBatch::SetSubtreeLocks(bool subtreeLocks)
+{
+    m_subtreeLocks = subtreeLocks;
+}
+
+void sfLockBatch::Request(sfObject::SPtr objPtr)
+{
+    if (m_releases.erase(objPtr) > 0)
+    {
+        m_stats.Cancelled++;
+        return;
+    }
+    m_requests.insert(objPtr);
+}
+
+void sfLockBatch::Release(sfObject::SPtr objPtr)
+{
+    m_pending.erase(objPtr);
+    if (m_requests.erase(objPtr) > 0)
+    {
+        m_stats.Cancelled++;
+        return;
+    }
+    // Covered objects have no lock of their own to release
+    if (m_covered.erase(objPtr) == 0)
+    {
+        m_releases.insert(objPtr);
+    }
+}
+
+const std::vector<sfObject::SPtr>& sfLockBatch::Send()
+{
+    m_sent.clear();
+    for (const sfObject::SPtr& objPtr : m_releases)
+    {
+        objPtr->ReleaseLock();
+        m_held.erase(objPtr);
+    }
+    m_stats.Releases += m_releases.size();
+    m_releases.clear();
+
+    // Objects whose covering lock was released, or that were moved out of its subtree, need their own locks
+    for (auto iter = m_covered.begin(); iter != m_covered.end();)
+    {
+        if (IsHeld(iter->second) && iter->first->IsDescendantOf(iter->second))
+        {
+            ++iter;
+        }
+        else
+        {
+            m_requests.insert(iter->first);
+            iter = m_covered.erase(iter);
+        }
+    }
+    if (m_requests.size() == 0)
+    {
+        return m_sent;
+    }
+    if (m_pending.size() == 0)
+    {
+        m_waitStartTime = FPlatformTime::Seconds();
+        m_waitCount = 0;
+    }
+
+    // Request ancestors before descendants so one lock covers each selected subtree
+    std::vector<std::pair<int, sfObject::SPtr>> requests;
+    requests.reserve(m_requests.size());
+    for (const sfObject::SPtr& objPtr : m_requests)
+    {
+        int depth = 0;
+        if (m_subtreeLocks)
+        {
+            for (sfObject::SPtr parentPtr = objPtr->Parent(); parentPtr != nullptr; parentPtr = parentPtr->Parent())
+            {
+                depth++;
+            }
+        }
+        requests.emplace_back(depth, objPtr);
+    }
+    if (m_subtreeLocks)
+    {
+        std::stable_sort(requests.begin(), requests.end(),
+            [](const std::pair<int, sfObject::SPtr>& a, const std::pair<int, sfObject::SPtr>& b)
+        {
+            return a.first < b.first;
+        });
+    }
+
+    m_sent.reserve(requests.size());
+    double time = FPlatformTime::Seconds();
+    for (const std::pair<int, sfObject::SPtr>& request : requests)
+    {
+        sfObject::SPtr objPtr = request.second;
+        sfObject::SPtr ancestorPtr = m_subtreeLocks ? FindHeldAncestor(objPtr) : nullptr;
+        if (ancestorPtr != nullptr)
+        {
+            m_covered[objPtr] = ancestorPtr;
+            m_stats.Covered++;
+            continue;
+        }
+        objPtr->RequestLock();
+        m_held.insert(objPtr);
+        m_pending[objPtr] = time;
+        m_sent.push_back(objPtr);
+    }
+    m_waitCount += (int)m_sent.size();
+    m_stats.Requests += m_sent.size();
+    m_requests.clear();
+    return m_sent;
+}
+
+bool sfLockBatch::IsPending(sfObject::SPtr objPtr)
+{
+    if (m_pending.find(objPtr) != m_pending.end())
+    {
+        return true;
+    }
+    auto iter = m_covered.find(objPtr);
+    return iter != m_covered.end() && m_pending.find(iter->second) != m_pending.end();
+}
+
+bool sfLockBatch::IsHeld(sfObject::SPtr objPtr)
+{
+    if (m_held.find(objPtr) == m_held.end())
+    {
+        return false;
+    }
+    // Locks can be released without going through the batch, such as when the actor is deleted
+    if (objPtr->IsLockPending() || (objPtr->LockOwner() != nullptr && !objPtr->IsLocked()))
+    {
+        return true;
+    }
+    m_held.erase(objPtr);
+    return false;
+}
+
+sfObject::SPtr sfLockBatch::FindHeldAncestor(sfObject::SPtr objPtr)
+{
+    for (sfObject::SPtr parentPtr = objPtr->Parent(); parentPtr != nullptr; parentPtr = parentPtr->Parent())
+    {
+        if (IsHeld(parentPtr))
+        {
+            return parentPtr;
+        }
+    }
+    return nullptr;
+}
+
+void sfLockBatch::Tick()
+{
+    if (m_pending.size() == 0)
+    {
+        return;
+    }
+    double time = FPlatformTime::Seconds();
+    for (auto iter = m_pending.begin(); iter != m_pending.end();)
+    {
+        sfObject::SPtr objPtr = iter->first;
+        if (objPtr->IsLockPending())
+        {
+            ++iter;
+            continue;
+        }
+        // We own the lock if there is a lock owner and the object is not locked by another user
+        if (objPtr->LockOwner() != nullptr && !objPtr->IsLocked())
+        {
+            double grantTime = time - iter->second;
+            m_stats.Grants++;
+            m_stats.TotalGrantTime += grantTime;
+            m_stats.MaxGrantTime = FMath::Max(m_stats.MaxGrantTime, grantTime);
+        }
+        iter = m_pending.erase(iter);
+    }
+    if (m_pending.size() > 0)
+    {
+        return;
+    }
+    double waitTime = time - m_waitStartTime;
+    m_stats.Waits++;
+    m_stats.TotalWaitTime += waitTime;
+    m_stats.LastWaitTime = waitTime;
+    m_stats.LastWaitCount = m_waitCount;
+    m_stats.MaxWaitTime = FMath::Max(m_stats.MaxWaitTime, waitTime);
+}
+
+void sfLockBatch::OnGroupApplied(int numEvents, int numChanges)
+{
+    m_stats.Events += numEvents;
+    m_stats.Changes += numChanges;
+    m_stats.Groups++;
+}
+
+void sfLockBatch::OnOptimisticEdit()
+{
+    m_stats.OptimisticEdits++;
+}
+
+void sfLockBatch::OnRollback()
+{
+    m_stats.Rollbacks++;
+}
+
+void sfLockBatch::OnMergedEdit()
+{
+    m_stats.MergedEdits++;
+}
+
+int sfLockBatch::NumPending()
+{
+    return (int)m_pending.size();
+}
+
+void sfLockBatch::LogStats()
+{
+    KS::Log::Info("Lock requests: " + std::to_string(m_stats.Requests) + " requested, " +
+        std::to_string(m_stats.Covered) + " covered by an ancestor's lock, " +
+        std::to_string(m_stats.Releases) + " released, " + std::to_string(m_stats.Cancelled) +
+        " cancelled in the same tick, " + std::to_string(m_pending.size()) + " waiting.", LOG_CHANNEL);
+    double averageWaitTime = m_stats.Waits > 0 ? m_stats.TotalWaitTime / m_stats.Waits : 0.0;
+    KS::Log::Info("Wait for edit rights on the selection: " + std::to_string(m_stats.LastWaitTime * 1000.0) +
+        " ms last (" + std::to_string(m_stats.LastWaitCount) + " locks), " +
+        std::to_string(averageWaitTime * 1000.0) + " ms average, " + std::to_string(m_stats.MaxWaitTime * 1000.0) +
+        " ms max over " + std::to_string(m_stats.Waits) + " selections.", LOG_CHANNEL);
+    double averageGrantTime = m_stats.Grants > 0 ? m_stats.TotalGrantTime / m_stats.Grants : 0.0;
+    KS::Log::Info("Lock grant latency: " + std::to_string(averageGrantTime * 1000.0) + " ms average, " +
+        std::to_string(m_stats.MaxGrantTime * 1000.0) + " ms max over " + std::to_string(m_stats.Grants) + " locks.",
+        LOG_CHANNEL);
+    double rollbackRate = m_stats.OptimisticEdits > 0 ? (double)m_stats.Rollbacks / m_stats.OptimisticEdits : 0.0;
+    KS::Log::Info("Edits while waiting for locks: " + std::to_string(m_stats.OptimisticEdits) + " actors, " +
+        std::to_string(m_stats.Rollbacks) + " rolled back (" + std::to_string(rollbackRate * 100.0) + "%).",
+        LOG_CHANNEL);
+    KS::Log::Info("Edits merged on actors locked by other users: " + std::to_string(m_stats.MergedEdits) + ".",
+        LOG_CHANNEL);
+    KS::Log::Info("Lock events: " + std::to_string(m_stats.Events) + " received, " +
+        std::to_string(m_stats.Changes) + " actor lock changes applied in " + std::to_string(m_stats.Groups) +
+        " groups.", LOG_CHANNEL);
+}
+
+#undef LOG_CHANNEL
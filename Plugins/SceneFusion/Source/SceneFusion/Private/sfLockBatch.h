@@ -0,0 +1,185 @@
+#pragma once
+
+#include <CoreMinimal.h>
+#include <HAL/IConsoleManager.h>
+#include <sfObject.h>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+using namespace KS::SceneFusion2;
+
+/**
+ * Batches lock requests and releases from selection changes so a selection change sends all of its requests and
+ * releases together once per tick. A request and release for the same object in the same tick cancel out. With
+ * subtree locks, an object whose ancestor's lock we hold or are requesting is not locked separately, since a lock on
+ * an object also locks its descendants. Such objects are covered by the ancestor's lock and get their own lock if
+ * the ancestor is released or they are moved out of its subtree. Measures how long the user waits from selecting
+ * objects until they own the locks on the whole selection, how long each lock takes to be granted, how often edits
+ * made while waiting for a lock are rolled back, how many edits were merged without a lock, and counts lock events
+ * applied as groups. Stats are logged with the SFLockStats console command.
+ */
+class sfLockBatch
+{
+public:
+    /**
+     * Constructor
+     */
+    sfLockBatch();
+
+    /**
+     * Destructor
+     */
+    ~sfLockBatch();
+
+    /**
+     * Registers the stats console command and resets the stats.
+     *
+     * @param   bool subtreeLocks - if true, objects covered by an ancestor's lock are not locked separately.
+     */
+    void Initialize(bool subtreeLocks);
+
+    /**
+     * Unregisters the stats console command and discards queued and pending requests.
+     */
+    void CleanUp();
+
+    /**
+     * Sets if objects covered by an ancestor's lock are locked separately. Affects requests sent after this call.
+     *
+     * @param   bool subtreeLocks - if true, objects covered by an ancestor's lock are not locked separately.
+     */
+    void SetSubtreeLocks(bool subtreeLocks);
+
+    /**
+     * Queues a lock request for an object.
+     *
+     * @param   sfObject::SPtr objPtr to lock.
+     */
+    void Request(sfObject::SPtr objPtr);
+
+    /**
+     * Queues a lock release for an object.
+     *
+     * @param   sfObject::SPtr objPtr to unlock.
+     */
+    void Release(sfObject::SPtr objPtr);
+
+    /**
+     * Sends queued releases and then queued requests. Requests for objects covered by an ancestor's lock are not
+     * sent.
+     *
+     * @return  const std::vector<sfObject::SPtr>& objects whose locks were requested.
+     */
+    const std::vector<sfObject::SPtr>& Send();
+
+    /**
+     * Checks which requested locks were acquired. When all requested locks are acquired, records how long the user
+     * waited since the first request. Call once per tick.
+     */
+    void Tick();
+
+    /**
+     * Records lock events that were applied as one group.
+     *
+     * @param   int numEvents - number of lock, unlock and lock owner change events received.
+     * @param   int numChanges - number of actors whose lock state changed.
+     */
+    void OnGroupApplied(int numEvents, int numChanges);
+
+    /**
+     * Records an actor edited while we were waiting for its lock.
+     */
+    void OnOptimisticEdit();
+
+    /**
+     * Records an edit made while waiting for a lock that was rolled back because another user got the lock first.
+     */
+    void OnRollback();
+
+    /**
+     * Records an edit to an actor locked by another user that was merged instead of reverted.
+     */
+    void OnMergedEdit();
+
+    /**
+     * Checks if we are waiting for the lock on an object, or on the ancestor whose lock covers it.
+     *
+     * @param   sfObject::SPtr objPtr
+     * @return  bool
+     */
+    bool IsPending(sfObject::SPtr objPtr);
+
+    /**
+     * @return  int - number of requested locks we are waiting for.
+     */
+    int NumPending();
+
+private:
+    /**
+     * Lock wait times and lock event counts.
+     */
+    struct Stats
+    {
+    public:
+        int64 Requests = 0;
+        // Requests not sent because an ancestor's lock covers the object
+        int64 Covered = 0;
+        int64 Releases = 0;
+        // Requests cancelled by a release in the same tick
+        int64 Cancelled = 0;
+        int64 Waits = 0;
+        double TotalWaitTime = 0.0;
+        double LastWaitTime = 0.0;
+        double MaxWaitTime = 0.0;
+        int LastWaitCount = 0;
+        int64 Events = 0;
+        int64 Changes = 0;
+        int64 Groups = 0;
+        int64 Grants = 0;
+        double TotalGrantTime = 0.0;
+        double MaxGrantTime = 0.0;
+        int64 OptimisticEdits = 0;
+        int64 Rollbacks = 0;
+        int64 MergedEdits = 0;
+    };
+
+    std::unordered_set<sfObject::SPtr> m_requests;
+    std::unordered_set<sfObject::SPtr> m_releases;
+    std::vector<sfObject::SPtr> m_sent;
+    // Requested objects whose locks have not been acquired, and the times their locks were requested
+    std::unordered_map<sfObject::SPtr, double> m_pending;
+    // Objects whose locks we requested and have not released
+    std::unordered_set<sfObject::SPtr> m_held;
+    // Objects covered by an ancestor's lock, and the ancestor
+    std::unordered_map<sfObject::SPtr, sfObject::SPtr> m_covered;
+    bool m_subtreeLocks;
+    // Time of the first request since all locks were last acquired
+    double m_waitStartTime;
+    // Number of locks requested since all locks were last acquired
+    int m_waitCount;
+    Stats m_stats;
+    IConsoleCommand* m_statsCommandPtr;
+
+    /**
+     * Checks if we requested an object's lock and still own it or are waiting for it. Forgets objects whose locks were
+     * released without going through the batch.
+     *
+     * @param   sfObject::SPtr objPtr
+     * @return  bool
+     */
+    bool IsHeld(sfObject::SPtr objPtr);
+
+    /**
+     * Finds the closest ancestor of an object whose lock we hold or are waiting for.
+     *
+     * @param   sfObject::SPtr objPtr
+     * @return  sfObject::SPtr ancestor, or nullptr if there is none.
+     */
+    sfObject::SPtr FindHeldAncestor(sfObject::SPtr objPtr);
+
+    /**
+     * Logs lock wait times and lock event counts.
+     */
+    void LogStats();
+};
@@ -0,0 +1,78 @@
+#include "sfLockIndex.h"
+
+bool sfLockIndex::Add(AActor* actorPtr, sfUser::SPtr lockOwnerPtr)
+{
+    int64 owner = GetOwnerKey(lockOwnerPtr);
+    int64* oldOwnerPtr = m_actorOwners.Find(actorPtr);
+    if (oldOwnerPtr != nullptr)
+    {
+        if (*oldOwnerPtr == owner)
+        {
+            return false;
+        }
+        TSet<AActor*>* actorsPtr = m_ownerActors.Find(*oldOwnerPtr);
+        if (actorsPtr != nullptr && actorsPtr->Remove(actorPtr) > 0 && actorsPtr->Num() == 0)
+        {
+            m_ownerActors.Remove(*oldOwnerPtr);
+        }
+    }
+    m_actorOwners.Add(actorPtr, owner);
+    m_ownerActors.FindOrAdd(owner).Add(actorPtr);
+    return true;
+}
+
+void sfLockIndex::Remove(const AActor* actorPtr)
+{
+    int64 owner;
+    if (!m_actorOwners.RemoveAndCopyValue(actorPtr, owner))
+    {
+        return;
+    }
+    TSet<AActor*>* actorsPtr = m_ownerActors.Find(owner);
+    if (actorsPtr != nullptr && actorsPtr->Remove(const_cast<AActor*>(actorPtr)) > 0 && actorsPtr->Num() == 0)
+    {
+        m_ownerActors.Remove(owner);
+    }
+}
+
+bool sfLockIndex::Contains(const AActor* actorPtr) const
+{
+    return m_actorOwners.Contains(actorPtr);
+}
+
+void sfLockIndex::GetActors(sfUser::SPtr lockOwnerPtr, TArray<AActor*>& actors) const
+{
+    const TSet<AActor*>* actorsPtr = m_ownerActors.Find(GetOwnerKey(lockOwnerPtr));
+    if (actorsPtr != nullptr)
+    {
+        actors.Append(actorsPtr->Array());
+    }
+}
+
+void sfLockIndex::GetAllActors(TArray<AActor*>& actors) const
+{
+    actors.Reserve(actors.Num() + m_actorOwners.Num());
+    for (const auto& pair : m_ownerActors)
+    {
+        for (AActor* actorPtr : pair.Value)
+        {
+            actors.Add(actorPtr);
+        }
+    }
+}
+
+int sfLockIndex::Num() const
+{
+    return m_actorOwners.Num();
+}
+
+void sfLockIndex::Clear()
+{
+    m_actorOwners.Empty();
+    m_ownerActors.Empty();
+}
+
+int64 sfLockIndex::GetOwnerKey(sfUser::SPtr lockOwnerPtr)
+{
+    return lockOwnerPtr == nullptr ? -1 : (int64)lockOwnerPtr->Id();
+}
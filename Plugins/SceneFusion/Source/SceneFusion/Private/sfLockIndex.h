@@ -0,0 +1,80 @@
+#pragma once
+
+#include <CoreMinimal.h>
+#include <GameFramework/Actor.h>
+#include <sfUser.h>
+
+using namespace KS::SceneFusion2;
+
+/**
+ * Index of actors that are locked by other users, grouped by lock owner, so we can find the actors locked by a user
+ * without iterating every actor in the world. Actors that are indirectly locked by a descendant and have no lock owner
+ * are grouped together. Kept up to date from lock, unlock and lock owner change events. Actors must be removed before
+ * they are destroyed.
+ */
+class sfLockIndex
+{
+public:
+    /**
+     * Adds an actor to the index, or moves it to a new lock owner's group if it is already indexed.
+     *
+     * @param   AActor* actorPtr
+     * @param   sfUser::SPtr lockOwnerPtr. nullptr if the actor is indirectly locked by a descendant.
+     * @return  bool false if the actor was already indexed with this lock owner.
+     */
+    bool Add(AActor* actorPtr, sfUser::SPtr lockOwnerPtr);
+
+    /**
+     * Removes an actor from the index. The actor pointer is only used as a key so it may be stale.
+     *
+     * @param   const AActor* actorPtr
+     */
+    void Remove(const AActor* actorPtr);
+
+    /**
+     * Checks if an actor is in the index.
+     *
+     * @param   const AActor* actorPtr
+     * @return  bool
+     */
+    bool Contains(const AActor* actorPtr) const;
+
+    /**
+     * Gets the actors locked by a user.
+     *
+     * @param   sfUser::SPtr lockOwnerPtr. If nullptr, gets actors that are indirectly locked by a descendant.
+     * @param   TArray<AActor*>& actors - the actors are added to this.
+     */
+    void GetActors(sfUser::SPtr lockOwnerPtr, TArray<AActor*>& actors) const;
+
+    /**
+     * Gets all indexed actors.
+     *
+     * @param   TArray<AActor*>& actors - the actors are added to this.
+     */
+    void GetAllActors(TArray<AActor*>& actors) const;
+
+    /**
+     * @return  int - number of indexed actors.
+     */
+    int Num() const;
+
+    /**
+     * Removes all actors.
+     */
+    void Clear();
+
+private:
+    // Lock owner id of each indexed actor, or -1 if the actor has no lock owner
+    TMap<const AActor*, int64> m_actorOwners;
+    // Actors locked by each lock owner id
+    TMap<int64, TSet<AActor*>> m_ownerActors;
+
+    /**
+     * Gets the key for a lock owner.
+     *
+     * @param   sfUser::SPtr lockOwnerPtr
+     * @return  int64 lock owner's id, or -1 if lockOwnerPtr is nullptr.
+     */
+    static int64 GetOwnerKey(sfUser::SPtr lockOwnerPtr);
+};
@@ -0,0 +1,415 @@
+#include "sfLockRenderer.h"
+#include "sfActorUtil.h"
+#include "SceneFusion.h"
+
+#include <Log.h>
+#include <Editor.h>
+#include <HAL/IConsoleManager.h>
+#include <Materials/Material.h>
+#include <Materials/MaterialExpressionCustom.h>
+#include <Materials/MaterialExpressionSceneTexture.h>
+#include <Materials/MaterialExpressionScalarParameter.h>
+#include <Materials/MaterialExpressionVectorParameter.h>
+
+// Stencil value for actors that are indirectly locked by a descendant. Users get values below this.
+#define INDIRECT_LOCK_STENCIL 255
+// r.CustomDepth value that renders custom depth with stencil values
+#define CUSTOM_DEPTH_WITH_STENCIL 3
+// Outline width in pixels
+#define OUTLINE_WIDTH 2
+#define LOG_CHANNEL "sfLockRenderer"
+
+sfLockRenderer::sfLockRenderer() :
+    m_mode{ DuplicateMeshes },
+    m_outlineMaterialPtr{ nullptr },
+    m_previousCustomDepthMode{ -1 }
+{
+    m_lockMaterialPtr = LoadObject<UMaterialInterface>(nullptr, TEXT("/SceneFusion/LockMaterial"));
+}
+
+sfLockRenderer::~sfLockRenderer()
+{
+
+}
+
+void sfLockRenderer::Initialize(Mode mode)
+{
+    m_mode = mode;
+    if (m_mode != Outlines)
+    {
+        return;
+    }
+    if (m_outlineMaterialPtr == nullptr)
+    {
+        m_outlineMaterialPtr = CreateOutlineBaseMaterial();
+    }
+
+    // Outlines need stencil values in the custom depth buffer
+    IConsoleVariable* customDepthPtr = IConsoleManager::Get().FindConsoleVariable(TEXT("r.CustomDepth"));
+    if (customDepthPtr != nullptr && customDepthPtr->GetInt() != CUSTOM_DEPTH_WITH_STENCIL)
+    {
+        m_previousCustomDepthMode = customDepthPtr->GetInt();
+        customDepthPtr->Set(CUSTOM_DEPTH_WITH_STENCIL);
+    }
+    for (int32 stencil = INDIRECT_LOCK_STENCIL - 1; stencil > 0; stencil--)
+    {
+        m_freeStencils.Add(stencil);
+    }
+    m_onPreSaveWorldHandle = FEditorDelegates::PreSaveWorld.AddRaw(this, &sfLockRenderer::OnPreSaveWorld);
+    m_onPostSaveWorldHandle = FEditorDelegates::PostSaveWorld.AddRaw(this, &sfLockRenderer::OnPostSaveWorld);
+}
+
+void sfLockRenderer::CleanUp()
+{
+    FEditorDelegates::PreSaveWorld.Remove(m_onPreSaveWorldHandle);
+    FEditorDelegates::PostSaveWorld.Remove(m_onPostSaveWorldHandle);
+    if (m_previousCustomDepthMode >= 0)
+    {
+        IConsoleVariable* customDepthPtr = IConsoleManager::Get().FindConsoleVariable(TEXT("r.CustomDepth"));
+        if (customDepthPtr != nullptr)
+        {
+            customDepthPtr->Set(m_previousCustomDepthMode);
+        }
+        m_previousCustomDepthMode = -1;
+    }
+    if (m_volumePtr.IsValid())
+    {
+        m_volumePtr->GetWorld()->DestroyActor(m_volumePtr.Get());
+    }
+    m_volumePtr.Reset();
+    for (auto iter : m_lockMaterials)
+    {
+        iter.Value->ClearFlags(EObjectFlags::RF_Standalone);// Allow unreal to destroy the material instances
+    }
+    for (auto iter : m_outlineMaterials)
+    {
+        iter.Value->ClearFlags(EObjectFlags::RF_Standalone);
+    }
+    if (m_outlineMaterialPtr != nullptr)
+    {
+        m_outlineMaterialPtr->ClearFlags(EObjectFlags::RF_Standalone);
+        m_outlineMaterialPtr = nullptr;
+    }
+    m_lockMaterials.Empty();
+    m_outlineMaterials.Empty();
+    m_stencils.Empty();
+    m_freeStencils.Empty();
+    m_outlineLocks.Empty();
+}
+
+sfLockRenderer::Mode sfLockRenderer::GetMode() const
+{
+    return m_mode;
+}
+
+void sfLockRenderer::Lock(AActor* actorPtr, sfUser::SPtr lockOwnerPtr)
+{
+    if (m_mode == DuplicateMeshes && m_lockMaterialPtr != nullptr)
+    {
+        UMaterialInterface* lockMaterialPtr = GetLockMaterial(lockOwnerPtr);
+        TArray<UMeshComponent*> meshes;
+        actorPtr->GetComponents(meshes);
+        if (meshes.Num() > 0)
+        {
+            for (int i = 0; i < meshes.Num(); i++)
+            {
+                UsfLockComponent* lockPtr = NewObject<UsfLockComponent>(actorPtr, *FString("SFLock" + FString::FromInt(i)));
+                lockPtr->CreationMethod = EComponentCreationMethod::Instance;
+                lockPtr->SetMobility(meshes[i]->Mobility);
+                lockPtr->AttachToComponent(meshes[i], FAttachmentTransformRules::KeepRelativeTransform);
+                lockPtr->RegisterComponent();
+                lockPtr->InitializeComponent();
+                lockPtr->DuplicateParentMesh(lockMaterialPtr);
+                SceneFusion::RedrawActiveViewport();
+            }
+            return;
+        }
+    }
+    UsfLockComponent* lockPtr = NewObject<UsfLockComponent>(actorPtr, *FString("SFLock"));
+    lockPtr->CreationMethod = EComponentCreationMethod::Instance;
+    lockPtr->AttachToComponent(actorPtr->GetRootComponent(), FAttachmentTransformRules::KeepRelativeTransform);
+    lockPtr->RegisterComponent();
+    lockPtr->InitializeComponent();
+    if (m_mode == Outlines)
+    {
+        lockPtr->Outline(GetStencil(lockOwnerPtr, actorPtr->GetWorld()));
+        m_outlineLocks.Add(lockPtr);
+        SceneFusion::RedrawActiveViewport();
+    }
+}
+
+void sfLockRenderer::Unlock(AActor* actorPtr)
+{
+    // If you undo the deletion of an actor with lock components, the lock components will not be part of the
+    // OwnedComponents set so we have to use our own function to find them instead of AActor->GetComponents.
+    // Not sure why this happens. It seems like an Unreal bug.
+    TArray<UsfLockComponent*> locks;
+    sfActorUtil::GetSceneComponents<UsfLockComponent>(actorPtr, locks);
+    for (UsfLockComponent* lockPtr : locks)
+    {
+        m_outlineLocks.Remove(lockPtr);
+        lockPtr->DestroyComponent();
+        SceneFusion::RedrawActiveViewport();
+    }
+}
+
+void sfLockRenderer::SetLockOwner(AActor* actorPtr, sfUser::SPtr lockOwnerPtr)
+{
+    TArray<UsfLockComponent*> locks;
+    sfActorUtil::GetSceneComponents<UsfLockComponent>(actorPtr, locks);
+    if (locks.Num() == 0)
+    {
+        return;
+    }
+    if (m_mode == Outlines)
+    {
+        int32 stencil = GetStencil(lockOwnerPtr, actorPtr->GetWorld());
+        for (UsfLockComponent* lockPtr : locks)
+        {
+            lockPtr->Outline(stencil);
+        }
+        return;
+    }
+    UMaterialInterface* lockMaterialPtr = GetLockMaterial(lockOwnerPtr);
+    if (lockMaterialPtr == nullptr)
+    {
+        return;
+    }
+    for (UsfLockComponent* lockPtr : locks)
+    {
+        lockPtr->SetMaterial(lockMaterialPtr);
+    }
+}
+
+void sfLockRenderer::OnUserColorChange(sfUser::SPtr userPtr)
+{
+    UMaterialInstanceDynamic** materialPtrPtr = m_lockMaterials.Find(userPtr->Id());
+    if (materialPtrPtr != nullptr)
+    {
+        SetColor(*materialPtrPtr, userPtr);
+    }
+    int32* stencilPtr = m_stencils.Find(userPtr->Id());
+    if (stencilPtr != nullptr)
+    {
+        materialPtrPtr = m_outlineMaterials.Find(*stencilPtr);
+        if (materialPtrPtr != nullptr)
+        {
+            SetColor(*materialPtrPtr, userPtr);
+        }
+    }
+}
+
+void sfLockRenderer::OnUserLeave(sfUser::SPtr userPtr)
+{
+    UMaterialInstanceDynamic* materialPtr;
+    if (m_lockMaterials.RemoveAndCopyValue(userPtr->Id(), materialPtr))
+    {
+        materialPtr->ClearFlags(EObjectFlags::RF_Standalone);// Allow unreal to destroy the material instance
+    }
+    int32 stencil;
+    if (!m_stencils.RemoveAndCopyValue(userPtr->Id(), stencil))
+    {
+        return;
+    }
+    m_freeStencils.Add(stencil);
+    if (m_outlineMaterials.RemoveAndCopyValue(stencil, materialPtr))
+    {
+        if (m_volumePtr.IsValid())
+        {
+            m_volumePtr->Settings.WeightedBlendables.Array.RemoveAll([materialPtr](const FWeightedBlendable& blendable)
+            {
+                return blendable.Object == materialPtr;
+            });
+        }
+        materialPtr->ClearFlags(EObjectFlags::RF_Standalone);
+    }
+}
+
+int sfLockRenderer::NumOutlineMaterials() const
+{
+    return m_outlineMaterials.Num();
+}
+
+UMaterialInterface* sfLockRenderer::GetLockMaterial(sfUser::SPtr userPtr)
+{
+    if (userPtr == nullptr)
+    {
+        return m_lockMaterialPtr;
+    }
+    UMaterialInstanceDynamic** materialPtrPtr = m_lockMaterials.Find(userPtr->Id());
+    if (materialPtrPtr != nullptr)
+    {
+        return Cast<UMaterialInterface>(*materialPtrPtr);
+    }
+    UMaterialInstanceDynamic* materialPtr = UMaterialInstanceDynamic::Create(m_lockMaterialPtr, nullptr);
+    materialPtr->SetFlags(EObjectFlags::RF_Standalone);//prevent material from being destroyed
+    SetColor(materialPtr, userPtr);
+    m_lockMaterials.Add(userPtr->Id(), materialPtr);
+    return Cast<UMaterialInterface>(materialPtr);
+}
+
+UMaterial* sfLockRenderer::CreateOutlineBaseMaterial()
+{
+    UMaterial* materialPtr = NewObject<UMaterial>(GetTransientPackage(), NAME_None, RF_Transient);
+    materialPtr->SetFlags(EObjectFlags::RF_Standalone);//prevent material from being destroyed
+    materialPtr->MaterialDomain = MD_PostProcess;
+    materialPtr->BlendableLocation = BL_BeforeTonemapping;
+
+    UMaterialExpressionScalarParameter* stencilPtr = NewObject<UMaterialExpressionScalarParameter>(materialPtr);
+    stencilPtr->ParameterName = "Stencil";
+    UMaterialExpressionVectorParameter* colorPtr = NewObject<UMaterialExpressionVectorParameter>(materialPtr);
+    colorPtr->ParameterName = "Color";
+    colorPtr->DefaultValue = FLinearColor::White;
+    UMaterialExpressionSceneTexture* sceneColorPtr = NewObject<UMaterialExpressionSceneTexture>(materialPtr);
+    sceneColorPtr->SceneTextureId = PPI_PostProcessInput0;
+    // Sampling custom stencil with a scene texture expression makes the material bind the custom stencil texture for
+    // the custom expression to sample the neighbouring pixels.
+    UMaterialExpressionSceneTexture* centerStencilPtr = NewObject<UMaterialExpressionSceneTexture>(materialPtr);
+    centerStencilPtr->SceneTextureId = PPI_CustomStencil;
+
+    UMaterialExpressionCustom* outlinePtr = NewObject<UMaterialExpressionCustom>(materialPtr);
+    outlinePtr->OutputType = CMOT_Float3;
+    outlinePtr->Inputs.Empty();
+    FCustomInput input;
+    input.InputName = "SceneColor";
+    input.Input.Connect(0, sceneColorPtr);
+    outlinePtr->Inputs.Add(input);
+    input.InputName = "CenterStencil";
+    input.Input.Connect(0, centerStencilPtr);
+    outlinePtr->Inputs.Add(input);
+    input.InputName = "Stencil";
+    input.Input.Connect(0, stencilPtr);
+    outlinePtr->Inputs.Add(input);
+    input.InputName = "Color";
+    input.Input.Connect(0, colorPtr);
+    outlinePtr->Inputs.Add(input);
+    // Pixels outside the outlined actors that are next to a pixel with the stencil value are drawn in the color
+    outlinePtr->Code = FString::Printf(TEXT(
+        "if (abs(CenterStencil.r - Stencil) < 0.5) return SceneColor.rgb;\n"
+        "float2 uv = GetDefaultSceneTextureUV(Parameters, %d);\n"
+        "float2 offset = View.BufferSizeAndInvSize.zw * %d;\n"
+        "float2 offsets[4] = { float2(offset.x, 0), float2(-offset.x, 0), float2(0, offset.y), "
+        "float2(0, -offset.y) };\n"
+        "for (int i = 0; i < 4; i++)\n"
+        "{\n"
+        "    if (abs(SceneTextureLookup(uv + offsets[i], %d, false).r - Stencil) < 0.5) return Color.rgb;\n"
+        "}\n"
+        "return SceneColor.rgb;"),
+        (int32)PPI_CustomStencil, OUTLINE_WIDTH, (int32)PPI_CustomStencil);
+
+    materialPtr->Expressions.Add(stencilPtr);
+    materialPtr->Expressions.Add(colorPtr);
+    materialPtr->Expressions.Add(sceneColorPtr);
+    materialPtr->Expressions.Add(centerStencilPtr);
+    materialPtr->Expressions.Add(outlinePtr);
+    materialPtr->EmissiveColor.Expression = outlinePtr;
+    // Compiles the material's shaders
+    materialPtr->PostEditChange();
+    return materialPtr;
+}
+
+int32 sfLockRenderer::GetStencil(sfUser::SPtr userPtr, UWorld* worldPtr)
+{
+    int32 stencil = INDIRECT_LOCK_STENCIL;
+    if (userPtr != nullptr)
+    {
+        int32* stencilPtr = m_stencils.Find(userPtr->Id());
+        if (stencilPtr != nullptr)
+        {
+            stencil = *stencilPtr;
+        }
+        else if (m_freeStencils.Num() > 0)
+        {
+            stencil = m_freeStencils.Pop(false);
+            m_stencils.Add(userPtr->Id(), stencil);
+        }
+        else
+        {
+            // Users beyond the number of stencil values share the indirect lock outline
+            userPtr = nullptr;
+        }
+    }
+    if (!m_outlineMaterials.Contains(stencil))
+    {
+        CreateOutlineMaterial(stencil, userPtr, worldPtr);
+    }
+    else
+    {
+        // Spawns a volume with the outline materials if the world changed
+        GetVolume(worldPtr);
+    }
+    return stencil;
+}
+
+void sfLockRenderer::CreateOutlineMaterial(int32 stencil, sfUser::SPtr userPtr, UWorld* worldPtr)
+{
+    // Get the volume before adding the material so a new volume doesn't get the material twice
+    APostProcessVolume* volumePtr = GetVolume(worldPtr);
+    UMaterialInstanceDynamic* materialPtr = UMaterialInstanceDynamic::Create(m_outlineMaterialPtr, nullptr);
+    materialPtr->SetFlags(EObjectFlags::RF_Standalone);//prevent material from being destroyed
+    materialPtr->SetScalarParameterValue("Stencil", (float)stencil);
+    if (userPtr != nullptr)
+    {
+        SetColor(materialPtr, userPtr);
+    }
+    m_outlineMaterials.Add(stencil, materialPtr);
+    volumePtr->Settings.WeightedBlendables.Array.Add(FWeightedBlendable(1.0f, materialPtr));
+}
+
+APostProcessVolume* sfLockRenderer::GetVolume(UWorld* worldPtr)
+{
+    if (m_volumePtr.IsValid() && m_volumePtr->GetWorld() == worldPtr)
+    {
+        return m_volumePtr.Get();
+    }
+    if (m_volumePtr.IsValid())
+    {
+        m_volumePtr->GetWorld()->DestroyActor(m_volumePtr.Get());
+    }
+    // Transient actors are not saved or synced
+    FActorSpawnParameters spawnParams;
+    spawnParams.ObjectFlags = RF_Transient;
+    spawnParams.bHideFromSceneOutliner = true;
+    APostProcessVolume* volumePtr = worldPtr->SpawnActor<APostProcessVolume>(spawnParams);
+    volumePtr->bUnbound = true;
+    for (auto iter : m_outlineMaterials)
+    {
+        volumePtr->Settings.WeightedBlendables.Array.Add(FWeightedBlendable(1.0f, iter.Value));
+    }
+    m_volumePtr = volumePtr;
+    return volumePtr;
+}
+
+void sfLockRenderer::SetColor(UMaterialInstanceDynamic* materialPtr, sfUser::SPtr userPtr)
+{
+    ksColor color = userPtr->Color();
+    FLinearColor ucolor(color.R(), color.G(), color.B());
+    materialPtr->SetVectorParameterValue("Color", ucolor);
+}
+
+void sfLockRenderer::OnPreSaveWorld(uint32 saveFlags, UWorld* worldPtr)
+{
+    for (const TWeakObjectPtr<UsfLockComponent>& lockPtr : m_outlineLocks)
+    {
+        if (lockPtr.IsValid())
+        {
+            lockPtr->RestoreOutlines();
+        }
+    }
+}
+
+void sfLockRenderer::OnPostSaveWorld(uint32 saveFlags, UWorld* worldPtr, bool success)
+{
+    for (const TWeakObjectPtr<UsfLockComponent>& lockPtr : m_outlineLocks)
+    {
+        if (lockPtr.IsValid())
+        {
+            lockPtr->Outline(lockPtr->GetOutlineStencil());
+        }
+    }
+}
+
+#undef INDIRECT_LOCK_STENCIL
+#undef CUSTOM_DEPTH_WITH_STENCIL
+#undef OUTLINE_WIDTH
+#undef LOG_CHANNEL
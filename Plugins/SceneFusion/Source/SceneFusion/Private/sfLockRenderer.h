@@ -0,0 +1,188 @@
+#pragma once
+
+#include <CoreMinimal.h>
+#include <GameFramework/Actor.h>
+#include <Engine/PostProcessVolume.h>
+#include <Materials/Material.h>
+#include <Materials/MaterialInstanceDynamic.h>
+#include <sfUser.h>
+
+#include "Components/sfLockComponent.h"
+
+using namespace KS::SceneFusion2;
+
+/**
+ * Shows which actors are locked by other users. Locks are drawn by duplicating the actor's meshes with a lock material
+ * in the lock owner's color, or by outlining the actor. Outlines render the actor's primitive components to custom
+ * depth with a stencil value for the lock owner, and one post-process outline material per stencil value draws the
+ * outline in the owner's color, so locking adds no components or base pass draws. The outline material is built in
+ * code when outlines are first used, so it does not need an asset.
+ */
+class sfLockRenderer
+{
+public:
+    /**
+     * Ways of drawing locks.
+     */
+    enum Mode
+    {
+        DuplicateMeshes,
+        Outlines
+    };
+
+    /**
+     * Constructor. Loads the lock materials.
+     */
+    sfLockRenderer();
+
+    /**
+     * Destructor
+     */
+    ~sfLockRenderer();
+
+    /**
+     * Initialization. Builds the outline material if outlines are requested.
+     *
+     * @param   Mode mode to draw locks with.
+     */
+    void Initialize(Mode mode);
+
+    /**
+     * Deinitialization. Removes the outline volume and releases the lock materials. Actors should be unlocked first.
+     */
+    void CleanUp();
+
+    /**
+     * @return  Mode locks are drawn with.
+     */
+    Mode GetMode() const;
+
+    /**
+     * Adds lock components to an actor.
+     *
+     * @param   AActor* actorPtr to lock.
+     * @param   sfUser::SPtr lockOwnerPtr. nullptr if the actor is indirectly locked by a descendant.
+     */
+    void Lock(AActor* actorPtr, sfUser::SPtr lockOwnerPtr);
+
+    /**
+     * Removes lock components from an actor.
+     *
+     * @param   AActor* actorPtr to unlock.
+     */
+    void Unlock(AActor* actorPtr);
+
+    /**
+     * Changes the color of an actor's lock to a new lock owner's color.
+     *
+     * @param   AActor* actorPtr
+     * @param   sfUser::SPtr lockOwnerPtr. nullptr if the actor is indirectly locked by a descendant.
+     */
+    void SetLockOwner(AActor* actorPtr, sfUser::SPtr lockOwnerPtr);
+
+    /**
+     * Updates the lock material color for a user.
+     *
+     * @param   sfUser::SPtr userPtr whose color changed.
+     */
+    void OnUserColorChange(sfUser::SPtr userPtr);
+
+    /**
+     * Releases the lock materials for a user.
+     *
+     * @param   sfUser::SPtr userPtr who left.
+     */
+    void OnUserLeave(sfUser::SPtr userPtr);
+
+    /**
+     * @return  int - number of post-process outline materials drawn.
+     */
+    int NumOutlineMaterials() const;
+
+private:
+    Mode m_mode;
+    UMaterialInterface* m_lockMaterialPtr;
+    UMaterialInterface* m_outlineMaterialPtr;
+    // Lock materials for duplicated meshes by user id
+    TMap<uint32_t, UMaterialInstanceDynamic*> m_lockMaterials;
+    // Outline materials by stencil value
+    TMap<int32, UMaterialInstanceDynamic*> m_outlineMaterials;
+    // Stencil values by user id
+    TMap<uint32_t, int32> m_stencils;
+    TArray<int32> m_freeStencils;
+    TWeakObjectPtr<APostProcessVolume> m_volumePtr;
+    // Lock components that outline actors. Outlines are removed while saving so custom depth settings aren't saved.
+    TSet<TWeakObjectPtr<UsfLockComponent>> m_outlineLocks;
+    int32 m_previousCustomDepthMode;
+    FDelegateHandle m_onPreSaveWorldHandle;
+    FDelegateHandle m_onPostSaveWorldHandle;
+
+    /**
+     * Gets the lock material for a user. Creates the material if it does not already exist.
+     *
+     * @param   sfUser::SPtr userPtr to get lock material for. May be nullptr.
+     * @return  UMaterialInterface* lock material for the user.
+     */
+    UMaterialInterface* GetLockMaterial(sfUser::SPtr userPtr);
+
+    /**
+     * Builds the post-process material that outlines pixels next to pixels with its Stencil parameter's custom
+     * stencil value in its Color parameter.
+     *
+     * @return  UMaterial*
+     */
+    static UMaterial* CreateOutlineBaseMaterial();
+
+    /**
+     * Gets the stencil value for a user. Allocates a value and creates an outline material for it if the user does
+     * not have one.
+     *
+     * @param   sfUser::SPtr userPtr to get stencil value for. May be nullptr.
+     * @param   UWorld* worldPtr the outline is drawn in.
+     * @return  int32 stencil value for the user.
+     */
+    int32 GetStencil(sfUser::SPtr userPtr, UWorld* worldPtr);
+
+    /**
+     * Creates an outline material for a stencil value and adds it to the outline volume.
+     *
+     * @param   int32 stencil value.
+     * @param   sfUser::SPtr userPtr whose color to use. If nullptr, uses the material's default color.
+     * @param   UWorld* worldPtr to draw the outline in.
+     */
+    void CreateOutlineMaterial(int32 stencil, sfUser::SPtr userPtr, UWorld* worldPtr);
+
+    /**
+     * Gets the unbound post-process volume that draws outline materials, spawning it with all the outline materials if
+     * the world does not have one.
+     *
+     * @param   UWorld* worldPtr
+     * @return  APostProcessVolume*
+     */
+    APostProcessVolume* GetVolume(UWorld* worldPtr);
+
+    /**
+     * Sets the color parameter of a material to a user's color.
+     *
+     * @param   UMaterialInstanceDynamic* materialPtr
+     * @param   sfUser::SPtr userPtr
+     */
+    static void SetColor(UMaterialInstanceDynamic* materialPtr, sfUser::SPtr userPtr);
+
+    /**
+     * Called before a world is saved. Restores the custom depth settings of outlined components.
+     *
+     * @param   uint32 saveFlags
+     * @param   UWorld* worldPtr
+     */
+    void OnPreSaveWorld(uint32 saveFlags, UWorld* worldPtr);
+
+    /**
+     * Called after a world is saved. Outlines locked actors again.
+     *
+     * @param   uint32 saveFlags
+     * @param   UWorld* worldPtr
+     * @param   bool success
+     */
+    void OnPostSaveWorld(uint32 saveFlags, UWorld* worldPtr, bool success);
+};
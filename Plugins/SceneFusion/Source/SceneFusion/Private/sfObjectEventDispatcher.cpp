@@ -1,5 +1,7 @@
 #include "sfObjectEventDispatcher.h"
 #include "SceneFusion.h"
+#include "sfConfig.h"
+#include "sfEventGuard.h"
 
 #define LOG_CHANNEL "sfObjectEventDispatcher"
 
@@ -9,7 +11,9 @@ sfObjectEventDispatcher::SPtr sfObjectEventDispatcher::CreateSPtr()
 }
 
 sfObjectEventDispatcher::sfObjectEventDispatcher() :
-    m_active{ false }
+    m_active{ false },
+    m_nextSequence{ 0 },
+    m_statsCommandPtr{ nullptr }
 {
 
 }
@@ -19,9 +23,20 @@ sfObjectEventDispatcher::~sfObjectEventDispatcher()
 
 }
 
-void sfObjectEventDispatcher::Register(const sfName& objectType, TSharedPtr<IObjectManager> managerPtr)
+void sfObjectEventDispatcher::Register(
+    const sfName& objectType,
+    TSharedPtr<IObjectManager> managerPtr,
+    bool queueEvents)
 {
     m_managers[objectType] = managerPtr;
+    if (queueEvents)
+    {
+        m_queuedTypes.insert(objectType);
+    }
+    else
+    {
+        m_queuedTypes.erase(objectType);
+    }
 }
 
 void sfObjectEventDispatcher::Initialize()
@@ -31,62 +46,48 @@ void sfObjectEventDispatcher::Initialize()
         return;
     }
     m_active = true;
+    m_stats = Stats();
+    m_statsCommandPtr = IConsoleManager::Get().RegisterConsoleCommand(
+        TEXT("SFEventStats"),
+        TEXT("Usage: SFEventStats. Logs the number of queued, merged and applied server events and queue depths."),
+        FConsoleCommandDelegate::CreateRaw(this, &sfObjectEventDispatcher::LogStats));
     sfSession::SPtr sessionPtr = SceneFusion::Service->Session();
     m_createEventPtr = sessionPtr->RegisterOnCreateHandler([this](sfObject::SPtr objPtr, int childIndex)
     {
-        TSharedPtr<IObjectManager> managerPtr = GetManager(objPtr);
-        if (managerPtr.IsValid())
-        {
-            managerPtr->OnCreate(objPtr, childIndex);
-        }
+        Event ev{ Create, objPtr };
+        ev.Index = childIndex;
+        Dispatch(ev);
     });
     m_deleteEventPtr = sessionPtr->RegisterOnDeleteHandler([this](sfObject::SPtr objPtr)
     {
-        TSharedPtr<IObjectManager> managerPtr = GetManager(objPtr);
-        if (managerPtr.IsValid())
-        {
-            managerPtr->OnDelete(objPtr);
-        }
+        Event ev{ Delete, objPtr };
+        Dispatch(ev);
     });
     m_lockEventPtr = sessionPtr->RegisterOnLockHandler([this](sfObject::SPtr objPtr)
     {
-        TSharedPtr<IObjectManager> managerPtr = GetManager(objPtr);
-        if (managerPtr.IsValid())
-        {
-            managerPtr->OnLock(objPtr);
-        }
+        Event ev{ Lock, objPtr };
+        Dispatch(ev);
     });
     m_unlockEventPtr = sessionPtr->RegisterOnUnlockHandler([this](sfObject::SPtr objPtr)
     {
-        TSharedPtr<IObjectManager> managerPtr = GetManager(objPtr);
-        if (managerPtr.IsValid())
-        {
-            managerPtr->OnUnlock(objPtr);
-        }
+        Event ev{ Unlock, objPtr };
+        Dispatch(ev);
     });
     m_lockOwnerChangeEventPtr = sessionPtr->RegisterOnLockOwnerChangeHandler([this](sfObject::SPtr objPtr)
     {
-        TSharedPtr<IObjectManager> managerPtr = GetManager(objPtr);
-        if (managerPtr.IsValid())
-        {
-            managerPtr->OnLockOwnerChange(objPtr);
-        }
+        Event ev{ LockOwnerChange, objPtr };
+        Dispatch(ev);
     });
     m_directLockChangeEventPtr = sessionPtr->RegisterOnDirectLockChangeHandler([this](sfObject::SPtr objPtr)
     {
-        TSharedPtr<IObjectManager> managerPtr = GetManager(objPtr);
-        if (managerPtr.IsValid())
-        {
-            managerPtr->OnDirectLockChange(objPtr);
-        }
+        Event ev{ DirectLockChange, objPtr };
+        Dispatch(ev);
     });
     m_parentChangeEventPtr = sessionPtr->RegisterOnParentChangeHandler([this](sfObject::SPtr objPtr, int childIndex)
     {
-        TSharedPtr<IObjectManager> managerPtr = GetManager(objPtr);
-        if (managerPtr.IsValid())
-        {
-            managerPtr->OnParentChange(objPtr, childIndex);
-        }
+        Event ev{ ParentChange, objPtr };
+        ev.Index = childIndex;
+        Dispatch(ev);
     });
     m_propertyChangeEventPtr = sessionPtr->RegisterOnPropertyChangeHandler(
         [this](sfProperty::SPtr propertyPtr)
@@ -96,38 +97,35 @@ void sfObjectEventDispatcher::Initialize()
             KS::Log::Error("Container object is null. Property path: " + propertyPtr->GetPath(), LOG_CHANNEL);
             return;
         }
-        TSharedPtr<IObjectManager> managerPtr = GetManager(propertyPtr->GetContainerObject());
-        if (managerPtr.IsValid())
-        {
-            managerPtr->OnPropertyChange(propertyPtr);
-        }
+        Event ev{ PropertyChange, propertyPtr->GetContainerObject() };
+        ev.PropertyPtr = propertyPtr;
+        Dispatch(ev);
     });
     m_removeFieldEventPtr = sessionPtr->RegisterOnDictionaryRemoveHandler(
         [this](sfDictionaryProperty::SPtr dictPtr, sfName name)
     {
-        TSharedPtr<IObjectManager> managerPtr = GetManager(dictPtr->GetContainerObject());
-        if (managerPtr.IsValid())
-        {
-            managerPtr->OnRemoveField(dictPtr, name);
-        }
+        Event ev{ RemoveField, dictPtr->GetContainerObject() };
+        ev.PropertyPtr = dictPtr;
+        ev.Name = name;
+        Dispatch(ev);
     });
     m_listAddEventPtr = sessionPtr->RegisterOnListAddHandler(
         [this](sfListProperty::SPtr listPtr, int index, int count)
     {
-        TSharedPtr<IObjectManager> managerPtr = GetManager(listPtr->GetContainerObject());
-        if (managerPtr.IsValid())
-        {
-            managerPtr->OnListAdd(listPtr, index, count);
-        }
+        Event ev{ ListAdd, listPtr->GetContainerObject() };
+        ev.PropertyPtr = listPtr;
+        ev.Index = index;
+        ev.Count = count;
+        Dispatch(ev);
     });
     m_listRemoveEventPtr = sessionPtr->RegisterOnListRemoveHandler(
         [this](sfListProperty::SPtr listPtr, int index, int count)
     {
-        TSharedPtr<IObjectManager> managerPtr = GetManager(listPtr->GetContainerObject());
-        if (managerPtr.IsValid())
-        {
-            managerPtr->OnListRemove(listPtr, index, count);
-        }
+        Event ev{ ListRemove, listPtr->GetContainerObject() };
+        ev.PropertyPtr = listPtr;
+        ev.Index = index;
+        ev.Count = count;
+        Dispatch(ev);
     });
 
     for (auto iter : m_managers)
@@ -143,6 +141,12 @@ void sfObjectEventDispatcher::CleanUp()
         return;
     }
     m_active = false;
+    m_events.clear();
+    m_propertyEvents.clear();
+    m_listEvents.clear();
+    m_structureEvents.clear();
+    IConsoleManager::Get().UnregisterConsoleObject(m_statsCommandPtr);
+    m_statsCommandPtr = nullptr;
     sfSession::SPtr sessionPtr = SceneFusion::Service->Session();
     sessionPtr->UnregisterOnCreateHandler(m_createEventPtr);
     sessionPtr->UnregisterOnDeleteHandler(m_deleteEventPtr);
@@ -162,6 +166,31 @@ void sfObjectEventDispatcher::CleanUp()
     }
 }
 
+void sfObjectEventDispatcher::ApplyEvents()
+{
+    if (!m_active || m_events.empty())
+    {
+        return;
+    }
+    double startTime = FPlatformTime::Seconds();
+    double endTime = startTime + sfConfig::Get().EventTimeBudget / 1000.0;
+    do
+    {
+        ApplyNextEvent();
+    } while (m_active && !m_events.empty() && FPlatformTime::Seconds() < endTime);
+
+    m_stats.MaxApplyTime = FMath::Max(m_stats.MaxApplyTime, FPlatformTime::Seconds() - startTime);
+    if (!m_events.empty())
+    {
+        m_stats.DeferredTicks++;
+    }
+}
+
+int sfObjectEventDispatcher::NumQueuedEvents()
+{
+    return (int)m_events.size();
+}
+
 TSharedPtr<IObjectManager> sfObjectEventDispatcher::GetManager(sfObject::SPtr objPtr)
 {
     auto iter = m_managers.find(objPtr->Type());
@@ -173,4 +202,209 @@ TSharedPtr<IObjectManager> sfObjectEventDispatcher::GetManager(sfObject::SPtr ob
     return iter->second;
 }
 
+void sfObjectEventDispatcher::Dispatch(Event& ev)
+{
+    TSharedPtr<IObjectManager> managerPtr = GetManager(ev.ObjPtr);
+    if (!managerPtr.IsValid())
+    {
+        return;
+    }
+    ev.ManagerPtr = managerPtr.Get();
+    if (m_queuedTypes.find(ev.ObjPtr->Type()) != m_queuedTypes.end())
+    {
+        Enqueue(ev);
+        return;
+    }
+    if (ev.Type == Delete)
+    {
+        Flush();
+    }
+    m_stats.Immediate++;
+    Apply(ev);
+}
+
+void sfObjectEventDispatcher::Enqueue(Event& ev)
+{
+    if (ev.Type == PropertyChange || ev.Type == ListAdd || ev.Type == ListRemove)
+    {
+        // A waiting list event's indexes are only valid until the list changes again. A list event queued after
+        // another change to the list would be applied to a value that already includes it, so it becomes a change to
+        // the whole list too. Removed fields are applied by name so they can be queued as they are.
+        if ((ConvertListEvent(ev.PropertyPtr.get()) ||
+            m_propertyEvents.find(ev.PropertyPtr.get()) != m_propertyEvents.end()) && ev.Type != PropertyChange)
+        {
+            ev.Type = PropertyChange;
+            m_stats.ListChanges++;
+        }
+    }
+    if (ev.Type == PropertyChange)
+    {
+        auto iter = m_propertyEvents.find(ev.PropertyPtr.get());
+        if (iter != m_propertyEvents.end())
+        {
+            auto structureIter = m_structureEvents.find(ev.ObjPtr.get());
+            if (structureIter == m_structureEvents.end() || structureIter->second < iter->second)
+            {
+                m_stats.Merged++;
+                return;
+            }
+        }
+    }
+
+    ev.Sequence = m_nextSequence++;
+    if (ev.Type == PropertyChange)
+    {
+        m_propertyEvents[ev.PropertyPtr.get()] = ev.Sequence;
+    }
+    else if (ev.Type == ListAdd || ev.Type == ListRemove)
+    {
+        m_listEvents[ev.PropertyPtr.get()] = ev.Sequence;
+    }
+    else if (ev.Type == Create || ev.Type == Delete || ev.Type == ParentChange)
+    {
+        m_structureEvents[ev.ObjPtr.get()] = ev.Sequence;
+    }
+    m_events.push_back(std::move(ev));
+    m_stats.Queued++;
+    m_stats.PeakDepth = FMath::Max(m_stats.PeakDepth, (int)m_events.size());
+}
+
+bool sfObjectEventDispatcher::ConvertListEvent(sfProperty* listPtr)
+{
+    auto iter = m_listEvents.find(listPtr);
+    if (iter == m_listEvents.end())
+    {
+        return false;
+    }
+    // Events are only removed from the front of the queue, so queued sequences are contiguous.
+    Event& ev = m_events[iter->second - m_events.front().Sequence];
+    ev.Type = PropertyChange;
+    m_propertyEvents[listPtr] = ev.Sequence;
+    m_listEvents.erase(iter);
+    m_stats.ListChanges++;
+    return true;
+}
+
+void sfObjectEventDispatcher::ApplyNextEvent()
+{
+    Event ev = std::move(m_events.front());
+    m_events.pop_front();
+    if (ev.Type == PropertyChange)
+    {
+        auto iter = m_propertyEvents.find(ev.PropertyPtr.get());
+        if (iter != m_propertyEvents.end() && iter->second == ev.Sequence)
+        {
+            m_propertyEvents.erase(iter);
+        }
+    }
+    else if (ev.Type == ListAdd || ev.Type == ListRemove)
+    {
+        auto iter = m_listEvents.find(ev.PropertyPtr.get());
+        if (iter != m_listEvents.end() && iter->second == ev.Sequence)
+        {
+            m_listEvents.erase(iter);
+        }
+    }
+    if (m_events.empty())
+    {
+        m_structureEvents.clear();
+    }
+    m_stats.Applied++;
+    Apply(ev);
+}
+
+void sfObjectEventDispatcher::Flush()
+{
+    while (m_active && !m_events.empty())
+    {
+        ApplyNextEvent();
+    }
+}
+
+void sfObjectEventDispatcher::Apply(const Event& ev)
+{
+    switch (ev.Type)
+    {
+        case Create:
+        {
+            ev.ManagerPtr->OnCreate(ev.ObjPtr, ev.Index);
+            break;
+        }
+        case Delete:
+        {
+            ev.ManagerPtr->OnDelete(ev.ObjPtr);
+            break;
+        }
+        case Lock:
+        {
+            ev.ManagerPtr->OnLock(ev.ObjPtr);
+            break;
+        }
+        case Unlock:
+        {
+            ev.ManagerPtr->OnUnlock(ev.ObjPtr);
+            break;
+        }
+        case LockOwnerChange:
+        {
+            ev.ManagerPtr->OnLockOwnerChange(ev.ObjPtr);
+            break;
+        }
+        case DirectLockChange:
+        {
+            ev.ManagerPtr->OnDirectLockChange(ev.ObjPtr);
+            break;
+        }
+        case ParentChange:
+        {
+            ev.ManagerPtr->OnParentChange(ev.ObjPtr, ev.Index);
+            break;
+        }
+        case PropertyChange:
+        {
+            // The property may have been removed while the event was queued.
+            if (ev.PropertyPtr->GetContainerObject() != nullptr)
+            {
+                ev.ManagerPtr->OnPropertyChange(ev.PropertyPtr);
+            }
+            break;
+        }
+        case RemoveField:
+        {
+            ev.ManagerPtr->OnRemoveField(ev.PropertyPtr->AsDict(), ev.Name);
+            break;
+        }
+        case ListAdd:
+        {
+            if (ev.PropertyPtr->GetContainerObject() != nullptr)
+            {
+                ev.ManagerPtr->OnListAdd(ev.PropertyPtr->AsList(), ev.Index, ev.Count);
+            }
+            break;
+        }
+        case ListRemove:
+        {
+            if (ev.PropertyPtr->GetContainerObject() != nullptr)
+            {
+                ev.ManagerPtr->OnListRemove(ev.PropertyPtr->AsList(), ev.Index, ev.Count);
+            }
+            break;
+        }
+    }
+}
+
+void sfObjectEventDispatcher::LogStats()
+{
+    KS::Log::Info("Server events: " + std::to_string(m_stats.Queued) + " queued, " +
+        std::to_string(m_stats.Merged) + " merged, " + std::to_string(m_stats.Immediate) + " applied immediately, " +
+        std::to_string(m_stats.Applied) + " applied from the queue, " + std::to_string(m_stats.ListChanges) +
+         list changes applied as whole lists.", LOG_CHANNEL);
+    KS::Log::Info("Queue depth: " + std::to_string(m_events.size()) + " now, " +
+        std::to_string(m_stats.PeakDepth) + " peak. " + std::to_string(m_stats.DeferredTicks) +
+        " ticks ended with queued events. Longest apply: " + std::to_string(m_stats.MaxApplyTime * 1000.0) + " ms.",
+        LOG_CHANNEL);
+    // Each event guard scope replaces removing and re-adding a delegate handler
+    KS::Log::Info("Delegate rebinds avoided: " + std::to_string(sfEventGuard::NumScopes()) + ".", LOG_CHANNEL);
+}
+
 #undef LOG_CHANNEL
\ No newline at end of file
@@ -2,14 +2,24 @@
 
 #include "ObjectManagers/IObjectManager.h"
 
+#include <CoreMinimal.h>
+#include <HAL/IConsoleManager.h>
 #include <sfObject.h>
+#include <deque>
 #include <unordered_map>
+#include <unordered_set>
 
 using namespace KS;
 
 /**
  * The object event dispatcher listens for object events and calls the corresponding functions on the object manager
- * registered for the object's type.
+ * registered for the object's type. Events for types registered as queued are staged and applied in ApplyEvents
+ * within the per-tick time budget from the config. Queued property changes to a property that already has a change
+ * waiting are merged into the waiting change, since handlers read the current property value when they are applied.
+ * List insertions and removals are queued as they are, but their indexes are only valid until the list changes again,
+ * so when another change to the same list is queued while one is waiting, the waiting list event becomes a change to
+ * the whole list and the new change is merged into it. Events for types that aren't queued are applied immediately.
+ * Deletes of those objects apply all waiting events first, since they can delete objects that have waiting events.
  */
 class sfObjectEventDispatcher
 {
@@ -38,8 +48,9 @@ public:
      *
      * @param   const sfName& objectType the manager should handle events for.
      * @param   TSharedPtr<IObjectManager> managerPtr to register.
+     * @param   bool queueEvents - if true, events for the type are queued and applied in ApplyEvents.
      */
-    void Register(const sfName& objectType, TSharedPtr<IObjectManager> managerPtr);
+    void Register(const sfName& objectType, TSharedPtr<IObjectManager> managerPtr, bool queueEvents = false);
 
     /**
      * Starts listening for events and calls Initialize on all registered managers.
@@ -47,13 +58,90 @@ public:
     void Initialize();
 
     /**
-     * Stops listening for events and calls CleanUp on all registered managers.
+     * Stops listening for events, discards queued events, and calls CleanUp on all registered managers.
      */
     void CleanUp();
 
+    /**
+     * Applies queued events until the event time budget from the config is used up. At least one event is applied.
+     */
+    void ApplyEvents();
+
+    /**
+     * @return  int - number of events waiting to be applied.
+     */
+    int NumQueuedEvents();
+
 private:
+    /**
+     * Types of object event.
+     */
+    enum EventType
+    {
+        Create,
+        Delete,
+        Lock,
+        Unlock,
+        LockOwnerChange,
+        DirectLockChange,
+        ParentChange,
+        PropertyChange,
+        RemoveField,
+        ListAdd,
+        ListRemove
+    };
+
+    /**
+     * An object event and its arguments.
+     */
+    struct Event
+    {
+    public:
+        EventType Type;
+        // Object the event is for, or the container object of the property for property events
+        sfObject::SPtr ObjPtr;
+        IObjectManager* ManagerPtr = nullptr;
+        sfProperty::SPtr PropertyPtr;
+        sfName Name;
+        // Child index for create and parent change events, or element index for list events
+        int Index = 0;
+        int Count = 0;
+        // Position of the event in the order events were queued
+        uint64 Sequence = 0;
+    };
+
+    /**
+     * Event counts and queue depths.
+     */
+    struct Stats
+    {
+    public:
+        int64 Queued = 0;
+        int64 Merged = 0;
+        int64 Immediate = 0;
+        int64 Applied = 0;
+        // Number of list insertions and removals turned into changes to the whole list
+        int64 ListChanges = 0;
+        int PeakDepth = 0;
+        // Number of ticks that ended with events left in the queue
+        int64 DeferredTicks = 0;
+        double MaxApplyTime = 0.0;
+    };
+
     bool m_active;
     std::unordered_map<sfName, TSharedPtr<IObjectManager>> m_managers;
+    std::unordered_set<sfName> m_queuedTypes;
+    std::deque<Event> m_events;
+    uint64 m_nextSequence;
+    // Sequence of the queued change for each property with a queued change
+    std::unordered_map<sfProperty*, uint64> m_propertyEvents;
+    // Sequence of the queued insertion or removal for each list with one
+    std::unordered_map<sfProperty*, uint64> m_listEvents;
+    // Sequence of the last queued create, delete or parent change for each object. Property changes queued before
+    // it can't be merged with later changes.
+    std::unordered_map<sfObject*, uint64> m_structureEvents;
+    Stats m_stats;
+    IConsoleCommand* m_statsCommandPtr;
     ksEvent<sfObject::SPtr&, int&>::SPtr m_createEventPtr;
     ksEvent<sfObject::SPtr&>::SPtr m_deleteEventPtr;
     ksEvent<sfObject::SPtr&>::SPtr m_lockEventPtr;
@@ -73,4 +161,50 @@ private:
      * @return  sfObject::SPtr manager for the object, or nullptr if there is no manager for the object's type.
      */
     TSharedPtr<IObjectManager> GetManager(sfObject::SPtr objPtr);
-};
\ No newline at end of file
+
+    /**
+     * Queues an event if its object type is queued. Otherwise applies the event immediately, after applying queued
+     * events if the event is a delete.
+     *
+     * @param   Event& ev to dispatch. Its object must be set.
+     */
+    void Dispatch(Event& ev);
+
+    /**
+     * Adds an event to the queue, or merges it with a queued change to the same property.
+     *
+     * @param   Event& ev to queue.
+     */
+    void Enqueue(Event& ev);
+
+    /**
+     * If a list has a queued insertion or removal, turns it into a change to the whole list so another change to the
+     * list can be queued or merged after it.
+     *
+     * @param   sfProperty* listPtr to convert the queued list event for.
+     * @return  bool true if the list had a queued list event.
+     */
+    bool ConvertListEvent(sfProperty* listPtr);
+
+    /**
+     * Removes and applies the first queued event.
+     */
+    void ApplyNextEvent();
+
+    /**
+     * Applies all queued events.
+     */
+    void Flush();
+
+    /**
+     * Calls the manager function for an event.
+     *
+     * @param   const Event& ev to apply.
+     */
+    void Apply(const Event& ev);
+
+    /**
+     * Logs event counts and queue depths.
+     */
+    void LogStats();
+};
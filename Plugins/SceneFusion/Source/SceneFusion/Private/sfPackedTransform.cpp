@@ -0,0 +1,342 @@
+#include "sfPackedTransform.h"
+#include "sfConfig.h"
+
+#include <Log.h>
+#include <cmath>
+
+// Header byte layout
+#define POSITION_BITS_MASK 0x0F
+#define HAS_SCALE_FLAG 0x10
+#define IS_ROTATOR_FLAG 0x20
+// Rotator angles have this many fewer fractional bits than the rotation bits, so a half turn takes about as many bits
+// as a quaternion component.
+#define ROTATOR_INTEGER_BITS 8
+// Scale is encoded with a fixed precision
+#define SCALE_FRACTION_BITS 16
+#define MIN_ROTATION_BITS 6
+#define MAX_ROTATION_BITS 20
+// Largest fixed-point value. Larger values are clamped.
+#define MAX_FIXED_VALUE (1LL << 62)
+#define SQRT_2 1.4142135623730951
+#define LOG_CHANNEL "sfPackedTransform"
+
+sfPackedTransform::Stats sfPackedTransform::m_packedStats;
+sfPackedTransform::Stats sfPackedTransform::m_unpackedStats;
+IConsoleCommand* sfPackedTransform::m_statsCommandPtr = nullptr;
+
+void sfPackedTransform::Initialize()
+{
+    m_statsCommandPtr = IConsoleManager::Get().RegisterConsoleCommand(
+        TEXT("SFTransformStats"),
+        TEXT("Usage: SFTransformStats. Logs the number and average size of packed and unpacked transform updates."),
+        FConsoleCommandDelegate::CreateStatic(&sfPackedTransform::LogStats));
+}
+
+void sfPackedTransform::CleanUp()
+{
+    IConsoleManager::Get().UnregisterConsoleObject(m_statsCommandPtr);
+    m_statsCommandPtr = nullptr;
+}
+
+sfValueProperty::SPtr sfPackedTransform::Encode(const FVector& location, const FQuat& rotation, const FVector& scale)
+{
+    return EncodeTransform(location, &rotation, FRotator::ZeroRotator, scale);
+}
+
+sfValueProperty::SPtr sfPackedTransform::Encode(
+    const FVector& location,
+    const FRotator& rotation,
+    const FVector& scale)
+{
+    return EncodeTransform(location, nullptr, rotation, scale);
+}
+
+sfValueProperty::SPtr sfPackedTransform::EncodeTransform(
+    const FVector& location,
+    const FQuat* quatPtr,
+    const FRotator& rotator,
+    const FVector& scale)
+{
+    int positionBits = FMath::Clamp(sfConfig::Get().TransformPositionBits, 0, (int)POSITION_BITS_MASK);
+    int rotationBits = FMath::Clamp(sfConfig::Get().TransformRotationBits, MIN_ROTATION_BITS, MAX_ROTATION_BITS);
+    bool hasScale = scale != FVector::OneVector;
+
+    std::vector<uint8_t> data;
+    data.reserve(32);
+    data.push_back((uint8_t)(positionBits | (hasScale ? HAS_SCALE_FLAG : 0) |
+        (quatPtr == nullptr ? IS_ROTATOR_FLAG : 0)));
+    data.push_back((uint8_t)rotationBits);
+
+    WriteVarInt(data, ToFixed(location.X, positionBits));
+    WriteVarInt(data, ToFixed(location.Y, positionBits));
+    WriteVarInt(data, ToFixed(location.Z, positionBits));
+
+    if (quatPtr == nullptr)
+    {
+        int angleBits = FMath::Max(0, rotationBits - ROTATOR_INTEGER_BITS);
+        WriteVarInt(data, ToFixed(rotator.Pitch, angleBits));
+        WriteVarInt(data, ToFixed(rotator.Yaw, angleBits));
+        WriteVarInt(data, ToFixed(rotator.Roll, angleBits));
+    }
+    else
+    {
+        EncodeQuat(data, *quatPtr, rotationBits);
+    }
+
+    if (hasScale)
+    {
+        WriteVarInt(data, ToFixed(scale.X, SCALE_FRACTION_BITS));
+        WriteVarInt(data, ToFixed(scale.Y, SCALE_FRACTION_BITS));
+        WriteVarInt(data, ToFixed(scale.Z, SCALE_FRACTION_BITS));
+    }
+    return sfValueProperty::Create(ksMultiType(std::move(data)));
+}
+
+void sfPackedTransform::EncodeQuat(std::vector<uint8_t>& data, const FQuat& rotation, int rotationBits)
+{
+    // Smallest three: store the index of the largest component and the other three components, which are in the
+    // range [-1/sqrt(2), 1/sqrt(2)]. The largest component is made positive since q and -q are the same rotation.
+    double components[4] = { rotation.X, rotation.Y, rotation.Z, rotation.W };
+    double length = std::sqrt(components[0] * components[0] + components[1] * components[1] +
+        components[2] * components[2] + components[3] * components[3]);
+    int largest = 0;
+    for (int i = 0; i < 4; i++)
+    {
+        components[i] = length > 0.0 ? components[i] / length : (i == 3 ? 1.0 : 0.0);
+        if (std::abs(components[i]) > std::abs(components[largest]))
+        {
+            largest = i;
+        }
+    }
+    double sign = components[largest] < 0.0 ? -1.0 : 1.0;
+    uint64 maxValue = (1ULL << rotationBits) - 1;
+    uint64 packed = (uint64)largest;
+    int shift = 2;
+    for (int i = 0; i < 4; i++)
+    {
+        if (i == largest)
+        {
+            continue;
+        }
+        double normalized = (components[i] * sign * SQRT_2 + 1.0) * 0.5;
+        uint64 value = (uint64)std::llround(FMath::Clamp(normalized, 0.0, 1.0) * maxValue);
+        packed |= value << shift;
+        shift += rotationBits;
+    }
+    for (int i = 0; i < shift; i += 8)
+    {
+        data.push_back((uint8_t)(packed >> i));
+    }
+}
+
+bool sfPackedTransform::Decode(sfProperty::SPtr propertyPtr, FVector& location, FQuat& rotation, FVector& scale)
+{
+    FRotator rotator;
+    bool isRotator;
+    if (!DecodeTransform(propertyPtr, location, rotation, rotator, isRotator, scale))
+    {
+        return false;
+    }
+    if (isRotator)
+    {
+        rotation = rotator.Quaternion();
+    }
+    return true;
+}
+
+bool sfPackedTransform::Decode(sfProperty::SPtr propertyPtr, FVector& location, FRotator& rotation, FVector& scale)
+{
+    FQuat quat;
+    bool isRotator;
+    if (!DecodeTransform(propertyPtr, location, quat, rotation, isRotator, scale))
+    {
+        return false;
+    }
+    if (!isRotator)
+    {
+        rotation = quat.Rotator();
+    }
+    return true;
+}
+
+bool sfPackedTransform::DecodeTransform(
+    sfProperty::SPtr propertyPtr,
+    FVector& location,
+    FQuat& quat,
+    FRotator& rotator,
+    bool& isRotator,
+    FVector& scale)
+{
+    if (propertyPtr == nullptr || propertyPtr->Type() != sfProperty::VALUE)
+    {
+        return false;
+    }
+    const std::vector<uint8_t>& data = propertyPtr->AsValue()->GetValue().GetData();
+    if (data.size() < 2)
+    {
+        return false;
+    }
+    int positionBits = data[0] & POSITION_BITS_MASK;
+    bool hasScale = (data[0] & HAS_SCALE_FLAG) != 0;
+    isRotator = (data[0] & IS_ROTATOR_FLAG) != 0;
+    int rotationBits = data[1];
+    if (rotationBits < MIN_ROTATION_BITS || rotationBits > MAX_ROTATION_BITS)
+    {
+        return false;
+    }
+
+    size_t offset = 2;
+    int64 x, y, z;
+    if (!ReadVarInt(data, offset, x) || !ReadVarInt(data, offset, y) || !ReadVarInt(data, offset, z))
+    {
+        return false;
+    }
+    location = FVector(FromFixed(x, positionBits), FromFixed(y, positionBits), FromFixed(z, positionBits));
+
+    if (isRotator)
+    {
+        int angleBits = FMath::Max(0, rotationBits - ROTATOR_INTEGER_BITS);
+        if (!ReadVarInt(data, offset, x) || !ReadVarInt(data, offset, y) || !ReadVarInt(data, offset, z))
+        {
+            return false;
+        }
+        rotator = FRotator(FromFixed(x, angleBits), FromFixed(y, angleBits), FromFixed(z, angleBits));
+    }
+    else if (!DecodeQuat(data, offset, rotationBits, quat))
+    {
+        return false;
+    }
+
+    scale = FVector::OneVector;
+    if (hasScale)
+    {
+        if (!ReadVarInt(data, offset, x) || !ReadVarInt(data, offset, y) || !ReadVarInt(data, offset, z))
+        {
+            return false;
+        }
+        scale = FVector(FromFixed(x, SCALE_FRACTION_BITS), FromFixed(y, SCALE_FRACTION_BITS),
+            FromFixed(z, SCALE_FRACTION_BITS));
+    }
+    return true;
+}
+
+bool sfPackedTransform::DecodeQuat(const std::vector<uint8_t>& data, size_t& offset, int rotationBits, FQuat& rotation)
+{
+    int numBits = 2 + 3 * rotationBits;
+    uint64 packed = 0;
+    for (int i = 0; i < numBits; i += 8)
+    {
+        if (offset >= data.size())
+        {
+            return false;
+        }
+        packed |= (uint64)data[offset++] << i;
+    }
+    int largest = (int)(packed & 3);
+    uint64 maxValue = (1ULL << rotationBits) - 1;
+    double components[4];
+    double sumSquares = 0.0;
+    int shift = 2;
+    for (int i = 0; i < 4; i++)
+    {
+        if (i == largest)
+        {
+            continue;
+        }
+        uint64 value = (packed >> shift) & maxValue;
+        components[i] = ((double)value / maxValue * 2.0 - 1.0) / SQRT_2;
+        sumSquares += components[i] * components[i];
+        shift += rotationBits;
+    }
+    components[largest] = std::sqrt(FMath::Max(0.0, 1.0 - sumSquares));
+    rotation = FQuat((float)components[0], (float)components[1], (float)components[2], (float)components[3]);
+    return true;
+}
+
+bool sfPackedTransform::Equals(sfProperty::SPtr propertyPtr, sfProperty::SPtr otherPtr)
+{
+    if (propertyPtr == nullptr || otherPtr == nullptr ||
+        propertyPtr->Type() != sfProperty::VALUE || otherPtr->Type() != sfProperty::VALUE)
+    {
+        return false;
+    }
+    return propertyPtr->AsValue()->GetValue().GetData() == otherPtr->AsValue()->GetValue().GetData();
+}
+
+void sfPackedTransform::RecordUpdate(bool isPacked, int numProperties, int bytes)
+{
+    Stats& stats = isPacked ? m_packedStats : m_unpackedStats;
+    stats.Updates++;
+    // Each property key is sent as a string table id
+    stats.Bytes += bytes + numProperties * sizeof(uint32_t);
+}
+
+void sfPackedTransform::WriteVarInt(std::vector<uint8_t>& data, int64 value)
+{
+    uint64 zigzag = ((uint64)value << 1) ^ (uint64)(value >> 63);
+    while (zigzag >= 0x80)
+    {
+        data.push_back((uint8_t)(zigzag | 0x80));
+        zigzag >>= 7;
+    }
+    data.push_back((uint8_t)zigzag);
+}
+
+bool sfPackedTransform::ReadVarInt(const std::vector<uint8_t>& data, size_t& offset, int64& value)
+{
+    uint64 zigzag = 0;
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+        if (offset >= data.size())
+        {
+            return false;
+        }
+        uint8_t byte = data[offset++];
+        zigzag |= (uint64)(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0)
+        {
+            value = (int64)(zigzag >> 1) ^ -(int64)(zigzag & 1);
+            return true;
+        }
+    }
+    return false;
+}
+
+int64 sfPackedTransform::ToFixed(float value, int fractionBits)
+{
+    double scaled = (double)value * (double)(1LL << fractionBits);
+    if (std::isnan(scaled))
+    {
+        return 0;
+    }
+    return std::llround(FMath::Clamp(scaled, (double)-MAX_FIXED_VALUE, (double)MAX_FIXED_VALUE));
+}
+
+float sfPackedTransform::FromFixed(int64 value, int fractionBits)
+{
+    return (float)((double)value / (double)(1LL << fractionBits));
+}
+
+void sfPackedTransform::LogStats()
+{
+    const Stats* stats[] = { &m_packedStats, &m_unpackedStats };
+    const char* names[] = { "Packed", "Unpacked" };
+    for (int i = 0; i < 2; i++)
+    {
+        float average = stats[i]->Updates == 0 ? 0.0f : (float)stats[i]->Bytes / stats[i]->Updates;
+        KS::Log::Info(std::string(names[i]) + " transforms: " + std::to_string(stats[i]->Updates) + " updates, " +
+            std::to_string(stats[i]->Bytes) + " bytes, " + std::to_string(average) + " bytes per update.",
+            LOG_CHANNEL);
+    }
+}
+
+#undef POSITION_BITS_MASK
+#undef HAS_SCALE_FLAG
+#undef IS_ROTATOR_FLAG
+#undef ROTATOR_INTEGER_BITS
+#undef SCALE_FRACTION_BITS
+#undef MIN_ROTATION_BITS
+#undef MAX_ROTATION_BITS
+#undef MAX_FIXED_VALUE
+#undef SQRT_2
+#undef LOG_CHANNEL
@@ -0,0 +1,202 @@
+#pragma once
+
+#include <CoreMinimal.h>
+#include <HAL/IConsoleManager.h>
+#include <sfValueProperty.h>
+#include <vector>
+
+using namespace KS::SceneFusion2;
+using namespace KS;
+
+/**
+ * Encodes a location, rotation and scale into a single byte array property. Locations are fixed-point with a
+ * configurable number of fractional bits, and scale is omitted when it is one. Quaternion rotations use the
+ * smallest-three encoding with a configurable number of bits per component. Rotator rotations are stored as fixed-point
+ * angles so rotations past 180 degrees keep their winding, which converting to a quaternion would lose. The precision
+ * is stored in the encoded bytes so clients with different settings decode the same values. Decoding uses only integer
+ * and double math so every client decodes exactly the same floats.
+ */
+class sfPackedTransform
+{
+public:
+    /**
+     * Registers the stats console command.
+     */
+    static void Initialize();
+
+    /**
+     * Unregisters the stats console command.
+     */
+    static void CleanUp();
+
+    /**
+     * Encodes a transform using the precision from the config.
+     *
+     * @param   const FVector& location
+     * @param   const FQuat& rotation
+     * @param   const FVector& scale
+     * @return  sfValueProperty::SPtr
+     */
+    static sfValueProperty::SPtr Encode(const FVector& location, const FQuat& rotation, const FVector& scale);
+
+    /**
+     * Encodes a transform with a rotator rotation using the precision from the config. The rotator's angles are kept
+     * as they are instead of being normalized.
+     *
+     * @param   const FVector& location
+     * @param   const FRotator& rotation
+     * @param   const FVector& scale
+     * @return  sfValueProperty::SPtr
+     */
+    static sfValueProperty::SPtr Encode(const FVector& location, const FRotator& rotation, const FVector& scale);
+
+    /**
+     * Decodes a transform property created by Encode.
+     *
+     * @param   sfProperty::SPtr propertyPtr
+     * @param   FVector& location
+     * @param   FQuat& rotation
+     * @param   FVector& scale
+     * @return  bool false if the property is not a valid packed transform.
+     */
+    static bool Decode(sfProperty::SPtr propertyPtr, FVector& location, FQuat& rotation, FVector& scale);
+
+    /**
+     * Decodes a transform property created by Encode. Rotations encoded as rotators are decoded with their winding.
+     *
+     * @param   sfProperty::SPtr propertyPtr
+     * @param   FVector& location
+     * @param   FRotator& rotation
+     * @param   FVector& scale
+     * @return  bool false if the property is not a valid packed transform.
+     */
+    static bool Decode(sfProperty::SPtr propertyPtr, FVector& location, FRotator& rotation, FVector& scale);
+
+    /**
+     * Checks if two transform properties have the same encoded bytes.
+     *
+     * @param   sfProperty::SPtr propertyPtr
+     * @param   sfProperty::SPtr otherPtr
+     * @return  bool
+     */
+    static bool Equals(sfProperty::SPtr propertyPtr, sfProperty::SPtr otherPtr);
+
+    /**
+     * Records a sent transform update for the stats console command.
+     *
+     * @param   bool isPacked - true if the update used a packed transform property.
+     * @param   int numProperties - number of properties that were set.
+     * @param   int bytes - estimated size of the property values.
+     */
+    static void RecordUpdate(bool isPacked, int numProperties, int bytes);
+
+private:
+    /**
+     * Transform update counts and sizes.
+     */
+    struct Stats
+    {
+    public:
+        int Updates = 0;
+        int64 Bytes = 0;
+    };
+
+    static Stats m_packedStats;
+    static Stats m_unpackedStats;
+    static IConsoleCommand* m_statsCommandPtr;
+
+    /**
+     * Encodes a transform with either a quaternion or a rotator rotation.
+     *
+     * @param   const FVector& location
+     * @param   const FQuat* quatPtr - rotation to encode, or nullptr to encode the rotator.
+     * @param   const FRotator& rotator - rotation to encode if quatPtr is nullptr.
+     * @param   const FVector& scale
+     * @return  sfValueProperty::SPtr
+     */
+    static sfValueProperty::SPtr EncodeTransform(
+        const FVector& location,
+        const FQuat* quatPtr,
+        const FRotator& rotator,
+        const FVector& scale);
+
+    /**
+     * Decodes a transform property created by Encode.
+     *
+     * @param   sfProperty::SPtr propertyPtr
+     * @param   FVector& location
+     * @param   FQuat& quat - set to the rotation if it was encoded as a quaternion.
+     * @param   FRotator& rotator - set to the rotation if it was encoded as a rotator.
+     * @param   bool& isRotator - set to true if the rotation was encoded as a rotator.
+     * @param   FVector& scale
+     * @return  bool false if the property is not a valid packed transform.
+     */
+    static bool DecodeTransform(
+        sfProperty::SPtr propertyPtr,
+        FVector& location,
+        FQuat& quat,
+        FRotator& rotator,
+        bool& isRotator,
+        FVector& scale);
+
+    /**
+     * Writes a quaternion using the smallest-three encoding.
+     *
+     * @param   std::vector<uint8_t>& data to write to.
+     * @param   const FQuat& rotation
+     * @param   int rotationBits - number of bits per component.
+     */
+    static void EncodeQuat(std::vector<uint8_t>& data, const FQuat& rotation, int rotationBits);
+
+    /**
+     * Reads a quaternion written by EncodeQuat.
+     *
+     * @param   const std::vector<uint8_t>& data to read from.
+     * @param   size_t& offset to read from. Advanced past the quaternion.
+     * @param   int rotationBits - number of bits per component.
+     * @param   FQuat& rotation
+     * @return  bool false if there was not enough data.
+     */
+    static bool DecodeQuat(const std::vector<uint8_t>& data, size_t& offset, int rotationBits, FQuat& rotation);
+
+    /**
+     * Writes a signed integer as a zigzag variable-length integer.
+     *
+     * @param   std::vector<uint8_t>& data to write to.
+     * @param   int64 value
+     */
+    static void WriteVarInt(std::vector<uint8_t>& data, int64 value);
+
+    /**
+     * Reads a zigzag variable-length integer.
+     *
+     * @param   const std::vector<uint8_t>& data to read from.
+     * @param   size_t& offset to read from. Advanced past the integer.
+     * @param   int64& value
+     * @return  bool false if there was not enough data.
+     */
+    static bool ReadVarInt(const std::vector<uint8_t>& data, size_t& offset, int64& value);
+
+    /**
+     * Converts a float to a fixed-point integer.
+     *
+     * @param   float value
+     * @param   int fractionBits
+     * @return  int64
+     */
+    static int64 ToFixed(float value, int fractionBits);
+
+    /**
+     * Converts a fixed-point integer to a float.
+     *
+     * @param   int64 value
+     * @param   int fractionBits
+     * @return  float
+     */
+    static float FromFixed(int64 value, int fractionBits);
+
+    /**
+     * Logs update counts and average update sizes for packed and unpacked transforms.
+     */
+    static void LogStats();
+};
@@ -0,0 +1,272 @@
+#include "sfPropertySchema.h"
+
+#include <Log.h>
+#include <Editor.h>
+#include <Runtime/CoreUObject/Public/UObject/UnrealType.h>
+
+#define LOG_CHANNEL "sfPropertySchema"
+
+TMap<const UClass*, TSharedPtr<sfPropertySchema::Schema>> sfPropertySchema::m_schemas;
+sfPropertySchema::Stats sfPropertySchema::m_stats;
+IConsoleCommand* sfPropertySchema::m_statsCommandPtr = nullptr;
+FDelegateHandle sfPropertySchema::m_onBlueprintCompiledHandle;
+FDelegateHandle sfPropertySchema::m_onObjectsReplacedHandle;
+FDelegateHandle sfPropertySchema::m_onPackageReloadedHandle;
+
+sfProperty::SPtr sfPropertySchema::Field::GetValue(UObject* uobjPtr) const
+{
+    return HandlerPtr->Get(sfUPropertyInstance(Property, (uint8*)uobjPtr + Offset));
+}
+
+void sfPropertySchema::Field::SetValue(UObject* uobjPtr, sfProperty::SPtr propPtr) const
+{
+    HandlerPtr->Set(sfUPropertyInstance(Property, (uint8*)uobjPtr + Offset), propPtr);
+}
+
+void sfPropertySchema::Initialize()
+{
+    // Compiling a blueprint changes its class's properties without replacing the class
+    m_onBlueprintCompiledHandle = GEditor->OnBlueprintCompiled().AddLambda([]()
+    {
+        Invalidate();
+    });
+    m_onObjectsReplacedHandle = FCoreUObjectDelegates::OnObjectsReplaced.AddLambda(
+        [](const TMap<UObject*, UObject*>& replacements)
+    {
+        Invalidate();
+    });
+    m_onPackageReloadedHandle = FCoreUObjectDelegates::OnPackageReloaded.AddLambda(
+        [](EPackageReloadPhase phase, FPackageReloadedEvent* eventPtr)
+    {
+        Invalidate();
+    });
+
+    m_statsCommandPtr = IConsoleManager::Get().RegisterConsoleCommand(
+        TEXT("SFPropertySchemaStats"),
+        TEXT("Usage: SFPropertySchemaStats. Logs hit and miss rates and build times for property schemas."),
+        FConsoleCommandDelegate::CreateStatic(&sfPropertySchema::LogStats));
+}
+
+void sfPropertySchema::CleanUp()
+{
+    if (GEditor != nullptr)
+    {
+        GEditor->OnBlueprintCompiled().Remove(m_onBlueprintCompiledHandle);
+    }
+    FCoreUObjectDelegates::OnObjectsReplaced.Remove(m_onObjectsReplacedHandle);
+    FCoreUObjectDelegates::OnPackageReloaded.Remove(m_onPackageReloadedHandle);
+    if (m_statsCommandPtr != nullptr)
+    {
+        IConsoleManager::Get().UnregisterConsoleObject(m_statsCommandPtr);
+        m_statsCommandPtr = nullptr;
+    }
+    m_schemas.Empty();
+    m_stats = Stats();
+}
+
+TSharedPtr<const sfPropertySchema::Schema> sfPropertySchema::Get(UClass* classPtr)
+{
+    return Find(classPtr);
+}
+
+TSharedPtr<const sfPropertySchema::PathAccessor> sfPropertySchema::GetPathAccessor(
+    UClass* classPtr,
+    const PropertyPath& path)
+{
+    TSharedPtr<Schema> schemaPtr = Find(classPtr);
+    PathShape shape;
+    uint64 key = GetPathShape(path, shape);
+    auto iter = schemaPtr->Paths.find(key);
+    if (iter != schemaPtr->Paths.end() && iter->second->Shape == shape)
+    {
+        m_stats.PathHits++;
+        return iter->second;
+    }
+    m_stats.PathMisses++;
+    // Paths that don't match are cached too so changes we can't apply don't search for properties again. If a
+    // different shape has the same hash, its accessor is replaced.
+    TSharedPtr<PathAccessor> accessorPtr = MakeShareable(new PathAccessor);
+    accessorPtr->IsValid = Compile(classPtr, path, *accessorPtr);
+    accessorPtr->Shape = shape;
+    schemaPtr->Paths[key] = accessorPtr;
+    return accessorPtr;
+}
+
+TSharedPtr<sfPropertySchema::Schema> sfPropertySchema::Find(UClass* classPtr)
+{
+    TSharedPtr<Schema>* schemaPtrPtr = m_schemas.Find(classPtr);
+    // A different class can be allocated at the address of a class that was garbage collected
+    if (schemaPtrPtr != nullptr && (*schemaPtrPtr)->Class.Get() == classPtr &&
+        !classPtr->HasAnyClassFlags(CLASS_NewerVersionExists))
+    {
+        m_stats.Hits++;
+        return *schemaPtrPtr;
+    }
+    m_stats.Misses++;
+    double startTime = FPlatformTime::Seconds();
+    TSharedPtr<Schema> schemaPtr = MakeShareable(new Schema);
+    Build(classPtr, *schemaPtr);
+    m_schemas.Add(classPtr, schemaPtr);
+    m_stats.BuildTime += FPlatformTime::Seconds() - startTime;
+    return schemaPtr;
+}
+
+void sfPropertySchema::Build(UClass* classPtr, Schema& schema)
+{
+    if (sfPropertyUtil::m_typeHandlers.size() == 0)
+    {
+        sfPropertyUtil::Initialize();
+    }
+    schema.Class = classPtr;
+    schema.DefaultsPtr = classPtr->GetDefaultObject();
+    for (TFieldIterator<UProperty> iter(classPtr); iter; ++iter)
+    {
+        if (!(iter->PropertyFlags & CPF_Edit) || (iter->PropertyFlags & CPF_DisableEditOnInstance))
+        {
+            continue;
+        }
+        auto handlerIter = sfPropertyUtil::m_typeHandlers.find(iter->GetClass()->GetFName().GetComparisonIndex());
+        if (handlerIter == sfPropertyUtil::m_typeHandlers.end())
+        {
+            continue;
+        }
+        Field field;
+        field.Property = *iter;
+        field.Name = sfName(std::string(TCHAR_TO_UTF8(*iter->GetName())));
+        field.Offset = iter->GetOffset_ForInternal();
+        field.HandlerPtr = &handlerIter->second;
+        schema.Fields.Add(field);
+    }
+}
+
+uint64 sfPropertySchema::GetPathShape(const PropertyPath& path, PathShape& shape)
+{
+    uint64 hash = 0;
+    for (const sfProperty::SPtr& propPtr : path)
+    {
+        uint64 token = 0;
+        sfProperty::SPtr parentPtr = propPtr->GetParentProperty();
+        if (parentPtr->Type() == sfProperty::DICTIONARY)
+        {
+            token = std::hash<sfName>()(propPtr->Key());
+        }
+        // Map elements are lists of a key and value, so a list in a list is a map element and its index chooses the
+        // key or value.
+        else if (parentPtr->GetParentProperty() != nullptr &&
+            parentPtr->GetParentProperty()->Type() == sfProperty::LIST)
+        {
+            token = (uint64)propPtr->Index() + 1;
+        }
+        shape.Add(token);
+        hash ^= token + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+    }
+    return hash;
+}
+
+bool sfPropertySchema::Compile(UClass* classPtr, const PropertyPath& path, PathAccessor& accessor)
+{
+    UProperty* upropPtr = nullptr;
+    for (int i = 0; i < path.Num(); i++)
+    {
+        sfProperty::SPtr propPtr = path[i];
+        PathStep step;
+        step.Offset = 0;
+        if (upropPtr == nullptr)
+        {
+            // Get the first property from the class
+            step.StepType = PathStep::StructField;
+            step.Property = classPtr->FindPropertyByName(FName(UTF8_TO_TCHAR(propPtr->Key()->c_str())));
+            if (step.Property == nullptr)
+            {
+                return false;
+            }
+            step.Offset = step.Property->GetOffset_ForInternal();
+            upropPtr = step.Property;
+        }
+        else if (UStructProperty* structPropPtr = Cast<UStructProperty>(upropPtr))
+        {
+            if (!propPtr->Key().IsValid())
+            {
+                return false;
+            }
+            step.StepType = PathStep::StructField;
+            step.Property = structPropPtr->Struct->FindPropertyByName(FName(UTF8_TO_TCHAR(propPtr->Key()->c_str())));
+            if (step.Property == nullptr)
+            {
+                return false;
+            }
+            step.Offset = step.Property->GetOffset_ForInternal();
+            upropPtr = step.Property;
+        }
+        else if (UArrayProperty* arrayPropPtr = Cast<UArrayProperty>(upropPtr))
+        {
+            step.StepType = PathStep::ArrayElement;
+            step.Property = arrayPropPtr;
+            upropPtr = arrayPropPtr->Inner;
+        }
+        else if (UMapProperty* mapPropPtr = Cast<UMapProperty>(upropPtr))
+        {
+            // Because maps are serialized as lists of key values, we expect one more property that chooses the key
+            // or value
+            if (i + 1 >= path.Num())
+            {
+                return false;
+            }
+            i++;
+            step.Property = mapPropPtr;
+            if (path[i]->Index() == 0)
+            {
+                step.StepType = PathStep::MapKey;
+                upropPtr = mapPropPtr->KeyProp;
+            }
+            else if (path[i]->Index() == 1)
+            {
+                step.StepType = PathStep::MapValue;
+                upropPtr = mapPropPtr->ValueProp;
+            }
+            else
+            {
+                return false;
+            }
+        }
+        else if (USetProperty* setPropPtr = Cast<USetProperty>(upropPtr))
+        {
+            step.StepType = PathStep::SetElement;
+            step.Property = setPropPtr;
+            upropPtr = setPropPtr->ElementProp;
+        }
+        else
+        {
+            // We were expecting the UProperty to be one of the above container types but it was not.
+            return false;
+        }
+        accessor.Steps.Add(step);
+    }
+    return upropPtr != nullptr;
+}
+
+void sfPropertySchema::Invalidate()
+{
+    if (m_schemas.Num() > 0)
+    {
+        m_schemas.Empty();
+        m_stats.Invalidations++;
+    }
+}
+
+void sfPropertySchema::LogStats()
+{
+    int total = m_stats.Hits + m_stats.Misses;
+    float hitRate = total > 0 ? (float)m_stats.Hits / total : 0.0f;
+    KS::Log::Info("Property schemas: " + std::to_string(m_schemas.Num()) + " cached, " +
+        std::to_string(m_stats.Hits) + " hits, " + std::to_string(m_stats.Misses) + " misses (" +
+        std::to_string(hitRate * 100.0f) + "% hit rate), " + std::to_string(m_stats.Invalidations) +
+        " invalidations, " + std::to_string(m_stats.BuildTime * 1000.0) + " ms building.", LOG_CHANNEL);
+    int pathTotal = m_stats.PathHits + m_stats.PathMisses;
+    float pathHitRate = pathTotal > 0 ? (float)m_stats.PathHits / pathTotal : 0.0f;
+    KS::Log::Info("Property path accessors: " + std::to_string(m_stats.PathHits) + " hits, " +
+        std::to_string(m_stats.PathMisses) + " misses (" + std::to_string(pathHitRate * 100.0f) + "% hit rate).",
+        LOG_CHANNEL);
+}
+
+#undef LOG_CHANNEL
@@ -0,0 +1,214 @@
+#pragma once
+
+#include <CoreMinimal.h>
+#include <HAL/IConsoleManager.h>
+#include <sfName.h>
+#include <string>
+#include <unordered_map>
+
+#include "sfPropertyUtil.h"
+
+using namespace KS::SceneFusion2;
+
+/**
+ * Session-scoped cache of the syncable properties of each class, so syncing an object's properties does not iterate
+ * and filter every property of its class with reflection. A class's schema holds the properties that are editable on
+ * instances and have a type handler, with their offsets, type handlers and interned names. It also holds accessors
+ * compiled from the property paths of changes applied to objects of the class, so finding the UProperty for a change
+ * does not look up properties by name at each level of the path. Schemas are discarded when a blueprint is compiled,
+ * when objects are replaced by reinstancing or hot reload, and when packages are reloaded. Setting property values
+ * can load assets, which can fire those events, so schemas and accessors are returned as shared pointers that keep
+ * them alive while they are used.
+ */
+class sfPropertySchema
+{
+public:
+    /**
+     * A syncable property of a class.
+     */
+    struct Field
+    {
+    public:
+        UProperty* Property;
+        sfName Name;
+        // Offset of the value from the start of the object
+        int32 Offset;
+        const sfPropertyUtil::TypeHandler* HandlerPtr;
+
+        /**
+         * Gets the value of this property on an object.
+         *
+         * @param   UObject* uobjPtr
+         * @return  sfProperty::SPtr
+         */
+        sfProperty::SPtr GetValue(UObject* uobjPtr) const;
+
+        /**
+         * Sets the value of this property on an object.
+         *
+         * @param   UObject* uobjPtr
+         * @param   sfProperty::SPtr propPtr to get the value from.
+         */
+        void SetValue(UObject* uobjPtr, sfProperty::SPtr propPtr) const;
+    };
+
+    /**
+     * A step in a path accessor. Field steps offset the data pointer to a field of an object or struct. Element steps
+     * get an element of a container, using the index of the path's property at that step.
+     */
+    struct PathStep
+    {
+    public:
+        enum Type
+        {
+            StructField,
+            ArrayElement,
+            MapKey,
+            MapValue,
+            SetElement
+        };
+
+        Type StepType;
+        // The field for field steps, or the container for element steps
+        UProperty* Property;
+        // Offset of the field from the start of the object or struct. Only used by field steps.
+        int32 Offset;
+    };
+
+    /**
+     * The shape of a property path, with one token per property. Dictionary fields are the address of their interned
+     * key name, and list elements are 0, except the index choosing a map key or value, which is the index plus one.
+     * Names are never allocated at addresses that small, so tokens of different kinds don't collide.
+     */
+    typedef TArray<uint64, TInlineAllocator<8>> PathShape;
+
+    /**
+     * Steps for getting the UProperty and data for a property path on an object. Map steps use two properties from
+     * the path: the element, and the index of its key or value. Other steps use one property.
+     */
+    struct PathAccessor
+    {
+    public:
+        // False if the path does not match the class's properties
+        bool IsValid;
+        TArray<PathStep> Steps;
+        // Shape of the path the accessor was compiled for, to tell paths whose shapes have the same hash apart
+        PathShape Shape;
+    };
+
+    /**
+     * A property and its ancestors below the root dictionary, from the top down.
+     */
+    typedef TArray<sfProperty::SPtr, TInlineAllocator<8>> PropertyPath;
+
+    /**
+     * The syncable properties of a class.
+     */
+    struct Schema
+    {
+    public:
+        TWeakObjectPtr<UClass> Class;
+        // Class default object that values are compared against
+        UObject* DefaultsPtr;
+        TArray<Field> Fields;
+        // Compiled accessors keyed by the hash of their path's shape. Array, map and set element indices are not part
+        // of the shape.
+        std::unordered_map<uint64, TSharedPtr<PathAccessor>> Paths;
+    };
+
+    /**
+     * Registers invalidation event handlers and the stats console command. Call after the editor is created.
+     */
+    static void Initialize();
+
+    /**
+     * Unregisters event handlers and console commands and clears the cache.
+     */
+    static void CleanUp();
+
+    /**
+     * Gets the schema for a class, building it if it is not cached.
+     *
+     * @param   UClass* classPtr
+     * @return  TSharedPtr<const Schema>
+     */
+    static TSharedPtr<const Schema> Get(UClass* classPtr);
+
+    /**
+     * Gets the accessor for a property path on a class, compiling it if it is not cached.
+     *
+     * @param   UClass* classPtr
+     * @param   const PropertyPath& path
+     * @return  TSharedPtr<const PathAccessor>
+     */
+    static TSharedPtr<const PathAccessor> GetPathAccessor(UClass* classPtr, const PropertyPath& path);
+
+private:
+    /**
+     * Cache hit and miss counts, and the time spent building schemas.
+     */
+    struct Stats
+    {
+    public:
+        int Hits = 0;
+        int Misses = 0;
+        int Invalidations = 0;
+        double BuildTime = 0.0;
+        int PathHits = 0;
+        int PathMisses = 0;
+    };
+
+    static TMap<const UClass*, TSharedPtr<Schema>> m_schemas;
+    static Stats m_stats;
+    static IConsoleCommand* m_statsCommandPtr;
+    static FDelegateHandle m_onBlueprintCompiledHandle;
+    static FDelegateHandle m_onObjectsReplacedHandle;
+    static FDelegateHandle m_onPackageReloadedHandle;
+
+    /**
+     * Gets the schema for a class, building it if it is not cached.
+     *
+     * @param   UClass* classPtr
+     * @return  TSharedPtr<Schema>
+     */
+    static TSharedPtr<Schema> Find(UClass* classPtr);
+
+    /**
+     * Builds the schema for a class.
+     *
+     * @param   UClass* classPtr
+     * @param   Schema& schema to add fields to.
+     */
+    static void Build(UClass* classPtr, Schema& schema);
+
+    /**
+     * Gets the shape of a property path and its hash, which is the cache key for the path. Indices of container
+     * elements are left out so one accessor is used for every element, but the index choosing a map key or value is
+     * kept.
+     *
+     * @param   const PropertyPath& path
+     * @param   PathShape& shape - set to the path's shape.
+     * @return  uint64 hash of the shape.
+     */
+    static uint64 GetPathShape(const PropertyPath& path, PathShape& shape);
+
+    /**
+     * Compiles the accessor for a property path on a class.
+     *
+     * @param   UClass* classPtr
+     * @param   const PropertyPath& path
+     * @param   PathAccessor& accessor to add steps to.
+     * @return  bool false if the path does not match the class's properties.
+     */
+    static bool Compile(UClass* classPtr, const PropertyPath& path, PathAccessor& accessor);
+
+    /**
+     * Removes all cached schemas without resetting the stats.
+     */
+    static void Invalidate();
+
+    /**
+     * Logs hit and miss counts and build times.
+     */
+    static void LogStats();
+};
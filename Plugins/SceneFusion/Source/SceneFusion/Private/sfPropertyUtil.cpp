@@ -1,9 +1,12 @@
 #include "sfPropertyUtil.h"
 #include "SceneFusion.h"
+#include "sfAssetCache.h"
+#include "sfPropertySchema.h"
 
 #include <Runtime/CoreUObject/Public/UObject/UnrealType.h>
 #include <Runtime/CoreUObject/Public/UObject/EnumProperty.h>
 #include <Runtime/CoreUObject/Public/UObject/TextProperty.h>
+#include <Algo/Reverse.h>
 
 #define LOG_CHANNEL "sfPropertyUtil"
 
@@ -17,115 +20,96 @@ sfUPropertyInstance sfPropertyUtil::FindUProperty(UObject* uobjPtr, sfProperty::
     {
         return sfUPropertyInstance();
     }
-    // Push property and its ancestors into a stack, so we can then iterate them from the top down
-    // We don't need to push the root dictionary into the stack
-    std::stack<sfProperty::SPtr> stack;
+    // Collect the property and its ancestors so we can iterate them from the top down. We don't need the root
+    // dictionary.
+    sfPropertySchema::PropertyPath path;
     while (propPtr->GetDepth() > 0)
     {
-        stack.push(propPtr);
+        path.Add(propPtr);
         propPtr = propPtr->GetParentProperty();
     }
+    Algo::Reverse(path);
+    TSharedPtr<const sfPropertySchema::PathAccessor> accessorPtr =
+        sfPropertySchema::GetPathAccessor(uobjPtr->GetClass(), path);
+    if (!accessorPtr->IsValid)
+    {
+        return sfUPropertyInstance();
+    }
     UProperty* upropPtr = nullptr;
-    void* ptr = nullptr;// pointer to UProperty instance data
+    void* ptr = uobjPtr;// pointer to UProperty instance data
     TSharedPtr<FScriptMapHelper> mapPtr = nullptr;
     TSharedPtr<FScriptSetHelper> setPtr = nullptr;
-    // Traverse properties from the top down, finding the UProperty at each level until we reach the one we want or
-    // don't find what we expect.
-    while (stack.size() > 0)
+    // Follow the accessor's steps, using the indices from the path to get container elements. Abort if an element
+    // we are looking for does not exist.
+    int level = 0;
+    for (const sfPropertySchema::PathStep& step : accessorPtr->Steps)
     {
-        propPtr = stack.top();
-        stack.pop();
-        if (upropPtr == nullptr)
+        switch (step.StepType)
         {
-            // Get the first property from the object
-            upropPtr = uobjPtr->GetClass()->FindPropertyByName(FName(UTF8_TO_TCHAR(propPtr->Key()->c_str())));
-            if (upropPtr == nullptr)
+            case sfPropertySchema::PathStep::StructField:
             {
-                return sfUPropertyInstance();
+                upropPtr = step.Property;
+                ptr = (uint8*)ptr + step.Offset;
+                break;
+            }
+            case sfPropertySchema::PathStep::ArrayElement:
+            {
+                if (!GetArrayElement(path[level]->Index(), (UArrayProperty*)step.Property, upropPtr, ptr))
+                {
+                    return sfUPropertyInstance();
+                }
+                break;
+            }
+            case sfPropertySchema::PathStep::MapKey:
+            case sfPropertySchema::PathStep::MapValue:
+            {
+                if (!GetMapElement(path[level]->Index(), step.StepType == sfPropertySchema::PathStep::MapKey,
+                    (UMapProperty*)step.Property, upropPtr, ptr, mapPtr))
+                {
+                    return sfUPropertyInstance();
+                }
+                // Map steps also use the property that chooses the key or value
+                level++;
+                break;
+            }
+            case sfPropertySchema::PathStep::SetElement:
+            {
+                if (!GetSetElement(path[level]->Index(), (USetProperty*)step.Property, upropPtr, ptr, setPtr))
+                {
+                    return sfUPropertyInstance();
+                }
+                break;
             }
-            ptr = upropPtr->ContainerPtrToValuePtr<void>(uobjPtr);
-            continue;
-        }
-        if (!GetStructField(propPtr->Key(), upropPtr, ptr) &&
-            !GetArrayElement(propPtr->Index(), upropPtr, ptr) &&
-            !GetMapElement(propPtr->Index(), upropPtr, ptr, mapPtr, stack) &&
-            !GetSetElement(propPtr->Index(), upropPtr, ptr, setPtr))
-        {
-            // We were expecting the UProperty to be one of the above container types but it was not. Abort.
-            return sfUPropertyInstance();
-        }
-        if (upropPtr == nullptr)
-        {
-            // We did not find the field or element we were looking for. Abort.
-            return sfUPropertyInstance();
         }
+        level++;
     }
     return sfUPropertyInstance(upropPtr, ptr, mapPtr, setPtr);
 }
 
-bool sfPropertyUtil::GetStructField(const sfName& name, UProperty*& upropPtr, void*& ptr)
-{
-    UStructProperty* structPropPtr = Cast<UStructProperty>(upropPtr);
-    if (structPropPtr == nullptr)
-    {
-        return false;
-    }
-    if (!name.IsValid())
-    {
-        upropPtr = nullptr;
-        return true;
-    }
-    upropPtr = structPropPtr->Struct->FindPropertyByName(FName(UTF8_TO_TCHAR(name->c_str())));
-    if (upropPtr != nullptr)
-    {
-        ptr = upropPtr->ContainerPtrToValuePtr<void>(ptr);
-    }
-    return true;
-}
-
-bool sfPropertyUtil::GetArrayElement(int index, UProperty*& upropPtr, void*& ptr)
+bool sfPropertyUtil::GetArrayElement(int index, UArrayProperty* arrayPropPtr, UProperty*& upropPtr, void*& ptr)
 {
-    UArrayProperty* arrayPropPtr = Cast<UArrayProperty>(upropPtr);
-    if (arrayPropPtr == nullptr)
-    {
-        return false;
-    }
     FScriptArrayHelper array(arrayPropPtr, ptr);
     if (index < 0 || index >= array.Num())
     {
-        upropPtr = nullptr;
-    }
-    else
-    {
-        upropPtr = arrayPropPtr->Inner;
-        ptr = array.GetRawPtr(index);
+        return false;
     }
+    upropPtr = arrayPropPtr->Inner;
+    ptr = array.GetRawPtr(index);
     return true;
 }
 
 bool sfPropertyUtil::GetMapElement(
     int index,
+    bool getKey,
+    UMapProperty* mapPropPtr,
     UProperty*& upropPtr,
     void*& ptr,
-    TSharedPtr<FScriptMapHelper>& outMapPtr,
-    std::stack<sfProperty::SPtr>& propertyStack)
+    TSharedPtr<FScriptMapHelper>& outMapPtr)
 {
-    UMapProperty* mapPropPtr = Cast<UMapProperty>(upropPtr);
-    if (mapPropPtr == nullptr)
-    {
-        return false;
-    }
-    // Because maps are serialized as lists of key values, we expect at least one more property in the stack
-    if (propertyStack.size() <= 0)
-    {
-        upropPtr = nullptr;
-        return true;
-    }
     outMapPtr = MakeShareable(new FScriptMapHelper(mapPropPtr, ptr));
     if (index < 0 || index >= outMapPtr->Num())
     {
-        upropPtr = nullptr;
-        return true;
+        return false;
     }
     int sparseIndex = -1;
     while (index >= 0)
@@ -133,51 +117,38 @@ bool sfPropertyUtil::GetMapElement(
         sparseIndex++;
         if (sparseIndex >= outMapPtr->GetMaxIndex())
         {
-            upropPtr = nullptr;
-            return true;
+            return false;
         }
         if (outMapPtr->IsValidIndex(sparseIndex))
         {
             index--;
         }
     }
-    // Get the next property in the stack, and check its index to determine if we want the map key or value.
-    sfProperty::SPtr propPtr = propertyStack.top();
-    propertyStack.pop();
-    if (propPtr->Index() == 0)
+    if (getKey)
     {
         upropPtr = mapPropPtr->KeyProp;
         ptr = outMapPtr->GetKeyPtr(sparseIndex);
     }
-    else if (propPtr->Index() == 1)
+    else
     {
         upropPtr = mapPropPtr->ValueProp;
         ptr = outMapPtr->GetValuePtr(sparseIndex);
         outMapPtr = nullptr;
     }
-    else
-    {
-        upropPtr = nullptr;
-    }
     return true;
 }
 
 bool sfPropertyUtil::GetSetElement(
     int index,
+    USetProperty* setPropPtr,
     UProperty*& upropPtr,
     void*& ptr,
     TSharedPtr<FScriptSetHelper>& outSetPtr)
 {
-    USetProperty* setPropPtr = Cast<USetProperty>(upropPtr);
-    if (setPropPtr == nullptr)
-    {
-        return false;
-    }
     outSetPtr = MakeShareable(new FScriptSetHelper(setPropPtr, ptr));
     if (index < 0 || index >= outSetPtr->Num())
     {
-        upropPtr = nullptr;
-        return true;
+        return false;
     }
     int sparseIndex = -1;
     while (index >= 0)
@@ -185,8 +156,7 @@ bool sfPropertyUtil::GetSetElement(
         sparseIndex++;
         if (sparseIndex >= outSetPtr->GetMaxIndex())
         {
-            upropPtr = nullptr;
-            return true;
+            return false;
         }
         if (outSetPtr->IsValidIndex(sparseIndex))
         {
@@ -269,16 +239,17 @@ void sfPropertyUtil::CreateProperties(UObject* uobjPtr, sfDictionaryProperty::SP
     {
         return;
     }
-    for (TFieldIterator<UProperty> iter(uobjPtr->GetClass()); iter; ++iter)
+    // Getting or setting values can load assets, which can invalidate schemas, so we keep the schema alive while we
+    // iterate its fields.
+    TSharedPtr<const sfPropertySchema::Schema> schemaPtr = sfPropertySchema::Get(uobjPtr->GetClass());
+    for (const sfPropertySchema::Field& field : schemaPtr->Fields)
     {
-        if (iter->PropertyFlags & CPF_Edit && !(iter->PropertyFlags & CPF_DisableEditOnInstance) &&
-            !IsDefaultValue(uobjPtr, *iter))
+        if (!field.Property->Identical_InContainer(uobjPtr, schemaPtr->DefaultsPtr))
         {
-            sfProperty::SPtr propPtr = GetValue(uobjPtr, *iter);
+            sfProperty::SPtr propPtr = field.GetValue(uobjPtr);
             if (propPtr != nullptr)
             {
-                std::string name = std::string(TCHAR_TO_UTF8(*iter->GetName()));
-                dictPtr->Set(name, propPtr);
+                dictPtr->Set(field.Name, propPtr);
             }
         }
     }
@@ -290,20 +261,17 @@ void sfPropertyUtil::ApplyProperties(UObject* uobjPtr, sfDictionaryProperty::SPt
     {
         return;
     }
-    for (TFieldIterator<UProperty> iter(uobjPtr->GetClass()); iter; ++iter)
+    TSharedPtr<const sfPropertySchema::Schema> schemaPtr = sfPropertySchema::Get(uobjPtr->GetClass());
+    for (const sfPropertySchema::Field& field : schemaPtr->Fields)
     {
-        if (iter->PropertyFlags & CPF_Edit && !(iter->PropertyFlags & CPF_DisableEditOnInstance))
+        sfProperty::SPtr propPtr;
+        if (!dictPtr->TryGet(field.Name, propPtr))
         {
-            std::string name = std::string(TCHAR_TO_UTF8(*iter->GetName()));
-            sfProperty::SPtr propPtr;
-            if (!dictPtr->TryGet(name, propPtr))
-            {
-                SetToDefaultValue(uobjPtr, *iter);
-            }
-            else
-            {
-                SetValue(sfUPropertyInstance(*iter, iter->ContainerPtrToValuePtr<void>(uobjPtr)), propPtr);
-            }
+            field.Property->CopyCompleteValue_InContainer(uobjPtr, schemaPtr->DefaultsPtr);
+        }
+        else
+        {
+            field.SetValue(uobjPtr, propPtr);
         }
     }
 }
@@ -314,30 +282,23 @@ void sfPropertyUtil::SendPropertyChanges(UObject* uobjPtr, sfDictionaryProperty:
     {
         return;
     }
-    for (TFieldIterator<UProperty> iter(uobjPtr->GetClass()); iter; ++iter)
+    TSharedPtr<const sfPropertySchema::Schema> schemaPtr = sfPropertySchema::Get(uobjPtr->GetClass());
+    for (const sfPropertySchema::Field& field : schemaPtr->Fields)
     {
-        if (iter->PropertyFlags & CPF_Edit && !(iter->PropertyFlags & CPF_DisableEditOnInstance))
+        if (field.Property->Identical_InContainer(uobjPtr, schemaPtr->DefaultsPtr))
         {
-            if (IsDefaultValue(uobjPtr, *iter))
-            {
-                std::string name = std::string(TCHAR_TO_UTF8(*iter->GetName()));
-                dictPtr->Remove(name);
-            }
-            else
-            {
-                sfProperty::SPtr propPtr = GetValue(uobjPtr, *iter);
-                if (propPtr == nullptr)
-                {
-                    continue;
-                }
-
-                std::string name = std::string(TCHAR_TO_UTF8(*iter->GetName()));
-                sfProperty::SPtr oldPropPtr = nullptr;
-                if (!dictPtr->TryGet(name, oldPropPtr) || !Copy(oldPropPtr, propPtr))
-                {
-                    dictPtr->Set(name, propPtr);
-                }
-            }
+            dictPtr->Remove(field.Name);
+            continue;
+        }
+        sfProperty::SPtr propPtr = field.GetValue(uobjPtr);
+        if (propPtr == nullptr)
+        {
+            continue;
+        }
+        sfProperty::SPtr oldPropPtr = nullptr;
+        if (!dictPtr->TryGet(field.Name, oldPropPtr) || !Copy(oldPropPtr, propPtr))
+        {
+            dictPtr->Set(field.Name, propPtr);
         }
     }
 }
@@ -372,6 +333,42 @@ bool sfPropertyUtil::Copy(sfProperty::SPtr destPtr, sfProperty::SPtr srcPtr)
     return true;
 }
 
+int sfPropertyUtil::EstimateSize(sfProperty::SPtr propPtr)
+{
+    if (propPtr == nullptr)
+    {
+        return 0;
+    }
+    // One byte for the property type
+    int size = 1;
+    switch (propPtr->Type())
+    {
+        case sfProperty::VALUE:
+        {
+            size += (int)propPtr->AsValue()->GetValue().GetData().size();
+            break;
+        }
+        case sfProperty::LIST:
+        {
+            for (sfProperty::SPtr elementPtr : *propPtr->AsList())
+            {
+                size += EstimateSize(elementPtr);
+            }
+            break;
+        }
+        case sfProperty::DICTIONARY:
+        {
+            for (auto iter : *propPtr->AsDict())
+            {
+                // Keys are sent as string table ids
+                size += sizeof(uint32_t) + EstimateSize(iter.second);
+            }
+            break;
+        }
+    }
+    return size;
+}
+
 // private functions
 
 void sfPropertyUtil::Initialize()
@@ -712,14 +709,11 @@ void sfPropertyUtil::SetObject(const sfUPropertyInstance& uprop, sfProperty::SPt
         // If path is empty we keep our current value
         if (!path.IsEmpty())
         {
-            // Disable loading dialog that causes a crash if we are dragging objects
-            GIsSlowTask = true;
-            UObject* uobjPtr = LoadObject<UObject>(nullptr, *path);
+            UObject* uobjPtr = sfAssetCache::Load(path);
             if (uobjPtr != nullptr)
             {
                 tPtr->SetObjectPropertyValue(uprop.Data(), uobjPtr);
             }
-            GIsSlowTask = false;
         }
         return;
     }
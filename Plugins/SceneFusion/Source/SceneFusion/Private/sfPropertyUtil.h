@@ -15,6 +15,8 @@ using namespace KS::SceneFusion2;
 class sfPropertyUtil
 {
 public:
+    friend class sfPropertySchema;
+
     /**
      * Constructs a property from a vector.
      *
@@ -113,7 +115,8 @@ public:
     }
 
     /**
-     * Finds a uproperty of a uobject corresponding to an sfproperty.
+     * Finds a uproperty of a uobject corresponding to an sfproperty. Uses the accessor compiled for the sfproperty's
+     * path in the cached property schema for the object's class.
      *
      * @param   UObject* uobjPtr to find property on.
      * @param   sfProperty::SPtr propPtr to find corresponding uproperty for.
@@ -159,8 +162,8 @@ public:
     static void SetToDefaultValue(UObject* uobjPtr, UProperty* upropPtr);
 
     /**
-     * Iterates all properties of an object using reflection and creates sfProperties for properties with non-default
-     * values as fields in an sfDictionaryProperty.
+     * Creates sfProperties for the syncable properties of an object that have non-default values as fields in an
+     * sfDictionaryProperty. Uses the cached property schema for the object's class.
      *
      * @param   UObject* uobjPtr to create properties for.
      * @param   sfDictionaryProperty::SPtr dictPtr to add properties to.
@@ -168,7 +171,8 @@ public:
     static void CreateProperties(UObject* uobjPtr, sfDictionaryProperty::SPtr dictPtr);
 
     /**
-     * Applies property values from an sfDictionaryProperty to an object using reflection.
+     * Applies property values from an sfDictionaryProperty to an object using reflection. Uses the cached property
+     * schema for the object's class.
      *
      * @param   UObject* uobjPtr to apply property values to.
      * @param   sfDictionaryProperty::SPtr dictPtr to get property values from. If a value for a property is not in the
@@ -177,9 +181,9 @@ public:
     static void ApplyProperties(UObject* uobjPtr, sfDictionaryProperty::SPtr dictPtr);
 
     /**
-     * Iterates all properties of an object using reflection and updates an sfDictionaryProperty when its values are
-     * different from those on the object. Removes fields from the dictionary for properties that have their default
-     * value.
+     * Updates an sfDictionaryProperty when its values are different from the syncable properties of an object.
+     * Removes fields from the dictionary for properties that have their default value. Uses the cached property
+     * schema for the object's class.
      *
      * @param   UObject* uobjPtr to iterate properties on.
      * @param   sfDictionaryProperty::SPtr dictPtr to update.
@@ -195,6 +199,16 @@ public:
      */
     static bool Copy(sfProperty::SPtr destPtr, sfProperty::SPtr srcPtr);
 
+    /**
+     * Estimates the number of bytes needed to send a property and its sub properties. Dictionary keys and string
+     * values are counted as string table ids so this will be lower than the actual size the first time a string is
+     * sent.
+     *
+     * @param   sfProperty::SPtr propPtr to estimate size for.
+     * @return  int estimated size in bytes.
+     */
+    static int EstimateSize(sfProperty::SPtr propPtr);
+
 private:
     /**
      * Holds getter and setter delegates for converting between a UProperty type and sfValueProperty.
@@ -422,63 +436,48 @@ private:
     static void SetObject(const sfUPropertyInstance& uprop, sfProperty::SPtr propPtr);
 
     /**
-     * Takes a pointer to a struct and sets it to point at a field of the struct using reflection. Returns false if the
-     * uproperty is not a struct property.
-     *
-     * @param   const sfName& name of field to get.
-     * @param   UProperty*& upropPtr - if not a struct property, returns false. Otherwise this is updated to point to
-     *          the field property. If the field is not found, this is set to nullptr.
-     * @param   void*& ptr to the struct data. Will be updated to point to the field data, if found.
-     * @return  bool true if upropPtr is a struct property.
-     */
-    static bool GetStructField(const sfName& name, UProperty*& upropPtr, void*& ptr);
-
-    /**
-     * Takes a pointer to an array and sets it to point at an element of the array using reflection. Returns false if
-     * the uproperty is not an array property.
+     * Takes a pointer to an array and sets it to point at an element of the array using reflection.
      *
-     * @param   index of element to get.
-     * @param   UProperty*& upropPtr - if not an array property, returns false. Otherwise this is updated to point to
-     *          the element property. If the element is not found, this is set to nullptr.
+     * @param   int index of element to get.
+     * @param   UArrayProperty* arrayPropPtr
+     * @param   UProperty*& upropPtr - updated to point to the element property if the element is found.
      * @param   void*& ptr to the array data. Will be updated to point to the element data, if found.
-     * @return  bool true if upropPtr is an array property.
+     * @return  bool false if the element was not found.
      */
-    static bool GetArrayElement(int index, UProperty*& upropPtr, void*& ptr);
+    static bool GetArrayElement(int index, UArrayProperty* arrayPropPtr, UProperty*& upropPtr, void*& ptr);
 
     /**
-     * Takes a pointer to a map and sets it to point at a key or value of the map using reflection. Returns false if
-     * the uproperty is not a map property.
+     * Takes a pointer to a map and sets it to point at a key or value of the map using reflection.
      *
-     * @param   index of element to get.
-     * @param   UProperty*& upropPtr - if not a map property, returns false. Otherwise this is updated to point to the
-     *          element property. If the element is not found, this is set to nullptr.
-     * @param   void*& ptr to the map data. Will be updated to point to the element data, if found.
+     * @param   int index of element to get.
+     * @param   bool getKey - if true, gets the element's key. Otherwise gets its value.
+     * @param   UMapProperty* mapPropPtr
+     * @param   UProperty*& upropPtr - updated to point to the key or value property if the element is found.
+     * @param   void*& ptr to the map data. Will be updated to point to the key or value data, if found.
      * @param   TSharedPtr<FScriptMapHelper> outMapPtr - will point to the map if the element we are getting is a key.
-     * @param   std::stack<sfProperty::SPtr>& propertyStack containing the sub properties to look for next. If the
-     *          uproperty is a map and the index is within its bounds, the top property will be popped off the stack.
-     *          If it's index is 0, we'll get the key, If 1, we'll get the value.
-     * @return  bool true if upropPtr is a map property.
+     * @return  bool false if the element was not found.
      */
     static bool GetMapElement(
         int index,
+        bool getKey,
+        UMapProperty* mapPropPtr,
         UProperty*& upropPtr,
         void*& ptr,
-        TSharedPtr<FScriptMapHelper>& outMapPtr,
-        std::stack<sfProperty::SPtr>& propertyStack);
+        TSharedPtr<FScriptMapHelper>& outMapPtr);
 
     /**
-     * Takes a pointer to a set and sets it to point at an element of the set using reflection. Returns false if the
-     * uproperty is not a set property.
+     * Takes a pointer to a set and sets it to point at an element of the set using reflection.
      *
-     * @param   index of element to get.
-     * @param   UProperty*& upropPtr - if not a set property, returns false. Otherwise this is updated to point to the
-     *          element property. If the element is not found, this is set to nullptr.
+     * @param   int index of element to get.
+     * @param   USetProperty* setPropPtr
+     * @param   UProperty*& upropPtr - updated to point to the element property if the element is found.
      * @param   void*& ptr to the set data. Will be updated to point to the element data, if found.
-     * @param   TSharedPtr<FScriptMapHelper> outSetPtr - will point to the set.
-     * @return  bool true if upropPtr is a map property.
+     * @param   TSharedPtr<FScriptSetHelper> outSetPtr - will point to the set.
+     * @return  bool false if the element was not found.
      */
     static bool GetSetElement(
         int index,
+        USetProperty* setPropPtr,
         UProperty*& upropPtr,
         void*& ptr,
         TSharedPtr<FScriptSetHelper>& outSetPtr);
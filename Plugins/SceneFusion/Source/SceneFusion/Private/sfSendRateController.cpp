@@ -0,0 +1,78 @@
+#include "sfSendRateController.h"
+#include "sfConfig.h"
+
+// Weight of a new round-trip time sample in the smoothed round-trip time
+#define RTT_SMOOTHING 0.125f
+// Lock requests that take longer than this are not used as round-trip time samples
+#define MAX_RTT_SAMPLE 5.0
+
+sfSendRateController::sfSendRateController() :
+    m_rttStartTime{ 0.0 },
+    m_roundTripTime{ 0.0f },
+    m_lastSendTime{ 0.0 }
+{
+
+}
+
+void sfSendRateController::Reset()
+{
+    m_rttObjPtr = nullptr;
+    m_roundTripTime = 0.0f;
+    m_lastSendTime = 0.0;
+}
+
+void sfSendRateController::OnLockRequested(sfObject::SPtr objPtr)
+{
+    // Requests for objects locked by another user wait for the lock to be released, so they aren't used as samples
+    if (m_rttObjPtr == nullptr && objPtr->IsLockPending() && !objPtr->IsLocked())
+    {
+        m_rttObjPtr = objPtr;
+        m_rttStartTime = FPlatformTime::Seconds();
+    }
+}
+
+void sfSendRateController::Tick()
+{
+    if (m_rttObjPtr == nullptr || m_rttObjPtr->IsLockPending())
+    {
+        if (m_rttObjPtr != nullptr && FPlatformTime::Seconds() - m_rttStartTime > MAX_RTT_SAMPLE)
+        {
+            m_rttObjPtr = nullptr;
+        }
+        return;
+    }
+    // If the lock was released or taken by another user before it was acknowledged, the sample is discarded.
+    if (m_rttObjPtr->IsSyncing() && m_rttObjPtr->LockOwner() != nullptr && !m_rttObjPtr->IsLocked())
+    {
+        float sample = (float)(FPlatformTime::Seconds() - m_rttStartTime);
+        m_roundTripTime = m_roundTripTime == 0.0f ?
+            sample : m_roundTripTime + (sample - m_roundTripTime) * RTT_SMOOTHING;
+    }
+    m_rttObjPtr = nullptr;
+}
+
+bool sfSendRateController::ShouldSend(int numObjects)
+{
+    sfConfig& config = sfConfig::Get();
+    float rate = config.DragSendRate;
+    if (numObjects > 0 && config.DragUpdateBudget > 0)
+    {
+        rate = FMath::Min(rate, (float)config.DragUpdateBudget / numObjects);
+    }
+    float interval = rate > 0.0f ? 1.0f / rate : 0.0f;
+    // Don't send faster than half the round-trip time so updates don't pile up on the server
+    interval = FMath::Max(interval, m_roundTripTime * 0.5f);
+
+    double time = FPlatformTime::Seconds();
+    if (time - m_lastSendTime < interval)
+    {
+        return false;
+    }
+    m_lastSendTime = time;
+    return true;
+}
+
+float sfSendRateController::RoundTripTime()
+{
+    return m_roundTripTime;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <CoreMinimal.h>
+#include <sfObject.h>
+
+using namespace KS::SceneFusion2;
+
+/**
+ * Limits how often transform updates for in-progress drags are sent. The send rate comes from the config and is
+ * reduced for large selections so the number of actor updates per second stays within budget, and for high round-trip
+ * times so updates don't queue up faster than the server can acknowledge them. Round-trip time is measured from lock
+ * requests to lock acknowledgements.
+ */
+class sfSendRateController
+{
+public:
+    /**
+     * Constructor
+     */
+    sfSendRateController();
+
+    /**
+     * Resets the round-trip time measurement and send timer.
+     */
+    void Reset();
+
+    /**
+     * Starts measuring round-trip time for a lock request if no measurement is in progress.
+     *
+     * @param   sfObject::SPtr objPtr the lock was requested for.
+     */
+    void OnLockRequested(sfObject::SPtr objPtr);
+
+    /**
+     * Completes the round-trip time measurement if the lock request was acknowledged. Call once per tick.
+     */
+    void Tick();
+
+    /**
+     * Checks if enough time has passed since the last send to send updates for the given number of objects. Resets
+     * the send timer if it returns true.
+     *
+     * @param   int numObjects - number of objects that will be updated.
+     * @return  bool
+     */
+    bool ShouldSend(int numObjects);
+
+    /**
+     * @return  float - smoothed round-trip time in seconds, or 0 if it has not been measured.
+     */
+    float RoundTripTime();
+
+private:
+    sfObject::SPtr m_rttObjPtr;
+    double m_rttStartTime;
+    float m_roundTripTime;
+    double m_lastSendTime;
+};
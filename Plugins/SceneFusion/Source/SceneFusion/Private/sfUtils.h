@@ -50,4 +50,35 @@ public:
     {
         return std::string(TCHAR_TO_UTF8(*inString));
     }
+
+    /**
+     * Parses an unsigned 32-bit id from a string of decimal digits. Unlike std::stoul, this does not throw on invalid
+     * strings, since exceptions are disabled in engine builds.
+     *
+     * @param   const std::string& str to parse.
+     * @param   uint32_t& id set to the parsed id.
+     * @return  bool false if the string is not a valid id.
+     */
+    static bool TryParseId(const std::string& str, uint32_t& id)
+    {
+        if (str.empty() || str.size() > 10)
+        {
+            return false;
+        }
+        uint64 value = 0;
+        for (char c : str)
+        {
+            if (c < '0' || c > '9')
+            {
+                return false;
+            }
+            value = value * 10 + (c - '0');
+        }
+        if (value > MAX_uint32)
+        {
+            return false;
+        }
+        id = (uint32_t)value;
+        return true;
+    }
 };
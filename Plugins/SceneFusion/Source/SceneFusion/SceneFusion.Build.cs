@@ -24,7 +24,7 @@ public class SceneFusion : ModuleRules
         PrivateDependencyModuleNames.AddRange(new string[]
         {
             "Slate", "SlateCore", "EditorStyle", "LevelEditor", "Projects",
-            "Http", "Json", "JsonUtilities", "AppFramework", "VREditor", "UnrealEd"
+            "Http", "Json", "JsonUtilities", "AppFramework", "VREditor", "UnrealEd", "RHI", "RenderCore"
         });
 
         // Include SceneFusionAPI files